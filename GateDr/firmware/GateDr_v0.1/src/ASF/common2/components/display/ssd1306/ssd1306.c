@@ -74,6 +74,46 @@ static void ssd1306_interface_init(void)
 	port_pin_set_config(SSD1306_RES_PIN, &pin);
 }
 
+/**
+ * \internal
+ * \brief Controller setup commands, in the order they are sent
+ *
+ * Each entry is a command followed by its argument, if it takes one.
+ */
+static const struct {
+	uint8_t length;
+	uint8_t bytes[2];
+} ssd1306_init_commands[] = {
+	// 1/32 Duty (0x0F~0x3F)
+	{2, {SSD1306_CMD_SET_MULTIPLEX_RATIO, 0xFF}},
+	// Shift Mapping RAM Counter (0x00~0x3F)
+	{2, {SSD1306_CMD_SET_DISPLAY_OFFSET, 0x00}},
+	// Set Mapping RAM Display Start Line (0x00~0x3F)
+	{1, {SSD1306_CMD_SET_DISPLAY_START_LINE(0x00)}},
+	// Set Column Address 0 Mapped to SEG0
+	{1, {SSD1306_CMD_SET_SEGMENT_RE_MAP_COL127_SEG0}},
+	// Set COM/Row Scan Scan from COM63 to 0
+	{1, {SSD1306_CMD_SET_COM_OUTPUT_SCAN_DOWN}},
+	// Set COM Pins hardware configuration
+	{2, {SSD1306_CMD_SET_COM_PINS, 0x12}},
+	{2, {SSD1306_CMD_SET_CONTRAST_CONTROL_FOR_BANK0, 0x8F}},
+	// Disable Entire display On
+	{1, {SSD1306_CMD_ENTIRE_DISPLAY_AND_GDDRAM_ON}},
+	{1, {SSD1306_CMD_SET_NORMAL_DISPLAY}},
+	// Set Display Clock Divide Ratio / Oscillator Frequency (Default => 0x80)
+	{2, {SSD1306_CMD_SET_DISPLAY_CLOCK_DIVIDE_RATIO, 0x80}},
+	// Enable charge pump regulator
+	{2, {SSD1306_CMD_SET_CHARGE_PUMP_SETTING, 0x14}},
+	// Set VCOMH Deselect Level
+	{2, {SSD1306_CMD_SET_VCOMH_DESELECT_LEVEL, 0x40}}, // Default => 0x20 (0.77*VCC)
+	// Set Pre-Charge as 15 Clocks & Discharge as 1 Clock
+	{2, {SSD1306_CMD_SET_PRE_CHARGE_PERIOD, 0xF1}},
+	{1, {SSD1306_CMD_SET_DISPLAY_ON}},
+};
+
+//! Next entry of ssd1306_init_commands to send
+static uint8_t ssd1306_init_command;
+
 /**
  * \brief Initialize the OLED controller
  *
@@ -82,6 +122,20 @@ static void ssd1306_interface_init(void)
  * to receive data.
  */
 void ssd1306_init(void)
+{
+	ssd1306_init_interface();
+
+	while (ssd1306_init_next()) {
+	}
+}
+
+/**
+ * \brief Initialize the hardware interface & reset the OLED controller
+ *
+ * First half of \ref ssd1306_init(), for bringing the display up a step at a
+ * time. Follow with calls to \ref ssd1306_init_next() until it returns false.
+ */
+void ssd1306_init_interface(void)
 {
 	// Initialize delay routine
 	delay_init();
@@ -95,51 +149,29 @@ void ssd1306_init(void)
 	// Set the reset pin to the default state
 	port_pin_set_output_level(SSD1306_RES_PIN, true);
 
-	// 1/32 Duty (0x0F~0x3F)
-	ssd1306_write_command(SSD1306_CMD_SET_MULTIPLEX_RATIO);
-	ssd1306_write_command(0xFF);
-
-	// Shift Mapping RAM Counter (0x00~0x3F)
-	ssd1306_write_command(SSD1306_CMD_SET_DISPLAY_OFFSET);
-	ssd1306_write_command(0x00);
-
-	// Set Mapping RAM Display Start Line (0x00~0x3F)
-	ssd1306_write_command(SSD1306_CMD_SET_DISPLAY_START_LINE(0x00));
-
-	// Set Column Address 0 Mapped to SEG0
-	ssd1306_write_command(SSD1306_CMD_SET_SEGMENT_RE_MAP_COL127_SEG0);
-
-	// Set COM/Row Scan Scan from COM63 to 0
-	ssd1306_write_command(SSD1306_CMD_SET_COM_OUTPUT_SCAN_DOWN);
-
-	// Set COM Pins hardware configuration
-	ssd1306_write_command(SSD1306_CMD_SET_COM_PINS);
-	ssd1306_write_command(0x12);
-
-	ssd1306_set_contrast(0x8F);
-
-	// Disable Entire display On
-	ssd1306_write_command(SSD1306_CMD_ENTIRE_DISPLAY_AND_GDDRAM_ON);
-
-	ssd1306_display_invert_disable();
-
-	// Set Display Clock Divide Ratio / Oscillator Frequency (Default => 0x80)
-	ssd1306_write_command(SSD1306_CMD_SET_DISPLAY_CLOCK_DIVIDE_RATIO);
-	ssd1306_write_command(0x80);
+	ssd1306_init_command = 0;
+}
 
-	// Enable charge pump regulator
-	ssd1306_write_command(SSD1306_CMD_SET_CHARGE_PUMP_SETTING);
-	ssd1306_write_command(0x14);
+/**
+ * \brief Send the next controller setup command
+ *
+ * \retval true  a command was sent, more remain
+ * \retval false setup is done, the display is on
+ */
+bool ssd1306_init_next(void)
+{
+	const uint8_t count = sizeof(ssd1306_init_commands) / sizeof(ssd1306_init_commands[0]);
 
-	// Set VCOMH Deselect Level
-	ssd1306_write_command(SSD1306_CMD_SET_VCOMH_DESELECT_LEVEL);
-	ssd1306_write_command(0x40); // Default => 0x20 (0.77*VCC)
+	if (ssd1306_init_command >= count) {
+		return false;
+	}
 
-	// Set Pre-Charge as 15 Clocks & Discharge as 1 Clock
-	ssd1306_write_command(SSD1306_CMD_SET_PRE_CHARGE_PERIOD);
-	ssd1306_write_command(0xF1);
+	for (uint8_t i = 0; i < ssd1306_init_commands[ssd1306_init_command].length; i++) {
+		ssd1306_write_command(ssd1306_init_commands[ssd1306_init_command].bytes[i]);
+	}
+	ssd1306_init_command++;
 
-	ssd1306_display_on();
+	return true;
 }
 
 /**
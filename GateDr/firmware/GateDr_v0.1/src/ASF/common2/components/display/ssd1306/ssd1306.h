@@ -319,6 +319,8 @@ static inline void ssd1306_display_invert_disable(void)
 //! \name Initialization
 //@{
 void ssd1306_init(void);
+void ssd1306_init_interface(void);
+bool ssd1306_init_next(void);
 //@}
 
 /** @} */
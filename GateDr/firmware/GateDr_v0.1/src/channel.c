@@ -8,45 +8,72 @@
 #define	DEFAULT_OP_2 OP_OR
 #define DEFAULT_OUT2_SETTINGS OUT2_SEPARATE
 
-// byte sizes for packing/unpacking data to/from NVM
-#define SIZE_INPUT	7
-#define SIZE_OUTPUT	15
-#define SIZE_OP 2
+// byte sizes for unpacking data from legacy (v0) NVM pages
+#define LEGACY_SIZE_INPUT	7
+#define LEGACY_SIZE_OUTPUT	15
+#define LEGACY_SIZE_OP		2
+
+#define CHANNEL_FIELD(x)	offsetof(struct Channel, x)
 
 const char *opStrings[] = {"AND", "NAND", "OR", "NOR", "XOR", "XNOR", "S-R", "D", "BYP"};
+static const char *copyIn1Strings[] = {"No", "Yes"};
+static const char *out2Strings[] = {"sep", "foll", "inv", "bern"};
 char submenuStr[3] = "->";					// parameter display 'value' for submenu 
-const char *cvStr[] = {" ", "CV1", "CV2"};	// corresponds to CvSel enum
-static const char *trigStrings[] = {"off", "rise", "fall", "COV"};
-static const char *divRstString[] = {"none", "CV1", "CV2", "In1", "In2"};
-static const char *out2Strings[] = {"sep", "foll", "inv"};
 
+// ops have no 'default' display state, the channel menu is never inverted
+const struct ParamDesc channelParams[CHANNEL_PARAM_COUNT] = {
+	[CHANNEL_PARAM_COPY_IN1] =	{PARAM_UINT8, 0, false, true, 1, false,
+									NULL, copyIn1Strings, CHANNEL_FIELD(input.copyIn1), 0,
+									CHANNEL_FIELD(input.copyIn1Str), CHANNEL_FIELD(input.copyIn1Def)},
+	[CHANNEL_PARAM_OP_1] =		{PARAM_UINT8, PARAM_FLAG_CV | PARAM_FLAG_NO_DEF, OP_AND, OP_BYP, 1, DEFAULT_OP_1,
+									NULL, opStrings, CHANNEL_FIELD(op_select[0]), CHANNEL_FIELD(op_cv[0]),
+									CHANNEL_FIELD(op1Str), 0},
+	[CHANNEL_PARAM_OP_2] =		{PARAM_UINT8, PARAM_FLAG_CV | PARAM_FLAG_NO_DEF, OP_AND, OP_BYP, 1, DEFAULT_OP_2,
+									NULL, opStrings, CHANNEL_FIELD(op_select[1]), CHANNEL_FIELD(op_cv[1]),
+									CHANNEL_FIELD(op2Str), 0},
+	[CHANNEL_PARAM_OUT2] =		{PARAM_UINT8, 0, OUT2_SEPARATE, OUT2_BERN, 1, DEFAULT_OUT2_SETTINGS,
+									NULL, out2Strings, CHANNEL_FIELD(out.out2_settings), 0,
+									CHANNEL_FIELD(out.out2Str), CHANNEL_FIELD(out.out2Def)}
+	};
+
+// the output loop registers sit at the very end of the channel page, the
+// settings are packed up to them & no further
+#define LOOP_REG_BIT_POS	((EEPROM_PAGE_SIZE * 8) - 64)
 
 // helper function declaration
-static inline void writeChannelStrings(struct Channel *ch);
-static inline void readChannelDefaultStates(struct Channel *ch);
+static void readChannelLegacy(struct Channel *ch, const uint8_t *buffer);
 static inline void assignChannelStrings(struct Channel * ch);
 
 /*
- *	initialize channel, 
+ *	initialize channel, must be called after the settings have been read
+ *	from NVM so processing starts with them already published
 */
-void initChannel(struct Channel *ch, uint32_t *currentCount, uint8_t num) {
+void initChannel(struct Channel *ch, uint32_t *currentCount, uint32_t *timebaseCount, uint8_t num) {
 	ch->out.rtcCurentCount = currentCount;
+	ch->out.timebaseCount = timebaseCount;
 	assignChannelStrings(ch);
+	
+	takeChannelSnapshot(ch, &ch->active);
+	ch->publishedSeq = ch->editSeq;
+	for (uint8_t j=0; j<2; j++) {
+		updateInputTrips(&ch->active.input_settings[j], &ch->input.input_state[j]);
+		
+		// a loop that boots locked is the one already stored, it's only saved
+		// again once it has been unlocked & locked
+		ch->out.output_state[j].loop_locked = true;
+	}
 }
 
 /*
  *	set all input, output and channel defaults
 */
 void setChannelDefaults(struct Channel *ch, uint8_t num) {
-	// initialize ops
-	ch->op_select[0] =	DEFAULT_OP_1;
-	ch->op_select[1] =	DEFAULT_OP_2;
-	ch->op_cv[0] =		CV_NONE;
-	ch->op_cv[1] =		CV_NONE;
+	beginChannelEdit(ch);
+	
+	// initialize ops and shared input, output and channel settings
+	paramsSetDefaults(channelParams, CHANNEL_PARAM_COUNT, ch);
 	ch->cv_op_prev[0] = DEFAULT_OP_1;
 	ch->cv_op_prev[1] = DEFAULT_OP_2;
-	sprintf(ch->op1Str, opStrings[ch->op_select[0]]);
-	sprintf(ch->op2Str, opStrings[ch->op_select[1]]);
 	ch->opDef = true;
 	
 	// initialize inputs and outputs
@@ -57,35 +84,33 @@ void setChannelDefaults(struct Channel *ch, uint8_t num) {
 		setOutputStateDefaults(&(ch->out.output_state[i]));
 	}
 	
-	// initialize shared input, output and channel settings
-	ch->input.copyIn1 = false;
-	sprintf(ch->input.copyIn1Str, "No");
-	ch->input.copyIn1Def = true;
-	ch->out.out2_settings = DEFAULT_OUT2_SETTINGS;
-	sprintf(ch->out.out2Str, "sep");
-	ch->out.out2Def = true;
+	endChannelEdit(ch);
+	refreshChannelStrings(ch);
 		
-	// write settings to NVM
+	// write settings & the cleared loops to NVM
 	writeChannelNVM(ch, num);
+	writeChannelLoops(ch, num);
 }
 
 /*
  *	process the inputs, operations, and outputs for a given channel,
- *	using their respective process functions
+ *	using their respective process functions and the published settings
 */
-void processChannel(struct Channel *ch, int16_t in1, int16_t in2, struct Cv *cv) {
+HOT_FUNC void processChannel(struct Channel *ch, int16_t in1, int16_t in2, struct Cv *cv) {
+	struct ChannelSnapshot *settings = &ch->active;
+	
 	// process inputs
-	processChannelInput(&ch->input, in1, in2, cv);
+	processChannelInput(&ch->input, settings->input_settings, settings->copyIn1, in1, in2, cv, *ch->out.timebaseCount);
 	
 	// process each operation from the inputs, selecting from CV if necessary
 	uint8_t op;
 	bool result[2]; 
 	
 	for (uint8_t i=0; i<2; i++) {
-		op = ch->op_select[i];
+		op = settings->op_select[i];
 		
-		if (ch->op_cv[i] != CV_NONE) {	// replace op with CV selection if applicable
-			op = normalizeCvUint8(cv, ch->op_cv[i], OP_AND, OP_BYP, ch->cv_op_prev[i]);
+		if (settings->op_cv[i] != CV_NONE) {	// replace op with CV selection if applicable
+			op = normalizeCvUint8(cv, settings->op_cv[i], OP_AND, OP_BYP, ch->cv_op_prev[i]);
 			ch->cv_op_prev[i] = op;
 		}
 		
@@ -96,292 +121,291 @@ void processChannel(struct Channel *ch, int16_t in1, int16_t in2, struct Cv *cv)
 	}
 	
 	// process the outputs
-	processChannelOutput(&(ch->out), result[0], result[1], cv, &ch->input);
+	processChannelOutput(&(ch->out), settings->output_settings, settings->out2_settings, 
+							result[0], result[1], cv, &ch->input);
 }
 
 /*
- *	increment/decrement the current op of index 'i', update the
- *	corresponding CV enum and string parameter
+ *	mark the start of an edit to a channel's shadow settings. the edit won't be
+ *	published until endChannelEdit() is called, so processing never sees a
+ *	half-applied change (i.e. a value without its CV selection)
 */
-void updateOp(struct Channel *ch, bool i, bool inc) {
-	updateUint8t(&ch->op_select[i], &ch->op_cv[i], inc, OP_AND, OP_BYP, 1);
+void beginChannelEdit(struct Channel *ch) {
+	ch->editSeq++;
+}
+
+/*
+ *	mark the end of an edit to a channel's shadow settings, to be published
+ *	at the start of the next processing tick
+*/
+void endChannelEdit(struct Channel *ch) {
+	ch->editSeq++;
+}
+
+/*
+ *	copy the shadow settings to the active settings used by processing if
+ *	they've been edited since last published, & work the input comparators
+ *	out again from them. called at the start of a processing tick. an edit
+ *	still in progress (odd sequence) is left for the next tick, so this never
+ *	waits on or blocks the editing side
+*/
+void publishChannelSettings(struct Channel *ch) {
+	uint8_t seq = ch->editSeq;
 	
-	if (ch->op_cv[i] != CV_NONE) {
-		sprintf(ch->chMenuParams[i+1], (ch->op_cv[i] == CV1)? "CV1":"CV2");
+	if ((seq == ch->publishedSeq) || (seq & 1)) {
+		return;
 	}
-	else {	// not under CV control
-		sprintf(ch->chMenuParams[i+1], opStrings[ch->op_select[i]]);
+	
+	takeChannelSnapshot(ch, &ch->active);
+	ch->publishedSeq = seq;
+	for (uint8_t j=0; j<2; j++) {
+		updateInputTrips(&ch->active.input_settings[j], &ch->input.input_state[j]);
 	}
 }
 
 /*
  *	read a channel's non-volatile memory settings at the memory index i,
- *	unpack into the struct given by *ch, and write the variable strings
+ *	validate and unpack into the struct given by *ch, and write the variable
+ *	strings. legacy pages are migrated & rewritten in the current format,
+ *	and a corrupted page falls back to the channel defaults
 */
 void readChannelNVM(struct Channel *ch, uint8_t i) {
 	uint8_t buffer[EEPROM_PAGE_SIZE];
-	uint8_t addr = 0;
-	uint8_t j;
+	uint8_t version;
+	struct NvmPacker packer;
+	struct ChannelSnapshot snapshot;
 	
 	eeprom_emulator_read_page(i, buffer);
-
-	// input settings x2
-	// 1.threshold 2.invert 3.hysteresis
-	// 4.threshold CV 5.invert CV 6.hysteresis CV
-	for (j=0; j<2; j++) {
-		uint16_t temp = 0;
-		temp += buffer[j*SIZE_INPUT] << 8;
-		temp += buffer[(j*SIZE_INPUT)+1];
-		ch->input.input_settings[j].threshold = temp;
-		ch->input.input_settings[j].invert = buffer[(j*SIZE_INPUT)+2];
-		ch->input.input_settings[j].hysteresis = buffer[(j*SIZE_INPUT)+3];
-		ch->input.input_settings[j].thresholdCv = buffer[(j*SIZE_INPUT)+4];
-		ch->input.input_settings[j].invertCv = buffer[(j*SIZE_INPUT)+5];
-		ch->input.input_settings[j].hysCv = buffer[(j*SIZE_INPUT)+6];
-	}
+	nvmCacheLoadPage(i, buffer);
 	
-	addr += SIZE_INPUT * 2;
-	// input 2 copy input 1
-	ch->input.copyIn1 = buffer[addr];
-	addr++;
-	
-	// op settings x2
-	// 1. operation 2.op CV
-	for (j=0; j<2; j++) {
-		ch->op_select[j] = buffer[addr+(j*SIZE_OP)];
-		ch->op_cv[j] = buffer[addr+(j*SIZE_OP)+1];
-	}
-	
-	addr += SIZE_OP * 2;
-	// output settings x2
-	// 1.probability 2.trig 3.trigLen 4.clkDiv 5.clkPhase 6.divRst 
-	// 7.probability CV 8.trig CV 9.trigLen CV 10.clkDiv CV 11. clkPhase CV
-	// 12. delay 13. delay CV
-	for (j=0; j<2; j++) {
-		uint16_t temp = 0;
-		ch->out.output_settings[j].probability = buffer[addr+(j*SIZE_OUTPUT)];
-		ch->out.output_settings[j].trig = buffer[addr+(j*SIZE_OUTPUT)+1];
-		temp += buffer[addr+(j*SIZE_OUTPUT)+2] << 8;
-		temp += buffer[addr+(j*SIZE_OUTPUT)+3];
-		ch->out.output_settings[j].trigLen = temp;
-		ch->out.output_settings[j].clkDiv = buffer[addr+(j*SIZE_OUTPUT)+4];
-		ch->out.output_settings[j].clkPhase = buffer[addr+(j*SIZE_OUTPUT)+5];
-		ch->out.output_settings[j].divRst = buffer[addr+(j*SIZE_OUTPUT)+6];
-		ch->out.output_settings[j].probabilityCv = buffer[addr+(j*SIZE_OUTPUT)+7];
-		ch->out.output_settings[j].trigCv = buffer[addr+(j*SIZE_OUTPUT)+8];
-		ch->out.output_settings[j].trigLenCv = buffer[addr+(j*SIZE_OUTPUT)+9];
-		ch->out.output_settings[j].clkDivCv = buffer[addr+(j*SIZE_OUTPUT)+10];
-		ch->out.output_settings[j].clkPhaseCv = buffer[addr+(j*SIZE_OUTPUT)+11];
-		temp = 0;
-		temp += buffer[addr+(j*SIZE_OUTPUT)+12] << 8;
-		temp += buffer[addr+(j*SIZE_OUTPUT)+13];
-		ch->out.output_settings[j].delay = temp;
-		ch->out.output_settings[j].delayCv = buffer[addr+(j*SIZE_OUTPUT)+14];
+	switch (nvmCheckPage(buffer, &version)) {
+		case NVM_PAGE_VALID:
+			// the layout of the whole page moves with any change to the settings
+			// tables, so a page from any other schema version is reset rather than
+			// unpacked into the wrong fields
+			if (version != NVM_SCHEMA_VERSION) {
+				setChannelDefaults(ch, i);
+				break;
+			}
+			nvmPackInit(&packer, buffer);
+			unpackChannelSnapshot(&snapshot, &packer);
+			loadChannelSnapshot(ch, &snapshot);
+			break;
+		case NVM_PAGE_LEGACY:
+			readChannelLegacy(ch, buffer);
+			writeChannelNVM(ch, i);
+			writeChannelLoops(ch, i);
+			break;
+		case NVM_PAGE_CORRUPT:
+			setChannelDefaults(ch, i);
+			break;
 	}
 	
-	addr += SIZE_OUTPUT * 2;
-	// output 2 mode
-	ch->out.out2_settings = buffer[addr];
-	
 	// update string settings for display
-	writeChannelStrings(ch);
-	readChannelDefaultStates(ch);
+	refreshChannelStrings(ch);
 	assignChannelStrings(ch);
 }
 
 /*
- *	pack up a struct's current settings and write them to non-volatile
- *	memory at the memory channel index i
+ *	pack up a struct's current settings and queue them for writing to 
+ *	non-volatile memory at the memory channel index i
 */
 void writeChannelNVM(struct Channel *ch, uint8_t i) {
 	uint8_t buffer[EEPROM_PAGE_SIZE] = {0};
-	uint8_t addr = 0;
+	
+	packChannelNVM(ch, buffer);
+	
+	// the loop registers are only saved by writeChannelLoops(), a settings
+	// write carries over the ones already stored. that keeps a running loop
+	// out of the comparison against the stored page
+	memcpy(&buffer[LOOP_REG_BIT_POS / 8], &nvm_cache.image[i][LOOP_REG_BIT_POS / 8],
+			EEPROM_PAGE_SIZE - (LOOP_REG_BIT_POS / 8));
+	
+	nvmSealPage(buffer);
+	nvmCacheWritePage(i, buffer);
+}
+
+/*
+ *	queue a channel's current output loop registers for writing to its page
+ *	in non-volatile memory, the settings are left as they're already stored
+*/
+void writeChannelLoops(struct Channel *ch, uint8_t i) {
+	uint8_t buffer[EEPROM_PAGE_SIZE];
+	struct NvmPacker packer;
+	
+	memcpy(buffer, nvm_cache.image[i], EEPROM_PAGE_SIZE);
+	memset(&buffer[LOOP_REG_BIT_POS / 8], 0, EEPROM_PAGE_SIZE - (LOOP_REG_BIT_POS / 8));
+	
+	// output loop registers, 16 bits at a time
+	nvmPackInit(&packer, buffer);
+	nvmPackSeek(&packer, LOOP_REG_BIT_POS);
+	for (uint8_t j=0; j<2; j++) {
+		nvmPackField(&packer, ch->out.output_state[j].loop_reg >> 16, 0, UINT16_MAX);
+		nvmPackField(&packer, ch->out.output_state[j].loop_reg & UINT16_MAX, 0, UINT16_MAX);
+	}
+	
+	nvmSealPage(buffer);
+	nvmCacheWritePage(i, buffer);
+}
+
+/*
+ *	save a channel's output loops once one of them has just been locked, 
+ *	called once per processing loop after the outputs are set
+*/
+void saveChannelLoops(struct Channel *ch, uint8_t i) {
+	struct OutputState *state = ch->out.output_state;
+	
+	if (state[0].loop_save || state[1].loop_save) {
+		state[0].loop_save = false;
+		state[1].loop_save = false;
+		writeChannelLoops(ch, i);
+	}
+}
+
+/*
+ *	pack a channel's current settings into a zeroed page buffer, up to the 
+ *	loop registers. returns false if they ran into them & were cut short
+*/
+bool packChannelNVM(struct Channel *ch, uint8_t *buffer) {
+	struct NvmPacker packer;
 	uint8_t j;
 	
-	// input settings x2
-	// 1.threshold 2.invert 3.hysteresis
-	// 4.threshold CV 5.invert CV 6.hysteresis CV
+	nvmPackInit(&packer, buffer);
+	nvmPackLimit(&packer, LOOP_REG_BIT_POS);
+	
+	// input settings x2, input 2 copy input 1
 	for (j=0; j<2; j++) {
-		buffer[j*SIZE_INPUT] = (uint8_t)((ch->input.input_settings[j].threshold >> 8) & 0xFF);
-		buffer[(j*SIZE_INPUT)+1] = (uint8_t)((ch->input.input_settings[j].threshold) & 0xFF);
-		buffer[(j*SIZE_INPUT)+2] = (uint8_t)(ch->input.input_settings[j].invert);
-		buffer[(j*SIZE_INPUT)+3] = ch->input.input_settings[j].hysteresis;
-		buffer[(j*SIZE_INPUT)+4] = ch->input.input_settings[j].thresholdCv;
-		buffer[(j*SIZE_INPUT)+5] = ch->input.input_settings[j].invertCv;
-		buffer[(j*SIZE_INPUT)+6] = ch->input.input_settings[j].hysCv;
+		paramsPack(inputParams, INPUT_PARAM_COUNT, &ch->input.input_settings[j], &packer);
 	}
-	
-	addr += SIZE_INPUT * 2;
-	// input 2 copy input 1
-	buffer[addr] = ch->input.copyIn1;
-	addr++;
+	paramPack(&channelParams[CHANNEL_PARAM_COPY_IN1], ch, &packer);
 	
 	// op settings x2
 	// 1. operation 2.op CV
 	for (j=0; j<2; j++) {
-		buffer[addr+(j*SIZE_OP)] = ch->op_select[j];
-		buffer[addr+(j*SIZE_OP)+1] = ch->op_cv[j];
+		paramPack(&channelParams[CHANNEL_PARAM_OP_1+j], ch, &packer);
 	}
 	
-	addr += SIZE_OP * 2;
-	// output settings x2
-	// 1.probability 2.trig 3.trigLen 4.clkDiv 5.clkPhase 6.divRst
+	// output settings x2, output 2 mode
 	for (j=0; j<2; j++) {
-		buffer[addr+(j*SIZE_OUTPUT)] = ch->out.output_settings[j].probability;
-		buffer[addr+(j*SIZE_OUTPUT)+1] = ch->out.output_settings[j].trig;
-		buffer[addr+(j*SIZE_OUTPUT)+2] = (uint8_t)((ch->out.output_settings[j].trigLen >> 8) & 0xFF);
-		buffer[addr+(j*SIZE_OUTPUT)+3] = (uint8_t)((ch->out.output_settings[j].trigLen) & 0xFF);
-		buffer[addr+(j*SIZE_OUTPUT)+4] = ch->out.output_settings[j].clkDiv;
-		buffer[addr+(j*SIZE_OUTPUT)+5] = ch->out.output_settings[j].clkPhase;
-		buffer[addr+(j*SIZE_OUTPUT)+6] = ch->out.output_settings[j].divRst;
-		buffer[addr+(j*SIZE_OUTPUT)+7] = ch->out.output_settings[j].probabilityCv;
-		buffer[addr+(j*SIZE_OUTPUT)+8] = ch->out.output_settings[j].trigCv;
-		buffer[addr+(j*SIZE_OUTPUT)+9] = ch->out.output_settings[j].trigLenCv;
-		buffer[addr+(j*SIZE_OUTPUT)+10] = ch->out.output_settings[j].clkDivCv;
-		buffer[addr+(j*SIZE_OUTPUT)+11] = ch->out.output_settings[j].clkPhaseCv;
-		buffer[addr+(j*SIZE_OUTPUT)+12] = (uint8_t)((ch->out.output_settings[j].delay >> 8) & 0xFF);
-		buffer[addr+(j*SIZE_OUTPUT)+13] = (uint8_t)((ch->out.output_settings[j].delay) & 0xFF);
-		buffer[addr+(j*SIZE_OUTPUT)+14] = ch->out.output_settings[j].delayCv;
+		paramsPack(outputParams, OUTPUT_PARAM_COUNT, &ch->out.output_settings[j], &packer);
 	}
+	paramPack(&channelParams[CHANNEL_PARAM_OUT2], ch, &packer);
 	
-	addr += SIZE_OUTPUT * 2;
-	
-	// output 2 mode
-	buffer[addr] = ch->out.out2_settings;
-	
-	eeprom_emulator_write_page(i, buffer);
+	return !packer.overflow;
 }
 
 /*
- *	write the input, output, and channel strings based on the currently 
- *	loaded variables
+ *	unpack a channel's settings from a validated NVM page, in the same order
+ *	they're packed by packChannelNVM()
 */
-static inline void writeChannelStrings(struct Channel *ch) {
+void unpackChannelSnapshot(struct ChannelSnapshot *snapshot, struct NvmPacker *packer) {
 	uint8_t j;
 	
-	// write the channel input & output strings
+	nvmPackLimit(packer, LOOP_REG_BIT_POS);
 	for (j=0; j<2; j++) {
-		// input threshold
-		if (ch->input.input_settings[j].thresholdCv != CV_NONE) {
-			sprintf(ch->input.input_settings[j].thresholdStr, 
-						cvStr[ch->input.input_settings[j].thresholdCv]);
-		}
-		else {	// not under CV control
-			sprintf(ch->input.input_settings[j].thresholdStr, "%dmV", 
-						ch->input.input_settings[j].threshold);
-		}
-		
-		// input invert
-		if (ch->input.input_settings[j].invertCv != CV_NONE) {
-			sprintf(ch->input.input_settings[j].invertStr, 
-						cvStr[ch->input.input_settings[j].invertCv]);
-		}
-		else {	// not under CV control
-			sprintf(ch->input.input_settings[j].invertStr, 
-						ch->input.input_settings[j].invert ? "true" : "false");
-		}
-		
-		// input hysteresis
-		if (ch->input.input_settings[j].hysCv != CV_NONE) {
-			sprintf(ch->input.input_settings[j].hysStr,
-						cvStr[ch->input.input_settings[j].hysCv]);
-		}
-		else {	// not under CV control
-			sprintf(ch->input.input_settings[j].hysStr, "%d0mV",
-						ch->input.input_settings[j].hysteresis);
-		}
-		
-		// output probability
-		if (ch->out.output_settings[j].probabilityCv != CV_NONE) {
-			sprintf(ch->out.output_settings[j].probabilityStr,
-						cvStr[ch->out.output_settings[j].probabilityCv]);
-		}
-		else {	// not under CV control
-			sprintf(ch->out.output_settings[j].probabilityStr, "%d%%",
-						ch->out.output_settings[j].probability);
-		}
-		
-		// output delay
-		if (ch->out.output_settings[j].delayCv != CV_NONE) {
-			sprintf(ch->out.output_settings[j].delayStr, 
-						cvStr[ch->out.output_settings[j].delayCv]);
-		}
-		else {	// not under CV control
-			sprintf(ch->out.output_settings[j].delayStr, "%dms",
-						ch->out.output_settings[j].delay);
-		}
-		
-		// output trig
-		if (ch->out.output_settings[j].trigCv != CV_NONE) {
-			sprintf(ch->out.output_settings[j].trigStr, 
-						cvStr[ch->out.output_settings[j].trigCv]);
-		}
-		else {	// not under CV control
-			sprintf(ch->out.output_settings[j].trigStr, 
-						trigStrings[ch->out.output_settings[j].trig]);
-		}
-		
-		// output trig length
-		if (ch->out.output_settings[j].trigLenCv != CV_NONE) {
-			sprintf(ch->out.output_settings[j].trigLenStr,
-						cvStr[ch->out.output_settings[j].trigLenCv]);
-		}
-		else {	// not under CV control
-			sprintf(ch->out.output_settings[j].trigLenStr, "%dms",
-						ch->out.output_settings[j].trigLen);
-		}
-		
-		// output clk division
-		if (ch->out.output_settings[j].clkDivCv != CV_NONE) {
-			sprintf(ch->out.output_settings[j].clkDivStr,
-						cvStr[ch->out.output_settings[j].clkDivCv]);
-		}
-		else {	// not under CV control
-			sprintf(ch->out.output_settings[j].clkDivStr, "/%d",
-						ch->out.output_settings[j].clkDiv);
-		}
-		
-		// output clk phase
-		if (ch->out.output_settings[j].clkPhaseCv != CV_NONE) {
-			sprintf(ch->out.output_settings[j].clkPhaseStr,
-						cvStr[ch->out.output_settings[j].clkPhaseCv]);
-		}
-		else {	// not under CV control
-			sprintf(ch->out.output_settings[j].clkPhaseStr, "%d",
-						ch->out.output_settings[j].clkPhase);
-		}
-		
-		// output clk reset (no CV control)
-		sprintf(ch->out.output_settings[j].divRstStr, "%s",
-					divRstString[ch->out.output_settings[j].divRst]);
+		paramsUnpack(inputParams, INPUT_PARAM_COUNT, &snapshot->input_settings[j], packer);
 	}
-	
-	// channel settings (in2, out2 & op)
-	sprintf(ch->input.copyIn1Str, (ch->input.copyIn1) ? "Yes":"No");
-	sprintf(ch->out.out2Str, out2Strings[ch->out.out2_settings]);
-	if (ch->op_cv[0] != CV_NONE) {	// OP 1
-		sprintf(ch->op1Str, cvStr[ch->op_cv[0]]);
+	snapshot->copyIn1 = paramUnpackValue(&channelParams[CHANNEL_PARAM_COPY_IN1], packer);
+	for (j=0; j<2; j++) {
+		snapshot->op_select[j] = paramUnpackValue(&channelParams[CHANNEL_PARAM_OP_1+j], packer);
+		snapshot->op_cv[j] = paramUnpackCv(packer);
 	}
-	else {	// not under CV control
-		sprintf(ch->op1Str, opStrings[ch->op_select[0]]);
+	for (j=0; j<2; j++) {
+		paramsUnpack(outputParams, OUTPUT_PARAM_COUNT, &snapshot->output_settings[j], packer);
 	}
-	if (ch->op_cv[1] != CV_NONE) {	// OP 2
-		sprintf(ch->op2Str, cvStr[ch->op_cv[1]]);
+	snapshot->out2_settings = paramUnpackValue(&channelParams[CHANNEL_PARAM_OUT2], packer);
+	
+	nvmPackSeek(packer, LOOP_REG_BIT_POS);
+	nvmPackLimit(packer, EEPROM_PAGE_SIZE * 8);
+	for (j=0; j<2; j++) {
+		snapshot->loop_reg[j] = (uint32_t)nvmUnpackField(packer, 0, UINT16_MAX, 0) << 16;
+		snapshot->loop_reg[j] |= nvmUnpackField(packer, 0, UINT16_MAX, 0);
 	}
-	else {	// not under CV control
-		sprintf(ch->op2Str, opStrings[ch->op_select[1]]);
+}
+
+/*
+ *	copy a snapshot's settings into a channel's shadow settings. only settings
+ *	and the output loop registers are touched, so running dividers, delays and 
+ *	trigs carry on through the swap.
+ *	display strings and default states are left for refreshChannelStrings() 
+ *	outside of the processing path
+*/
+void loadChannelSnapshot(struct Channel *ch, struct ChannelSnapshot *snapshot) {
+	for (uint8_t j=0; j<2; j++) {
+		ch->input.input_settings[j] = snapshot->input_settings[j];
+		ch->op_select[j] = snapshot->op_select[j];
+		ch->op_cv[j] = snapshot->op_cv[j];
+		ch->out.output_settings[j] = snapshot->output_settings[j];
+		ch->out.output_state[j].loop_reg = snapshot->loop_reg[j];
 	}
+	ch->input.copyIn1 = snapshot->copyIn1;
+	ch->out.out2_settings = snapshot->out2_settings;
 }
 
 /*
- *	write the input, output, and channel default states based on the currently 
- *	loaded variables
+ *	copy a channel's shadow settings into a snapshot
 */
-static inline void readChannelDefaultStates(struct Channel *ch) {
+void takeChannelSnapshot(struct Channel *ch, struct ChannelSnapshot *snapshot) {
+	for (uint8_t j=0; j<2; j++) {
+		snapshot->input_settings[j] = ch->input.input_settings[j];
+		snapshot->op_select[j] = ch->op_select[j];
+		snapshot->op_cv[j] = ch->op_cv[j];
+		snapshot->output_settings[j] = ch->out.output_settings[j];
+		snapshot->loop_reg[j] = ch->out.output_state[j].loop_reg;
+	}
+	snapshot->copyIn1 = ch->input.copyIn1;
+	snapshot->out2_settings = ch->out.out2_settings;
+}
+
+/*
+ *	rewrite a channel's display strings and default states from its 
+ *	current settings
+*/
+void refreshChannelStrings(struct Channel *ch) {
+	for (uint8_t j=0; j<2; j++) {
+		paramsRender(inputParams, INPUT_PARAM_COUNT, &ch->input.input_settings[j], &ch->input.input_display[j]);
+		paramsRender(outputParams, OUTPUT_PARAM_COUNT, &ch->out.output_settings[j], &ch->out.output_display[j]);
+	}
+	paramsRender(channelParams, CHANNEL_PARAM_COUNT, ch, ch);
+	
 	ch->opDef = true;
+}
+
+/*
+ *	unpack a channel page from the legacy (v0) byte layout, range checking
+ *	each field as we go
+*/
+static void readChannelLegacy(struct Channel *ch, const uint8_t *buffer) {
+	uint8_t addr = 0;
+	uint8_t j;
 	
-	readInputDefaultStates(&ch->input);
-	readOutputDefaultStates(&ch->out);
+	// input settings x2
+	for (j=0; j<2; j++) {
+		unpackInputSettingsLegacy(&ch->input.input_settings[j], &buffer[j*LEGACY_SIZE_INPUT]);
+	}
+	
+	addr += LEGACY_SIZE_INPUT * 2;
+	// input 2 copy input 1
+	ch->input.copyIn1 = nvmValidateField(buffer[addr], false, true, false);
+	addr++;
+	
+	// op settings x2
+	// 1. operation 2.op CV
+	for (j=0; j<2; j++) {
+		ch->op_select[j] = nvmValidateField(buffer[addr+(j*LEGACY_SIZE_OP)], OP_AND, OP_BYP, 
+											(j == 0) ? DEFAULT_OP_1:DEFAULT_OP_2);
+		ch->op_cv[j] = nvmValidateField(buffer[addr+(j*LEGACY_SIZE_OP)+1], CV_NONE, CV2, CV_NONE);
+	}
+	
+	addr += LEGACY_SIZE_OP * 2;
+	// output settings x2
+	for (j=0; j<2; j++) {
+		unpackOutputSettingsLegacy(&ch->out.output_settings[j], &buffer[addr+(j*LEGACY_SIZE_OUTPUT)]);
+	}
+	
+	addr += LEGACY_SIZE_OUTPUT * 2;
+	// output 2 mode
+	unpackOut2SettingsLegacy(&ch->out, &buffer[addr]);
 }
 
 /*
@@ -392,21 +416,49 @@ static inline void assignChannelStrings(struct Channel * ch)
 	
 	// initialize our arrays of string pointers to the strings just initialized
 	// by the 'setXDefaults' functions
-	ch->inputsMenuParams[0] = ch->input.input_settings[0].thresholdStr;
-	ch->inputsMenuParams[1] = ch->input.input_settings[0].hysStr;
-	ch->inputsMenuParams[2] = ch->input.input_settings[0].invertStr;
-	ch->inputsMenuParams[3] = ch->input.copyIn1Str;
-	ch->inputsMenuParams[4] = ch->input.input_settings[1].thresholdStr;
-	ch->inputsMenuParams[5] = ch->input.input_settings[1].hysStr;
-	ch->inputsMenuParams[6] = ch->input.input_settings[1].invertStr;
-	
-	ch->inputsMenuDefaults[0] = &ch->input.input_settings[0].thresholdDef;
-	ch->inputsMenuDefaults[1] = &ch->input.input_settings[0].hysDef;
-	ch->inputsMenuDefaults[2] = &ch->input.input_settings[0].invertDef;
-	ch->inputsMenuDefaults[3] = &ch->input.copyIn1Def;
-	ch->inputsMenuDefaults[4] = &ch->input.input_settings[1].thresholdDef;
-	ch->inputsMenuDefaults[5] = &ch->input.input_settings[1].hysDef;
-	ch->inputsMenuDefaults[6] = &ch->input.input_settings[1].invertDef;
+	ch->inputsMenuParams[0] = ch->input.input_display[0].sourceStr;
+	ch->inputsMenuParams[1] = ch->input.input_display[0].modeStr;
+	ch->inputsMenuParams[2] = ch->input.input_display[0].slopeStr;
+	ch->inputsMenuParams[3] = ch->input.input_display[0].slopeLenStr;
+	ch->inputsMenuParams[4] = ch->input.input_display[0].thresholdStr;
+	ch->inputsMenuParams[5] = ch->input.input_display[0].winSizeStr;
+	ch->inputsMenuParams[6] = ch->input.input_display[0].winOutStr;
+	ch->inputsMenuParams[7] = ch->input.input_display[0].hysStr;
+	ch->inputsMenuParams[8] = ch->input.input_display[0].invertStr;
+	ch->inputsMenuParams[9] = ch->input.input_display[0].filterStr;
+	ch->inputsMenuParams[10] = ch->input.copyIn1Str;
+	ch->inputsMenuParams[11] = ch->input.input_display[1].sourceStr;
+	ch->inputsMenuParams[12] = ch->input.input_display[1].modeStr;
+	ch->inputsMenuParams[13] = ch->input.input_display[1].slopeStr;
+	ch->inputsMenuParams[14] = ch->input.input_display[1].slopeLenStr;
+	ch->inputsMenuParams[15] = ch->input.input_display[1].thresholdStr;
+	ch->inputsMenuParams[16] = ch->input.input_display[1].winSizeStr;
+	ch->inputsMenuParams[17] = ch->input.input_display[1].winOutStr;
+	ch->inputsMenuParams[18] = ch->input.input_display[1].hysStr;
+	ch->inputsMenuParams[19] = ch->input.input_display[1].invertStr;
+	ch->inputsMenuParams[20] = ch->input.input_display[1].filterStr;
+	
+	ch->inputsMenuDefaults[0] = &ch->input.input_display[0].sourceDef;
+	ch->inputsMenuDefaults[1] = &ch->input.input_display[0].modeDef;
+	ch->inputsMenuDefaults[2] = &ch->input.input_display[0].slopeDef;
+	ch->inputsMenuDefaults[3] = &ch->input.input_display[0].slopeLenDef;
+	ch->inputsMenuDefaults[4] = &ch->input.input_display[0].thresholdDef;
+	ch->inputsMenuDefaults[5] = &ch->input.input_display[0].winSizeDef;
+	ch->inputsMenuDefaults[6] = &ch->input.input_display[0].winOutDef;
+	ch->inputsMenuDefaults[7] = &ch->input.input_display[0].hysDef;
+	ch->inputsMenuDefaults[8] = &ch->input.input_display[0].invertDef;
+	ch->inputsMenuDefaults[9] = &ch->input.input_display[0].filterDef;
+	ch->inputsMenuDefaults[10] = &ch->input.copyIn1Def;
+	ch->inputsMenuDefaults[11] = &ch->input.input_display[1].sourceDef;
+	ch->inputsMenuDefaults[12] = &ch->input.input_display[1].modeDef;
+	ch->inputsMenuDefaults[13] = &ch->input.input_display[1].slopeDef;
+	ch->inputsMenuDefaults[14] = &ch->input.input_display[1].slopeLenDef;
+	ch->inputsMenuDefaults[15] = &ch->input.input_display[1].thresholdDef;
+	ch->inputsMenuDefaults[16] = &ch->input.input_display[1].winSizeDef;
+	ch->inputsMenuDefaults[17] = &ch->input.input_display[1].winOutDef;
+	ch->inputsMenuDefaults[18] = &ch->input.input_display[1].hysDef;
+	ch->inputsMenuDefaults[19] = &ch->input.input_display[1].invertDef;
+	ch->inputsMenuDefaults[20] = &ch->input.input_display[1].filterDef;
 	
 	ch->chMenuParams[0] = submenuStr;
 	ch->chMenuParams[1] = ch->op1Str;
@@ -418,35 +470,75 @@ static inline void assignChannelStrings(struct Channel * ch)
 	ch->chMenuDefaults[2] = &ch->opDef;
 	ch->chMenuDefaults[3] = &ch->opDef;
 	
-	ch->outputsMenuParams[0] = ch->out.output_settings[0].clkDivStr;
-	ch->outputsMenuParams[1] = ch->out.output_settings[0].clkPhaseStr;
-	ch->outputsMenuParams[2] = ch->out.output_settings[0].divRstStr;
-	ch->outputsMenuParams[3] = ch->out.output_settings[0].delayStr;
-	ch->outputsMenuParams[4] = ch->out.output_settings[0].probabilityStr;
-	ch->outputsMenuParams[5] = ch->out.output_settings[0].trigStr;
-	ch->outputsMenuParams[6] = ch->out.output_settings[0].trigLenStr;
-	ch->outputsMenuParams[7] = ch->out.out2Str;
-	ch->outputsMenuParams[8] = ch->out.output_settings[1].clkDivStr;
-	ch->outputsMenuParams[9] = ch->out.output_settings[1].clkPhaseStr;
-	ch->outputsMenuParams[10] = ch->out.output_settings[1].divRstStr;
-	ch->outputsMenuParams[11] = ch->out.output_settings[1].delayStr;
-	ch->outputsMenuParams[12] = ch->out.output_settings[1].probabilityStr;
-	ch->outputsMenuParams[13] = ch->out.output_settings[1].trigStr;
-	ch->outputsMenuParams[14] = ch->out.output_settings[1].trigLenStr;
-	
-	ch->outputsMenuDefaults[0] = &ch->out.output_settings[0].clkDivDef;
-	ch->outputsMenuDefaults[1] = &ch->out.output_settings[0].clkPhaseDef;
-	ch->outputsMenuDefaults[2] = &ch->out.output_settings[0].divRstDef;
-	ch->outputsMenuDefaults[3] = &ch->out.output_settings[0].delayDef;
-	ch->outputsMenuDefaults[4] = &ch->out.output_settings[0].probabilityDef;
-	ch->outputsMenuDefaults[5] = &ch->out.output_settings[0].trigDef;
-	ch->outputsMenuDefaults[6] = &ch->out.output_settings[0].trigLenDef;
-	ch->outputsMenuDefaults[7] = &ch->out.out2Def;
-	ch->outputsMenuDefaults[8] = &ch->out.output_settings[1].clkDivDef;
-	ch->outputsMenuDefaults[9] = &ch->out.output_settings[1].clkPhaseDef;
-	ch->outputsMenuDefaults[10] = &ch->out.output_settings[1].divRstDef;
-	ch->outputsMenuDefaults[11] = &ch->out.output_settings[1].delayDef;
-	ch->outputsMenuDefaults[12] = &ch->out.output_settings[1].probabilityDef;
-	ch->outputsMenuDefaults[13] = &ch->out.output_settings[1].trigDef;
-	ch->outputsMenuDefaults[14] = &ch->out.output_settings[1].trigLenDef;
+	ch->outputsMenuParams[0] = ch->out.output_display[0].clkMultStr;
+	ch->outputsMenuParams[1] = ch->out.output_display[0].clkDivStr;
+	ch->outputsMenuParams[2] = ch->out.output_display[0].clkPhaseStr;
+	ch->outputsMenuParams[3] = ch->out.output_display[0].divRstStr;
+	ch->outputsMenuParams[4] = ch->out.output_display[0].divDutyStr;
+	ch->outputsMenuParams[5] = ch->out.output_display[0].eucStepsStr;
+	ch->outputsMenuParams[6] = ch->out.output_display[0].eucFillsStr;
+	ch->outputsMenuParams[7] = ch->out.output_display[0].eucRotateStr;
+	ch->outputsMenuParams[8] = ch->out.output_display[0].delayStr;
+	ch->outputsMenuParams[9] = ch->out.output_display[0].probabilityStr;
+	ch->outputsMenuParams[10] = ch->out.output_display[0].probModeStr;
+	ch->outputsMenuParams[11] = ch->out.output_display[0].probLockStr;
+	ch->outputsMenuParams[12] = ch->out.output_display[0].probLengthStr;
+	ch->outputsMenuParams[13] = ch->out.output_display[0].burstCountStr;
+	ch->outputsMenuParams[14] = ch->out.output_display[0].burstIntervalStr;
+	ch->outputsMenuParams[15] = ch->out.output_display[0].trigStr;
+	ch->outputsMenuParams[16] = ch->out.output_display[0].trigLenStr;
+	ch->outputsMenuParams[17] = ch->out.out2Str;
+	ch->outputsMenuParams[18] = ch->out.output_display[1].clkMultStr;
+	ch->outputsMenuParams[19] = ch->out.output_display[1].clkDivStr;
+	ch->outputsMenuParams[20] = ch->out.output_display[1].clkPhaseStr;
+	ch->outputsMenuParams[21] = ch->out.output_display[1].divRstStr;
+	ch->outputsMenuParams[22] = ch->out.output_display[1].divDutyStr;
+	ch->outputsMenuParams[23] = ch->out.output_display[1].eucStepsStr;
+	ch->outputsMenuParams[24] = ch->out.output_display[1].eucFillsStr;
+	ch->outputsMenuParams[25] = ch->out.output_display[1].eucRotateStr;
+	ch->outputsMenuParams[26] = ch->out.output_display[1].delayStr;
+	ch->outputsMenuParams[27] = ch->out.output_display[1].probabilityStr;
+	ch->outputsMenuParams[28] = ch->out.output_display[1].probModeStr;
+	ch->outputsMenuParams[29] = ch->out.output_display[1].probLockStr;
+	ch->outputsMenuParams[30] = ch->out.output_display[1].probLengthStr;
+	ch->outputsMenuParams[31] = ch->out.output_display[1].burstCountStr;
+	ch->outputsMenuParams[32] = ch->out.output_display[1].burstIntervalStr;
+	ch->outputsMenuParams[33] = ch->out.output_display[1].trigStr;
+	ch->outputsMenuParams[34] = ch->out.output_display[1].trigLenStr;
+	
+	ch->outputsMenuDefaults[0] = &ch->out.output_display[0].clkMultDef;
+	ch->outputsMenuDefaults[1] = &ch->out.output_display[0].clkDivDef;
+	ch->outputsMenuDefaults[2] = &ch->out.output_display[0].clkPhaseDef;
+	ch->outputsMenuDefaults[3] = &ch->out.output_display[0].divRstDef;
+	ch->outputsMenuDefaults[4] = &ch->out.output_display[0].divDutyDef;
+	ch->outputsMenuDefaults[5] = &ch->out.output_display[0].eucStepsDef;
+	ch->outputsMenuDefaults[6] = &ch->out.output_display[0].eucFillsDef;
+	ch->outputsMenuDefaults[7] = &ch->out.output_display[0].eucRotateDef;
+	ch->outputsMenuDefaults[8] = &ch->out.output_display[0].delayDef;
+	ch->outputsMenuDefaults[9] = &ch->out.output_display[0].probabilityDef;
+	ch->outputsMenuDefaults[10] = &ch->out.output_display[0].probModeDef;
+	ch->outputsMenuDefaults[11] = &ch->out.output_display[0].probLockDef;
+	ch->outputsMenuDefaults[12] = &ch->out.output_display[0].probLengthDef;
+	ch->outputsMenuDefaults[13] = &ch->out.output_display[0].burstCountDef;
+	ch->outputsMenuDefaults[14] = &ch->out.output_display[0].burstIntervalDef;
+	ch->outputsMenuDefaults[15] = &ch->out.output_display[0].trigDef;
+	ch->outputsMenuDefaults[16] = &ch->out.output_display[0].trigLenDef;
+	ch->outputsMenuDefaults[17] = &ch->out.out2Def;
+	ch->outputsMenuDefaults[18] = &ch->out.output_display[1].clkMultDef;
+	ch->outputsMenuDefaults[19] = &ch->out.output_display[1].clkDivDef;
+	ch->outputsMenuDefaults[20] = &ch->out.output_display[1].clkPhaseDef;
+	ch->outputsMenuDefaults[21] = &ch->out.output_display[1].divRstDef;
+	ch->outputsMenuDefaults[22] = &ch->out.output_display[1].divDutyDef;
+	ch->outputsMenuDefaults[23] = &ch->out.output_display[1].eucStepsDef;
+	ch->outputsMenuDefaults[24] = &ch->out.output_display[1].eucFillsDef;
+	ch->outputsMenuDefaults[25] = &ch->out.output_display[1].eucRotateDef;
+	ch->outputsMenuDefaults[26] = &ch->out.output_display[1].delayDef;
+	ch->outputsMenuDefaults[27] = &ch->out.output_display[1].probabilityDef;
+	ch->outputsMenuDefaults[28] = &ch->out.output_display[1].probModeDef;
+	ch->outputsMenuDefaults[29] = &ch->out.output_display[1].probLockDef;
+	ch->outputsMenuDefaults[30] = &ch->out.output_display[1].probLengthDef;
+	ch->outputsMenuDefaults[31] = &ch->out.output_display[1].burstCountDef;
+	ch->outputsMenuDefaults[32] = &ch->out.output_display[1].burstIntervalDef;
+	ch->outputsMenuDefaults[33] = &ch->out.output_display[1].trigDef;
+	ch->outputsMenuDefaults[34] = &ch->out.output_display[1].trigLenDef;
 }
\ No newline at end of file
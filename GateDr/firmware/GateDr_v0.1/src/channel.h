@@ -8,22 +8,50 @@
 
 #include <stdbool.h>
 #include <stdint.h>
-#include <stdio.h>
 #include <string.h>		// for memcpy()
 #include "conf_menu.h"	// for parameter string max char limit
 #include "eeprom.h"		// for NVM reading/writing
+#include "nvmCommit.h"		// for deferred NVM writes
+#include "nvmPack.h"		// for NVM page format
 #include "inputs.h"
 #include "operations.h"
 #include "outputs.h"
 #include "cv.h"
 #include "paramUtils.h"
+#include "hotPath.h"
 
+/*
+ *	a copy of just the stored settings of a channel, without any processing
+ *	state other than the output loop registers, which are stored alongside 
+ *	them. used for the published settings read by processing, and to stage 
+ *	preset recalls
+*/
+struct ChannelSnapshot {
+	struct InputSettings input_settings[2];
+	bool copyIn1;
+	uint8_t op_select[2];
+	uint8_t op_cv[2];
+	struct OutputSettings output_settings[2];
+	uint8_t out2_settings;
+	uint32_t loop_reg[2];		// output probability loops, not read by processing
+	};
+
+/*
+ *	the settings within input, out and op_select/op_cv are the shadow copy, 
+ *	edited by the menu/NVM/preset code. processing only ever reads 'active',
+ *	which is published from the shadow copy at the start of a processing tick
+*/
 struct Channel {
 	struct Input input;
 	struct Output out;
 	uint8_t op_select[2];
 	uint8_t op_cv[2];
 	
+	struct ChannelSnapshot active;	// published settings used by processing
+	volatile uint8_t editSeq;		// bumped at the start & end of each shadow edit,
+									// odd while an edit is in progress
+	uint8_t publishedSeq;			// editSeq when 'active' was last published
+	
 	// previous CV conversion values used for hysteresis when under CV selection
 	uint8_t cv_op_prev[2];
 	
@@ -31,30 +59,48 @@ struct Channel {
 	char op2Str[GFX_MONO_MENU_PARAM_MAX_CHAR];
 	bool opDef;
 	
-	char *inputsMenuParams[7];		// stores pointers to param strings used by menu
-	bool *inputsMenuDefaults[7];		// stores 'default' state for inputs menu params used by menu.c
+	char *inputsMenuParams[21];		// stores pointers to param strings used by menu
+	bool *inputsMenuDefaults[21];		// stores 'default' state for inputs menu params used by menu.c
 	char *chMenuParams[4];			// includes blanks / '->' for submenus
 	bool *chMenuDefaults[4];
-	char *outputsMenuParams[15];
-	bool *outputsMenuDefaults[15];
+	char *outputsMenuParams[35];
+	bool *outputsMenuDefaults[35];
 	};
 
 // channel instance(s)
 struct Channel chan[2];
 
-void initChannel(struct Channel *ch, uint32_t *currentCount, uint8_t num);
+void initChannel(struct Channel *ch, uint32_t *currentCount, uint32_t *timebaseCount, uint8_t num);
 void setChannelDefaults(struct Channel *ch, uint8_t num);
-void processChannel(struct Channel *ch, int16_t in1, int16_t in2, struct Cv *cv);
+HOT_FUNC void processChannel(struct Channel *ch, int16_t in1, int16_t in2, struct Cv *cv);
+void beginChannelEdit(struct Channel *ch);
+void endChannelEdit(struct Channel *ch);
+void publishChannelSettings(struct Channel *ch);
 
 /*
- *	functions for UI callbacks during menu interactions
+ *	parameter descriptors for the channel level settings, relative to struct Channel
 */
-void updateOp(struct Channel *ch, bool i, bool inc);
+enum ChannelParams {
+	CHANNEL_PARAM_COPY_IN1,
+	CHANNEL_PARAM_OP_1,
+	CHANNEL_PARAM_OP_2,
+	CHANNEL_PARAM_OUT2,
+	CHANNEL_PARAM_COUNT
+	};
+
+extern const struct ParamDesc channelParams[CHANNEL_PARAM_COUNT];
 
 /*
  *	non-volatile memory storage and retrieval methods
 */
 void readChannelNVM(struct Channel *ch, uint8_t i);
 void writeChannelNVM(struct Channel *ch, uint8_t i);
+bool packChannelNVM(struct Channel *ch, uint8_t *buffer);
+void writeChannelLoops(struct Channel *ch, uint8_t i);
+void saveChannelLoops(struct Channel *ch, uint8_t i);
+void unpackChannelSnapshot(struct ChannelSnapshot *snapshot, struct NvmPacker *packer);
+void loadChannelSnapshot(struct Channel *ch, struct ChannelSnapshot *snapshot);
+void takeChannelSnapshot(struct Channel *ch, struct ChannelSnapshot *snapshot);
+void refreshChannelStrings(struct Channel *ch);
 
 #endif /* CHANNEL_H_ */
\ No newline at end of file
@@ -11,26 +11,32 @@
 #define CV_THRESH_INC		200
 #define CV_HYS				0.15f
 
+#define CV_FIELD(x)			offsetof(struct CvSettings, x)
+
 // declaration for static inline helper function
 static inline float getCvPercent(int16_t x, uint8_t range);
 
 // ADC ranges that correspond with the CvRange enums to help with CV conversions
-const int16_t adcRanges[4][2] = {{-8000,8000}, {0, 8000}, {-5000,5000}, {0,5000}};
+HOT_CONST const int16_t adcRanges[4][2] = {{-8000,8000}, {0, 8000}, {-5000,5000}, {0,5000}};
 	
 // strings to store enum parameters for display
 static const char *cvRangeStrings[] = {"+/-8V", "+8V", "+/-5V", "+5V"};
 
+const struct ParamDesc cvParams[CV_PARAM_COUNT] = {
+	[CV_PARAM_RANGE] =		{PARAM_UINT8, 0, BI_8, UNI_5, 1, CV_RANGE_DEFAULT,
+								NULL, cvRangeStrings, CV_FIELD(range), 0,
+								CV_FIELD(rangeStr), CV_FIELD(rangeDef)},
+	[CV_PARAM_THRESHOLD] =	{PARAM_INT16, 0, CV_THRESH_MIN, CV_THRESH_MAX, CV_THRESH_INC, CV_THRESH_DEFAULT,
+								"%dmV", NULL, CV_FIELD(threshold), 0,
+								CV_FIELD(thresholdStr), CV_FIELD(thresholdDef)}
+	};
+
 /*
  *	set all CV settings to their defaults
 */
 void setCvDefaults(struct Cv *cv) {
 	for(uint8_t i = 0; i < 2; i++) {
-		cv->settings[i].range =			CV_RANGE_DEFAULT;
-		cv->settings[i].threshold =		CV_THRESH_DEFAULT;
-		sprintf(cv->settings[i].rangeStr, "+5V");
-		sprintf(cv->settings[i].thresholdStr, "%d", CV_THRESH_DEFAULT);
-		cv->settings[i].rangeDef =		true;
-		cv->settings[i].thresholdDef =	true;
+		paramsSetDefaults(cvParams, CV_PARAM_COUNT, &cv->settings[i]);
 	}
 }
 
@@ -60,7 +66,7 @@ static inline float getCvPercent(int16_t x, uint8_t range) {
  *	determine the uint8_t value for a parameter for a given CV value and selection,
  *	as well as the low limit, high limit, and step size for the target parameter
 */
-uint8_t normalizeCvUint8(struct Cv *cv, uint8_t sel, uint8_t lowLimit, uint8_t highLimit, uint8_t prev) {
+HOT_FUNC uint8_t normalizeCvUint8(struct Cv *cv, uint8_t sel, uint8_t lowLimit, uint8_t highLimit, uint8_t prev) {
 	float percent;
 	float hys;
 	uint8_t targetValue;
@@ -86,7 +92,7 @@ uint8_t normalizeCvUint8(struct Cv *cv, uint8_t sel, uint8_t lowLimit, uint8_t h
  *	determine the uint16_t value for a parameter for a given CV value and selection,
  *	as well as the low limit, high limit, and step size for the target parameter
 */
-uint16_t normalizeCvUint16(struct Cv *cv, uint8_t sel, uint16_t lowLimit, uint16_t highLimit, uint16_t prev) {
+HOT_FUNC uint16_t normalizeCvUint16(struct Cv *cv, uint8_t sel, uint16_t lowLimit, uint16_t highLimit, uint16_t prev) {
 	float percent;
 	float hys;
 	uint16_t targetValue;
@@ -112,7 +118,7 @@ uint16_t normalizeCvUint16(struct Cv *cv, uint8_t sel, uint16_t lowLimit, uint16
  *	determine boolean value for a parameter given the current CV value and 
  *	threshold parameter
 */
-bool normalizeCvBool(struct Cv *cv, uint8_t sel, bool prev) {
+HOT_FUNC bool normalizeCvBool(struct Cv *cv, uint8_t sel, bool prev) {
 	int16_t thresh;
 	
 	thresh = cv->settings[sel-1].threshold;
@@ -128,60 +134,12 @@ bool normalizeCvBool(struct Cv *cv, uint8_t sel, bool prev) {
 }
 
 /*
- *	increment/decrement the CV range parameter & update
- *	the parameter string, used by menu functions
-*/
-void updateCvRange(struct CvSettings *settings, bool inc) {
-	if (inc) {
-		settings->range += 1;
-		if (settings->range > UNI_5) {	// overflow check
-			settings->range = BI_8;
-		}
-	}
-	else {	// decrementing
-		settings->range -= 1;
-		if (settings->range > UNI_5) {	// underflow check for uint8_t
-			settings->range = UNI_5;
-		}
-	}
-	
-	sprintf(settings->rangeStr, "%s", cvRangeStrings[settings->range]);
-	
-	settings->rangeDef = (settings->range == CV_RANGE_DEFAULT);
-}
-
-/*
- *	increment/decrement the CV threshold parameter & update
- *	the parameter string, used by menu functions
+ *	migrate a CV input's settings from the 3 byte legacy (v0) layout:
+ *	1.range 2.threshold (2 bytes)
 */
-void updateCvThreshold(struct CvSettings *settings, bool inc) {
-	if (inc) {
-		settings->threshold += CV_THRESH_INC;
-		if (settings->threshold > CV_THRESH_MAX) {	// overflow check
-			settings->threshold = CV_THRESH_MIN;
-		}
-	}
-	else {	// decrementing
-		settings->threshold -= CV_THRESH_INC;
-		if (settings->threshold < CV_THRESH_MIN) {	// underflow check
-			settings->threshold = CV_THRESH_MAX;
-		}
-	}
+void unpackCvSettingsLegacy(struct CvSettings *settings, const uint8_t *buffer) {
+	int16_t thresh = (int16_t)((buffer[1] << 8) | buffer[2]);
 	
-	sprintf(settings->thresholdStr, "%dmV", settings->threshold);
-	
-	settings->thresholdDef = (settings->threshold == CV_THRESH_DEFAULT);
-}
-
-/*
- *	sets isDefault states for all settings within an Output struct
-*/
-void readCVDefaultStates(struct Cv *cv) {
-	for (uint8_t i=0; i<2; i++) {
-		// CV range
-		cv->settings[i].rangeDef = (cv->settings[i].range == CV_RANGE_DEFAULT);
-		
-		// CV threshold
-		cv->settings[i].thresholdDef = (cv->settings[i].threshold == CV_THRESH_DEFAULT);
-	}
+	settings->range =		nvmValidateField(buffer[0], BI_8, UNI_5, CV_RANGE_DEFAULT);
+	settings->threshold =	nvmValidateField(thresh, CV_THRESH_MIN, CV_THRESH_MAX, CV_THRESH_DEFAULT);
 }
\ No newline at end of file
@@ -8,8 +8,10 @@
 
 #include <stdbool.h>
 #include <stdint.h>
-#include <stdio.h>
 #include "conf_menu.h"	// for parameter string max char limit
+#include "nvmPack.h"
+#include "paramUtils.h"
+#include "hotPath.h"
 
 enum CvSel {
 	CV_NONE,
@@ -48,19 +50,24 @@ struct Cv {
 struct Cv cv_instance;
 
 void setCvDefaults(struct Cv *cv);
-uint8_t normalizeCvUint8(struct Cv *cv, uint8_t sel, uint8_t lowLimit, uint8_t highLimit, uint8_t prev);
-uint16_t normalizeCvUint16(struct Cv *cv, uint8_t sel, uint16_t lowLimit, uint16_t highLimit, uint16_t prev);
-bool normalizeCvBool(struct Cv *cv, uint8_t sel, bool prev);
+HOT_FUNC uint8_t normalizeCvUint8(struct Cv *cv, uint8_t sel, uint8_t lowLimit, uint8_t highLimit, uint8_t prev);
+HOT_FUNC uint16_t normalizeCvUint16(struct Cv *cv, uint8_t sel, uint16_t lowLimit, uint16_t highLimit, uint16_t prev);
+HOT_FUNC bool normalizeCvBool(struct Cv *cv, uint8_t sel, bool prev);
 
 /*
- *	functions for UI callbacks during menu interactions
+ *	parameter descriptors for CvSettings, in NVM packing order
 */
-void updateCvRange(struct CvSettings *settings, bool inc);
-void updateCvThreshold(struct CvSettings *settings, bool inc);
+enum CvParams {
+	CV_PARAM_RANGE,
+	CV_PARAM_THRESHOLD,
+	CV_PARAM_COUNT
+	};
+
+extern const struct ParamDesc cvParams[CV_PARAM_COUNT];
 
 /*
- *	used after NVM read to set rangeDef, thresholdDef, etc
+ *	migrate settings from a legacy (v0) NVM page, with per-field range checks
 */
-void readCVDefaultStates(struct Cv *cv);
+void unpackCvSettingsLegacy(struct CvSettings *settings, const uint8_t *buffer);
 
 #endif /* CV_H_ */
\ No newline at end of file
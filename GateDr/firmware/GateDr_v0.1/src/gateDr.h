@@ -15,6 +15,11 @@
 #include "ui.h"
 #include "menu.h"
 #include "globalSettings.h"
+#include "nvmCommit.h"
+#include "preset.h"
+#include "timebase.h"
+#include "outputTimer.h"
+#include "masterClock.h"
 
 
 #endif /* GATEDR_H_ */
\ No newline at end of file
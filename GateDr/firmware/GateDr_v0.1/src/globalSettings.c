@@ -3,39 +3,55 @@
  */ 
 
 #include "globalSettings.h"
+#include "textFormat.h"
 
 #define LONG_PRESS_COUNT_DEFAULT	LONG_PRESS_MED
 #define	SCREENSAVER_DEFAULT			SCREENSAVER_5MIN
 
-// byte sizes for packing/unpacking data to/from NVM
-#define SIZE_CV		3
-#define SIZE_GLOBAL	2
+// byte size for unpacking CV data from legacy (v0) NVM pages
+#define LEGACY_SIZE_CV	3
+
+#define GLOBAL_FIELD(x)	offsetof(struct GlobalSettings, x)
 
 const char *chResetStrings[] = {"None", "CH1", "CH2", "ALL"};
 const char *longPressStrings[] = {"Short", "Med", "Long"};
 const char *screenSaverTimeStrings[] = {"5mins", "15mins", "Off"};
+const char *presetSlotStrings[] = {"--", "1", "2", "3"};		// corresponds to PRESET_NONE + slots
+const char *presetCvStrings[] = {"Off", "CV1", "CV2"};		// corresponds to CvSel enum
 char globalSubmenuStr[3] = "->";	// parameter display 'value' for submenu
-static const char *cvRangeStrings[] = {"+/-8V", "+8V", "+/-5V", "+5V"};
+
+const struct ParamDesc globalParams[GLOBAL_PARAM_COUNT] = {
+	[GLOBAL_PARAM_RESET] =			{PARAM_UINT8, PARAM_FLAG_NO_DEF, RESET_NONE, RESET_ALL, 1, RESET_NONE,
+										NULL, chResetStrings, GLOBAL_FIELD(chReset), 0, GLOBAL_FIELD(chResetStr), 0},
+	[GLOBAL_PARAM_LONG_PRESS] =		{PARAM_UINT8, PARAM_FLAG_NO_DEF, LONG_PRESS_SHORT, LONG_PRESS_LONG, 1, LONG_PRESS_COUNT_DEFAULT,
+										NULL, longPressStrings, GLOBAL_FIELD(longPressTime), 0, GLOBAL_FIELD(longPressTimeStr), 0},
+	[GLOBAL_PARAM_SCREENSAVER] =	{PARAM_UINT8, PARAM_FLAG_NO_DEF, SCREENSAVER_5MIN, SCREENSAVER_OFF, 1, SCREENSAVER_DEFAULT,
+										NULL, screenSaverTimeStrings, GLOBAL_FIELD(screenSaverTime), 0, GLOBAL_FIELD(screenSaverTimeStr), 0},
+	[GLOBAL_PARAM_PRESET_SAVE] =	{PARAM_UINT8, PARAM_FLAG_NO_DEF, PRESET_NONE, NVM_PRESET_COUNT, 1, PRESET_NONE,
+										NULL, presetSlotStrings, GLOBAL_FIELD(presetSave), 0, GLOBAL_FIELD(presetSaveStr), 0},
+	[GLOBAL_PARAM_PRESET_RECALL] =	{PARAM_UINT8, PARAM_FLAG_NO_DEF, PRESET_NONE, NVM_PRESET_COUNT, 1, PRESET_NONE,
+										NULL, presetSlotStrings, GLOBAL_FIELD(presetRecall), 0, GLOBAL_FIELD(presetRecallStr), 0},
+	[GLOBAL_PARAM_PRESET_CV] =		{PARAM_UINT8, PARAM_FLAG_NO_DEF, CV_NONE, CV2, 1, CV_NONE,
+										NULL, presetCvStrings, GLOBAL_FIELD(presetCv), 0, GLOBAL_FIELD(presetCvStr), 0}
+	};
 
 // helper function declaration
-static inline void readGlobalDefaultStates(struct GlobalSettings *global, struct Cv *cv);
 static inline void assignGlobalStrings(struct GlobalSettings *global, struct Cv *cv);
 
 /*
  *	set all global settings defaults
 */
 void setGlobalSettingsDefaults(struct GlobalSettings *settings, struct Cv *cv) {
-	settings->chReset =			RESET_NONE;
-	settings->longPressTime =	LONG_PRESS_COUNT_DEFAULT;
-	settings->screenSaverTime = SCREENSAVER_DEFAULT;
+	paramsSetDefaults(globalParams, GLOBAL_PARAM_COUNT, settings);
 	settings->globalDef =		true;
 	
 	// write the default long press time to the UI struct instance
 	writeLongPressTimes(settings->longPressTime);
 	
-	// since CV settings are paired in NVM with the global settings, we'll 
-	// also initialize them here
+	// since CV & master clock settings are paired in NVM with the global 
+	// settings, we'll also initialize them here
 	setCvDefaults(cv);
+	setMasterClockDefaults(&masterClock.settings);
 	
 	writeGlobalStrings(settings, cv);
 	assignGlobalStrings(settings, cv);
@@ -45,143 +61,153 @@ void setGlobalSettingsDefaults(struct GlobalSettings *settings, struct Cv *cv) {
 }
 
 /*
- *	increment/decrement the current channel reset value
+ *	read the global and CV settings stored in non-volatile memory, validate
+ *	and unpack into their respective working memory structs. legacy pages
+ *	are migrated & rewritten in the current format, and a corrupted page 
+ *	falls back to the defaults
 */
-void updateChReset(struct GlobalSettings *settings, bool inc) {
-	if (inc) {
-		settings->chReset += 1;
-		if (settings->chReset > RESET_ALL) {	// overflow check
-			settings->chReset = RESET_NONE;
-		}
-	}
-	else {	// decrementing
-		settings->chReset -= 1;
-		if (settings->chReset > RESET_ALL) {	// underflow check for uint8_t
-			settings->chReset = RESET_ALL;
-		}
-	}
+void readGlobalSettingsNVM(struct GlobalSettings *global, struct Cv *cv) {
+	uint8_t buffer[EEPROM_PAGE_SIZE];
+	uint8_t version;
+	struct NvmPacker packer;
+	struct GlobalSnapshot snapshot;
+	uint8_t i;
 	
-	sprintf(settings->chResetStr, chResetStrings[settings->chReset]);
-}
-
-/*
- *	increment/decrement the current long press time, using the
- *	times defined in ui.h
-*/
-void updateLongPressTime(struct GlobalSettings *settings, bool inc) {
-	if (inc) {
-		settings->longPressTime += 1;
-		if (settings->longPressTime > LONG_PRESS_LONG) {	// overflow check
-			settings->longPressTime = LONG_PRESS_SHORT;
-		}
-	}
-	else {	// decrementing
-		settings->longPressTime -= 1;
-		if (settings->longPressTime > LONG_PRESS_LONG) {	// underflow check for uint8_t
-			settings->longPressTime = LONG_PRESS_LONG;
-		}
+	eeprom_emulator_read_page(2, buffer);
+	nvmCacheLoadPage(2, buffer);
+	
+	switch (nvmCheckPage(buffer, &version)) {
+		case NVM_PAGE_VALID:
+			nvmPackInit(&packer, buffer);
+			unpackGlobalSnapshot(&snapshot, &packer);
+			loadGlobalSnapshot(global, cv, &snapshot);
+			
+			// preset recall CV (schema v2), reads back as CV_NONE from a v1 page
+			global->presetCv = snapshot.presetCv;
+			
+			// master clock (schema v8), an older page would read back the slowest tempo
+			if (version < 8) {
+				setMasterClockDefaults(&masterClock.settings);
+			}
+			break;
+		case NVM_PAGE_LEGACY:
+			// CV settings x2, 3 bytes each
+			for (i=0; i<2; i++) {
+				unpackCvSettingsLegacy(&cv->settings[i], &buffer[i*LEGACY_SIZE_CV]);
+			}
+			
+			// Global settings
+			global->longPressTime = nvmValidateField(buffer[6], LONG_PRESS_SHORT, LONG_PRESS_LONG, LONG_PRESS_COUNT_DEFAULT);
+			global->screenSaverTime = nvmValidateField(buffer[7], SCREENSAVER_5MIN, SCREENSAVER_OFF, SCREENSAVER_DEFAULT);
+			global->presetCv = CV_NONE;
+			setMasterClockDefaults(&masterClock.settings);
+			
+			writeGlobalSettingsNVM(global, cv);
+			break;
+		case NVM_PAGE_CORRUPT:
+			setGlobalSettingsDefaults(global, cv);
+			break;
 	}
 	
-	writeLongPressTimes(settings->longPressTime);
+	global->chReset = RESET_NONE;
+	global->presetSave = PRESET_NONE;
+	global->presetRecall = PRESET_NONE;
 	
-	sprintf(settings->longPressTimeStr, longPressStrings[settings->longPressTime]);
-}
-
-/*
- *	increment/decrement the current screen saver time
-*/
-void updateScreenSaverTime(struct GlobalSettings *settings, bool inc) {
-	if (inc) {
-		settings->screenSaverTime += 1;
-		if (settings->screenSaverTime > SCREENSAVER_OFF) {
-			settings->screenSaverTime = SCREENSAVER_5MIN;
-		}
-	}
-	else {	// decrementing
-		settings->screenSaverTime -= 1;
-		if (settings->screenSaverTime > SCREENSAVER_OFF) {
-			settings->screenSaverTime = SCREENSAVER_OFF;
-		}
-	}
+	global->globalDef = true;
 	
-	sprintf(settings->screenSaverTimeStr, screenSaverTimeStrings[settings->screenSaverTime]);
+	writeGlobalStrings(global, cv);
+	assignGlobalStrings(global, cv);
 }
 
 /*
- *	read the global and CV settings stored in non-volatile memory, and 
- *	unpack into their respective working memory structs
+ *	pack up a GlobalSettings, 2 CvSettings & the master clock settings and queue
+ *	them for writing to non-volatile memory. Will always write to logical page 3 of NVM
 */
-void readGlobalSettingsNVM(struct GlobalSettings *global, struct Cv *cv) {
-	uint8_t buffer[EEPROM_PAGE_SIZE];
+void writeGlobalSettingsNVM(struct GlobalSettings *global, struct Cv *cv) {
+	uint8_t buffer[EEPROM_PAGE_SIZE] = {0};
+	struct NvmPacker packer;
 	uint8_t i;
 	
-	eeprom_emulator_read_page(2, buffer);
+	nvmPackInit(&packer, buffer);
 
 	// CV settings x2
 	for (i=0; i<2; i++) {
-		uint16_t temp = 0;
-		cv->settings[i].range = buffer[i*3];
-		temp += buffer[(i*3)+1] << 8;
-		temp += buffer[(i*3)+2]; 
-		cv->settings[i].threshold = temp;
+		paramsPack(cvParams, CV_PARAM_COUNT, &cv->settings[i], &packer);
 	}
 	
 	// Global settings
-	global->longPressTime = buffer[6];
-	global->screenSaverTime = buffer[7];
+	paramPack(&globalParams[GLOBAL_PARAM_LONG_PRESS], global, &packer);
+	paramPack(&globalParams[GLOBAL_PARAM_SCREENSAVER], global, &packer);
+	paramPack(&globalParams[GLOBAL_PARAM_PRESET_CV], global, &packer);
 	
-	writeGlobalStrings(global, cv);
-	readGlobalDefaultStates(global, cv);
-	assignGlobalStrings(global, cv);
+	// master clock settings
+	paramsPack(clockParams, CLOCK_PARAM_COUNT, &masterClock.settings, &packer);
+	
+	nvmSealPage(buffer);
+	nvmCacheWritePage(2, buffer);
 }
 
 /*
- *	pack up a GlobalSettings and 2 CvSettings structs and write them to 
- *	non-volatile memory. Will always write to logical page 3 of NVM
+ *	unpack the global, CV & master clock settings from a validated NVM page, in
+ *	the same order they're packed by writeGlobalSettingsNVM()
 */
-void writeGlobalSettingsNVM(struct GlobalSettings *global, struct Cv *cv) {
-	uint8_t buffer[EEPROM_PAGE_SIZE] = {0};
-	uint8_t i;
-
+void unpackGlobalSnapshot(struct GlobalSnapshot *snapshot, struct NvmPacker *packer) {
 	// CV settings x2
-	for (i=0; i<2; i++) {
-		buffer[i*3] = cv->settings[i].range;
-		buffer[(i*3)+1] = (uint8_t)((cv->settings[i].threshold >> 8) & 0xFF);
-		buffer[(i*3)+2] = (uint8_t)((cv->settings[i].threshold) & 0xFF);
+	for (uint8_t i=0; i<2; i++) {
+		paramsUnpack(cvParams, CV_PARAM_COUNT, &snapshot->cv[i], packer);
 	}
 	
 	// Global settings
-	buffer[6] = global->longPressTime;
-	buffer[7] = global->screenSaverTime;
+	snapshot->longPressTime = paramUnpackValue(&globalParams[GLOBAL_PARAM_LONG_PRESS], packer);
+	snapshot->screenSaverTime = paramUnpackValue(&globalParams[GLOBAL_PARAM_SCREENSAVER], packer);
+	snapshot->presetCv = paramUnpackValue(&globalParams[GLOBAL_PARAM_PRESET_CV], packer);
 	
-	eeprom_emulator_write_page(2, buffer);
+	// master clock settings
+	paramsUnpack(clockParams, CLOCK_PARAM_COUNT, &snapshot->clock, packer);
 }
 
 /*
- *	write the CV and global settings strings based on the currently
+ *	copy a snapshot's settings into the global, CV & master clock settings,
+ *	display strings are left for writeGlobalStrings() outside of the processing
+ *	path. the clock's tempo & swing are picked up by masterClockUpdate() later
+ *	in the same tick
+*/
+void loadGlobalSnapshot(struct GlobalSettings *global, struct Cv *cv, struct GlobalSnapshot *snapshot) {
+	cv->settings[0] = snapshot->cv[0];
+	cv->settings[1] = snapshot->cv[1];
+	global->longPressTime = snapshot->longPressTime;
+	global->screenSaverTime = snapshot->screenSaverTime;
+	masterClock.settings = snapshot->clock;
+	
+	writeLongPressTimes(global->longPressTime);
+}
+
+/*
+ *	write the CV and global settings strings & default states based on the currently
  *	loaded values
 */
 void writeGlobalStrings(struct GlobalSettings *global, struct Cv *cv) {
 	// CV settings
 	for (uint8_t i=0; i<2; i++) {
-		sprintf(cv->settings[i].rangeStr, cvRangeStrings[cv->settings[i].range]);
-		sprintf(cv->settings[i].thresholdStr, "%dmV", cv->settings[i].threshold);
+		paramsRender(cvParams, CV_PARAM_COUNT, &cv->settings[i], &cv->settings[i]);
 	}
 	
 	// Global settings
-	sprintf(global->chResetStr, chResetStrings[global->chReset]);
-	sprintf(global->longPressTimeStr, longPressStrings[global->longPressTime]);
-	sprintf(global->screenSaverTimeStr, screenSaverTimeStrings[global->screenSaverTime]);
+	paramsRender(globalParams, GLOBAL_PARAM_COUNT, global, global);
+	paramsRender(clockParams, CLOCK_PARAM_COUNT, &masterClock.settings, &masterClock.settings);
 }
 
 /*
- *	write the CV and global settings default states based on the currently
- *	loaded values
+ *	write the measured time from power-up to the first processed outputs (in ms)
+ *	for display in the global menu
 */
-static inline void readGlobalDefaultStates(struct GlobalSettings *global, struct Cv *cv) {
-	global->globalDef = true;
+void writeBootTime(struct GlobalSettings *global, uint32_t time) {
+	// keep within the parameter string length
+	if (time > 99999) {
+		time = 99999;
+	}
 	
-	readCVDefaultStates(cv);
+	textFormatInt(global->bootTimeStr, GFX_MONO_MENU_PARAM_MAX_CHAR, "%dms", (int32_t)time);
 }
 
 /*
@@ -195,6 +221,12 @@ static inline void assignGlobalStrings(struct GlobalSettings *global, struct Cv
 	global->globalSettingsParams[3] = global->chResetStr;
 	global->globalSettingsParams[4] = global->longPressTimeStr;
 	global->globalSettingsParams[5] = global->screenSaverTimeStr;
+	global->globalSettingsParams[6] = global->presetSaveStr;
+	global->globalSettingsParams[7] = global->presetRecallStr;
+	global->globalSettingsParams[8] = global->presetCvStr;
+	global->globalSettingsParams[9] = masterClock.settings.bpmStr;
+	global->globalSettingsParams[10] = masterClock.settings.swingStr;
+	global->globalSettingsParams[11] = global->bootTimeStr;
 	
 	global->globalSettingsDefaults[0] = &global->globalDef;
 	global->globalSettingsDefaults[1] = &global->globalDef;
@@ -202,6 +234,12 @@ static inline void assignGlobalStrings(struct GlobalSettings *global, struct Cv
 	global->globalSettingsDefaults[3] = &global->globalDef;
 	global->globalSettingsDefaults[4] = &global->globalDef;
 	global->globalSettingsDefaults[5] = &global->globalDef;
+	global->globalSettingsDefaults[6] = &global->globalDef;
+	global->globalSettingsDefaults[7] = &global->globalDef;
+	global->globalSettingsDefaults[8] = &global->globalDef;
+	global->globalSettingsDefaults[9] = &masterClock.settings.bpmDef;
+	global->globalSettingsDefaults[10] = &masterClock.settings.swingDef;
+	global->globalSettingsDefaults[11] = &global->globalDef;
 	
 	// CV settings
 	cv->cvParams[0] = cv->settings[0].rangeStr;
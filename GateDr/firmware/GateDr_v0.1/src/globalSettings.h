@@ -11,11 +11,13 @@
 
 #include <stdbool.h>
 #include <stdint.h>
-#include <stdio.h>
 #include <string.h>
 #include "conf_menu.h"	// for parameter string max char limit
 #include "cv.h"
+#include "masterClock.h"
 #include "eeprom.h"
+#include "nvmCommit.h"
+#include "nvmPack.h"
 #include "ui.h"
 #include "sysfont.h"
 
@@ -32,33 +34,70 @@ enum ScreenSaverTime {
 	SCREENSAVER_OFF
 	};
 
+// preset slot selection for save/recall, slots are numbered from 1
+#define PRESET_NONE	0
+
 struct GlobalSettings {
 	uint8_t chReset;			// holds current display when selecting a channel to reset
 	uint8_t longPressTime;		// holds current long press count time based on enum
 	uint8_t screenSaverTime;	// holds current screen saver timeout value
+	uint8_t presetSave;			// holds current display when selecting a preset slot to save to
+	uint8_t presetRecall;		// holds current display when selecting a preset slot to recall
+	uint8_t presetCv;			// CV input selecting the preset to recall, per CvSel enum
 	
 	char chResetStr[GFX_MONO_MENU_PARAM_MAX_CHAR];
 	char longPressTimeStr[GFX_MONO_MENU_PARAM_MAX_CHAR];
 	char screenSaverTimeStr[GFX_MONO_MENU_PARAM_MAX_CHAR];
+	char presetSaveStr[GFX_MONO_MENU_PARAM_MAX_CHAR];
+	char presetRecallStr[GFX_MONO_MENU_PARAM_MAX_CHAR];
+	char presetCvStr[GFX_MONO_MENU_PARAM_MAX_CHAR];
+	char bootTimeStr[GFX_MONO_MENU_PARAM_MAX_CHAR];	// time from power-up to first output, display only
 	bool globalDef;
 	
-	char *globalSettingsParams[6];	// stores pointers to param strings used by UI
-	bool *globalSettingsDefaults[6]; // stores 'default' states for params, used by menu.c
+	char *globalSettingsParams[12];		// stores pointers to param strings used by UI
+	bool *globalSettingsDefaults[12];	// stores 'default' states for params, used by menu.c
+	};
+
+/*
+ *	a copy of just the global, CV & master clock settings that make up a preset,
+ *	used to stage preset recalls
+*/
+struct GlobalSnapshot {
+	struct CvSettings cv[2];
+	uint8_t longPressTime;
+	uint8_t screenSaverTime;
+	uint8_t presetCv;			// read back at boot, a recall keeps the live selection
+	struct MasterClockSettings clock;
 	};
 
 struct GlobalSettings globalSettings;
 
-void setGlobalSettingsDefaults(struct GlobalSettings *settings, struct Cv *cv);
+/*
+ *	parameter descriptors for GlobalSettings. the global menu selections (reset, 
+ *	preset save/recall) aren't stored, and there's no 'default' display state
+*/
+enum GlobalParams {
+	GLOBAL_PARAM_RESET,
+	GLOBAL_PARAM_LONG_PRESS,
+	GLOBAL_PARAM_SCREENSAVER,
+	GLOBAL_PARAM_PRESET_SAVE,
+	GLOBAL_PARAM_PRESET_RECALL,
+	GLOBAL_PARAM_PRESET_CV,
+	GLOBAL_PARAM_COUNT
+	};
 
-void updateChReset(struct GlobalSettings *settings, bool inc);
-void updateLongPressTime(struct GlobalSettings *settings, bool inc);
-void updateScreenSaverTime(struct GlobalSettings *settings, bool inc);
+extern const struct ParamDesc globalParams[GLOBAL_PARAM_COUNT];
+
+void setGlobalSettingsDefaults(struct GlobalSettings *settings, struct Cv *cv);
 void writeGlobalStrings(struct GlobalSettings *global, struct Cv *cv); 
+void writeBootTime(struct GlobalSettings *global, uint32_t time);
 
 /*
  *	non-volatile memory storage and retrieval methods
 */
 void readGlobalSettingsNVM(struct GlobalSettings *settings, struct Cv *cv);
 void writeGlobalSettingsNVM(struct GlobalSettings *settings, struct Cv *cv);
+void unpackGlobalSnapshot(struct GlobalSnapshot *snapshot, struct NvmPacker *packer);
+void loadGlobalSnapshot(struct GlobalSettings *global, struct Cv *cv, struct GlobalSnapshot *snapshot);
 
 #endif /* GLOBALSETTINGS_H_ */
\ No newline at end of file
@@ -0,0 +1,37 @@
+/*
+ *	placement of the per-tick processing path (inputs, operations, outputs and
+ *	the CV helpers they call)
+ *
+ *	the core runs from DFLL48M, so every instruction fetched from flash pays a
+ *	wait state and the M0+ has no cache to hide it. built with -DHOT_PATH_RAM=1
+ *	these functions and the const tables they index are linked into the
+ *	.ramfunc section, which Reset_Handler copies into SRAM along with .data
+ *
+ *	off by default: the gain hasn't been measured on hardware (QEMU doesn't
+ *	model wait states, see tools/m0bench) and the code takes several KB of the
+ *	16KB SRAM, which the framebuffers, channels & stack already mostly fill.
+ *	check the RAM total in the build's memory report before turning it on
+ *
+ *	calls into RAM are out of range of a thumb BL from flash, so hot functions
+ *	are long_call and their prototypes must carry HOT_FUNC as well. library
+ *	calls made from the hot path (rand(), float & division helpers) stay in
+ *	flash and are reached through linker veneers
+ */ 
+
+
+#ifndef HOTPATH_H_
+#define HOTPATH_H_
+
+#ifndef HOT_PATH_RAM
+#define HOT_PATH_RAM	0
+#endif
+
+#if HOT_PATH_RAM && defined(__arm__)
+#define HOT_FUNC		__attribute__((section(".ramfunc.hot"), long_call))
+#define HOT_CONST		__attribute__((section(".ramfunc.hotconst")))
+#else
+#define HOT_FUNC
+#define HOT_CONST
+#endif
+
+#endif /* HOTPATH_H_ */
\ No newline at end of file
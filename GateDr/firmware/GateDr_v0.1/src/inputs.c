@@ -3,6 +3,7 @@
  */ 
 
 #include "inputs.h"
+#include "timebase.h"
 
 #define THRESH_DEFAULT		1000
 #define THRESH_MIN			-8000
@@ -13,23 +14,100 @@
 #define HYS_MIN				0
 #define HYS_MAX				50
 #define HYS_INC				1
+#define SOURCE_DEFAULT		INPUT_SOURCE_JACK
+#define FILTER_DEFAULT		0
+#define FILTER_MIN			0
+#define FILTER_MAX			100
+#define FILTER_INC			1
+// timebase counts per filter increment (100us)
+#define FILTER_COUNTS		(TIMEBASE_HZ / 10000)
+#define MODE_DEFAULT		INPUT_MODE_LEVEL
+#define WIN_SIZE_DEFAULT	200
+#define WIN_SIZE_MIN		200
+#define WIN_SIZE_MAX		16000
+#define WIN_SIZE_INC		200
+#define WIN_OUT_DEFAULT		WINDOW_OUT_INSIDE
+#define SLOPE_DEFAULT		SLOPE_OFF
+#define SLOPE_LEN_DEFAULT	1
+#define SLOPE_LEN_MIN		1
+#define SLOPE_LEN_MAX		(SLOPE_RING / 2)
+#define SLOPE_LEN_INC		1
+// timebase counts per slope sample (1ms), & ms the slope is scaled to
+#define SLOPE_SAMPLE_COUNTS	TIMEBASE_PER_MS
+#define SLOPE_SCALE_MS		100
+// fraction bits of the slope scale, as many as a window-half of 1 leaves room
+// for: 16000mV * (100 << 10) still fits an int32
+#define SLOPE_SCALE_SHIFT	10
+// virtual input levels for the master clock, clear of the default threshold
+#define CLOCK_HIGH_MV		5000
+#define CLOCK_LOW_MV		0
+
+#define INPUT_FIELD(x)		offsetof(struct InputSettings, x)
+#define INPUT_DISPLAY(x)	offsetof(struct InputDisplay, x)
+
+// window zones, numbered upwards
+enum WindowZones {
+	ZONE_BELOW,
+	ZONE_INSIDE,
+	ZONE_ABOVE
+	};
+
+// declaration for static inline helper functions
+static inline void setInputTrips(struct InputState *state, int16_t thresh, uint8_t hys, uint16_t win);
+static inline void updateInputCv(struct InputSettings *settings, struct InputState *state, struct Cv *cv);
+static inline void processWindow(struct InputState *state, int16_t in_raw);
+static inline void processSlope(struct InputState *state, int16_t in_raw, uint32_t timebaseCount);
+static inline void pushSlopeSample(struct InputState *state, int16_t in_raw);
+static inline void fillSlopeRing(struct InputState *state, int16_t in_raw);
+static inline int32_t scaleSlope(int32_t diff, uint32_t scale);
+
+// strings to store enum parameters for display
+static const char *invertStrings[] = {"false", "true"};
+static const char *sourceStrings[] = {"jack", "clock"};
+static const char *modeStrings[] = {"level", "window"};
+static const char *winOutStrings[] = {"inside", "above", "below"};
+static const char *slopeStrings[] = {"off", "rise", "fall", "peak", "trough"};
+// zone the input is high for, corresponds to WindowOutOptions enum
+static const uint8_t winOutZones[] = {ZONE_INSIDE, ZONE_ABOVE, ZONE_BELOW};
+
+const struct ParamDesc inputParams[INPUT_PARAM_COUNT] = {
+	[INPUT_PARAM_THRESHOLD] =	{PARAM_INT16, PARAM_FLAG_CV, THRESH_MIN, THRESH_MAX, THRESH_INC, THRESH_DEFAULT, 
+									"%dmV", NULL, INPUT_FIELD(threshold), INPUT_FIELD(thresholdCv), 
+									INPUT_DISPLAY(thresholdStr), INPUT_DISPLAY(thresholdDef)},
+	[INPUT_PARAM_INVERT] =		{PARAM_UINT8, PARAM_FLAG_CV, false, true, 1, DEFAULT_INVERT,
+									NULL, invertStrings, INPUT_FIELD(invert), INPUT_FIELD(invertCv),
+									INPUT_DISPLAY(invertStr), INPUT_DISPLAY(invertDef)},
+	[INPUT_PARAM_HYS] =		{PARAM_UINT8, PARAM_FLAG_CV, HYS_MIN, HYS_MAX, HYS_INC, HYS_DEFAULT,
+									"%d0mV", NULL, INPUT_FIELD(hysteresis), INPUT_FIELD(hysCv),
+									INPUT_DISPLAY(hysStr), INPUT_DISPLAY(hysDef)},
+	[INPUT_PARAM_SOURCE] =		{PARAM_UINT8, 0, INPUT_SOURCE_JACK, INPUT_SOURCE_CLOCK, 1, SOURCE_DEFAULT,
+									NULL, sourceStrings, INPUT_FIELD(source), 0,
+									INPUT_DISPLAY(sourceStr), INPUT_DISPLAY(sourceDef)},
+	[INPUT_PARAM_FILTER] =		{PARAM_UINT8, 0, FILTER_MIN, FILTER_MAX, FILTER_INC, FILTER_DEFAULT,
+									"%d00us", NULL, INPUT_FIELD(filter), 0,
+									INPUT_DISPLAY(filterStr), INPUT_DISPLAY(filterDef)},
+	[INPUT_PARAM_MODE] =		{PARAM_UINT8, 0, INPUT_MODE_LEVEL, INPUT_MODE_WINDOW, 1, MODE_DEFAULT,
+									NULL, modeStrings, INPUT_FIELD(mode), 0,
+									INPUT_DISPLAY(modeStr), INPUT_DISPLAY(modeDef)},
+	[INPUT_PARAM_WIN_SIZE] =	{PARAM_UINT16, PARAM_FLAG_CV, WIN_SIZE_MIN, WIN_SIZE_MAX, WIN_SIZE_INC, WIN_SIZE_DEFAULT,
+									"%dmV", NULL, INPUT_FIELD(winSize), INPUT_FIELD(winSizeCv),
+									INPUT_DISPLAY(winSizeStr), INPUT_DISPLAY(winSizeDef)},
+	[INPUT_PARAM_WIN_OUT] =	{PARAM_UINT8, 0, WINDOW_OUT_INSIDE, WINDOW_OUT_BELOW, 1, WIN_OUT_DEFAULT,
+									NULL, winOutStrings, INPUT_FIELD(winOut), 0,
+									INPUT_DISPLAY(winOutStr), INPUT_DISPLAY(winOutDef)},
+	[INPUT_PARAM_SLOPE] =		{PARAM_UINT8, 0, SLOPE_OFF, SLOPE_TROUGH, 1, SLOPE_DEFAULT,
+									NULL, slopeStrings, INPUT_FIELD(slope), 0,
+									INPUT_DISPLAY(slopeStr), INPUT_DISPLAY(slopeDef)},
+	[INPUT_PARAM_SLOPE_LEN] =	{PARAM_UINT8, 0, SLOPE_LEN_MIN, SLOPE_LEN_MAX, SLOPE_LEN_INC, SLOPE_LEN_DEFAULT,
+									"%dms", NULL, INPUT_FIELD(slopeLen), 0,
+									INPUT_DISPLAY(slopeLenStr), INPUT_DISPLAY(slopeLenDef)}
+	};
 
 /*
  *	sets all input settings to their defaults
 */
 void setInputDefaults(struct InputSettings *settings) {
-	settings->threshold =		THRESH_DEFAULT;
-	settings->invert =			DEFAULT_INVERT;
-	settings->hysteresis =		HYS_DEFAULT;
-	settings->thresholdCv =		CV_NONE;
-	settings->invertCv =		CV_NONE;
-	settings->hysCv =			CV_NONE;
-	sprintf(settings->thresholdStr, "%dmV", THRESH_DEFAULT);
-	sprintf(settings->invertStr, "false");
-	sprintf(settings->hysStr, "%d0mV", HYS_DEFAULT);
-	settings->thresholdDef =	true;
-	settings->invertDef =		true;
-	settings->hysDef =			true;
+	paramsSetDefaults(inputParams, INPUT_PARAM_COUNT, settings);
 }
 
 /*
@@ -38,150 +116,302 @@ void setInputDefaults(struct InputSettings *settings) {
 void setInputStateDefaults(struct InputState *state) {
 	state->input = 0;
 	state->comp_prev = false;
+	state->comp_filtered = false;
+	state->filter_since = 0;
 	state->input_processed = false;
 	state->cv_hys_prev = HYS_DEFAULT;
 	state->cv_invert_prev = false;
+	state->cv_winSize_prev = WIN_SIZE_DEFAULT;
+	
+	state->invert_mask = DEFAULT_INVERT;
+	state->filter_counts = FILTER_DEFAULT * FILTER_COUNTS;
+	state->cv_any = false;
+	state->window = false;
+	state->zone = ZONE_BELOW;
+	state->zone_out = winOutZones[WIN_OUT_DEFAULT];
+	state->slope_mode = SLOPE_DEFAULT;
+	state->slope_len = SLOPE_LEN_DEFAULT;
+	state->slope_fill = true;
+	state->slope_falling = false;
+	state->slope = 0;
+	state->slope_scale = SLOPE_SCALE_MS << SLOPE_SCALE_SHIFT;
+	state->slope_offset = 0;
+	setInputTrips(state, THRESH_DEFAULT, HYS_DEFAULT, WIN_SIZE_DEFAULT);
 }
 
 /*
- *	takes a raw ADC read (in mV) and deposits the processed data in 
- *	the InputState struct with current input settings
+ *	work out an input's comparator trip points, invert mask & filter width from
+ *	its settings, so processInput() doesn't have to each sample. called whenever
+ *	new settings are published to processing
 */
-void processInput(struct InputSettings *settings, struct InputState *state, int16_t in_raw, struct Cv *cv) {
-	int16_t thresh = settings->threshold;
-	uint8_t hys = settings->hysteresis;
-	bool inv = settings->invert;
+void updateInputTrips(struct InputSettings *settings, struct InputState *state) {
+	state->window = (settings->mode == INPUT_MODE_WINDOW);
+	state->cv_any = (settings->thresholdCv != CV_NONE) || (settings->hysCv != CV_NONE) || 
+					(settings->invertCv != CV_NONE) || (state->window && settings->winSizeCv != CV_NONE);
+	state->invert_mask = settings->invert;
+	state->filter_counts = settings->filter * FILTER_COUNTS;
+	state->zone_out = winOutZones[settings->winOut];
 	
-	// CV parameter checks
-	// NOTE: for the threshold, we will take the raw CV voltage as the comparator 
-	//       threshold, regardless of the selected range setting
-	if (settings->thresholdCv != CV_NONE) {
-		thresh = cv->value[settings->thresholdCv-1];
-	}
-	if (settings->hysCv != CV_NONE) {
-		hys = normalizeCvUint8(cv, settings->hysCv, HYS_MIN, HYS_MAX, state->cv_hys_prev);
-		state->cv_hys_prev = hys;
+	// the running sums only hold for the window they were taken over, start
+	// them over from the last sample here rather than in processing
+	if (settings->slope != state->slope_mode || settings->slopeLen != state->slope_len) {
+		uint32_t lenSq = settings->slopeLen * settings->slopeLen;
+		
+		state->slope_mode = settings->slope;
+		state->slope_len = settings->slopeLen;
+		state->slope_scale = ((SLOPE_SCALE_MS << SLOPE_SCALE_SHIFT) + (lenSq / 2)) / lenSq;
+		fillSlopeRing(state, state->input);
 	}
-	if (settings->invertCv != CV_NONE) {
-		inv = normalizeCvBool(cv, settings->invertCv, state->cv_invert_prev);
-		state->cv_invert_prev = inv;
+	setInputTrips(state, settings->threshold, settings->hysteresis, settings->winSize);
+}
+
+/*
+ *	takes a raw ADC read (in mV) and deposits the processed data in 
+ *	the InputState struct with current input settings. with the filter on, a
+ *	change of the compare out only goes through once it has held for the
+ *	filter width, so the filtered edges lag the input by that width
+*/
+HOT_FUNC void processInput(struct InputSettings *settings, struct InputState *state, int16_t in_raw, struct Cv *cv, uint32_t timebaseCount) {
+	if (state->cv_any) {
+		updateInputCv(settings, state, cv);
 	}
 	
 	state->input = in_raw;
-	// initial comparator w/ hysteresis calculation
-	if (state->comp_prev) {
-		state->comp_prev = in_raw > (thresh - (hys*10));
+	if (state->slope_mode != SLOPE_OFF) {
+		processSlope(state, in_raw, timebaseCount);
+	}
+	else if (state->window) {
+		processWindow(state, in_raw);
 	}
 	else {
-		state->comp_prev = in_raw > (thresh + (hys*10));
+		// comparator w/ hysteresis, against the trip point for the current compare out
+		state->comp_prev = in_raw > (state->comp_prev ? state->trip_low : state->trip_high);
+	}
+	
+	// minimum pulse width filter
+	if (state->filter_counts == 0 || state->comp_prev == state->comp_filtered) {
+		state->comp_filtered = state->comp_prev;
+		state->filter_since = timebaseCount;
+	}
+	else if ((timebaseCount - state->filter_since) >= state->filter_counts) {
+		state->comp_filtered = state->comp_prev;
 	}
 	
 	// invert processing
-	state->input_processed = inv ? !(state->comp_prev) : state->comp_prev;
+	state->input_processed = state->comp_filtered ^ state->invert_mask;
 }
 
 /*
  *	takes a given channel input struct and inputs in mV and processes the channel
- *	inputs according to the given settings
+ *	inputs according to the given (published) settings. an input taking the
+ *	master clock sees it as a virtual voltage in place of its jack, so the
+ *	threshold, hysteresis & invert settings still apply. with copyIn1, input 2
+ *	copies whatever input 1 sees, jack or clock, unless it takes the clock itself
 */
-void processChannelInput(struct Input *input, int16_t in1_mV, int16_t in2_mV, struct Cv *cv) {
+HOT_FUNC void processChannelInput(struct Input *input, struct InputSettings *settings, bool copyIn1, int16_t in1_mV, int16_t in2_mV, struct Cv *cv, uint32_t timebaseCount) {
+	int16_t clock_mV = masterClock.out ? CLOCK_HIGH_MV : CLOCK_LOW_MV;
 	
-	processInput(&input->input_settings[0], &input->input_state[0], in1_mV, cv);
-	
-	if (input->copyIn1) {
+	if (settings[0].source == INPUT_SOURCE_CLOCK) {
+		in1_mV = clock_mV;
+	}
+	if (copyIn1) {
 		in2_mV = in1_mV;
 	}
-	processInput(&input->input_settings[1], &input->input_state[1], in2_mV, cv);
+	if (settings[1].source == INPUT_SOURCE_CLOCK) {
+		in2_mV = clock_mV;
+	}
+	
+	processInput(&settings[0], &input->input_state[0], in1_mV, cv, timebaseCount);
+	processInput(&settings[1], &input->input_state[1], in2_mV, cv, timebaseCount);
 
 }
 
 /*
- *	increment/decrement current threshold parameter by THRESH_INC and
- *	update CV and string params, used by menu functions
+ *	migrate an input's settings from the 7 byte legacy (v0) layout:
+ *	1.threshold (2 bytes) 2.invert 3.hysteresis
+ *	4.threshold CV 5.invert CV 6.hysteresis CV
 */
-void updateThreshold(struct InputSettings *settings, bool inc) {
+void unpackInputSettingsLegacy(struct InputSettings *settings, const uint8_t *buffer) {
+	int16_t thresh = (int16_t)((buffer[0] << 8) | buffer[1]);
 	
-	updateInt16t(&settings->threshold, &settings->thresholdCv, inc, THRESH_MIN, THRESH_MAX, THRESH_INC);
+	// settings added since are left at their defaults
+	paramsSetDefaults(inputParams, INPUT_PARAM_COUNT, settings);
+	
+	settings->threshold =	nvmValidateField(thresh, THRESH_MIN, THRESH_MAX, THRESH_DEFAULT);
+	settings->invert =		nvmValidateField(buffer[2], false, true, DEFAULT_INVERT);
+	settings->hysteresis =	nvmValidateField(buffer[3], HYS_MIN, HYS_MAX, HYS_DEFAULT);
+	settings->thresholdCv =	nvmValidateField(buffer[4], CV_NONE, CV2, CV_NONE);
+	settings->invertCv =	nvmValidateField(buffer[5], CV_NONE, CV2, CV_NONE);
+	settings->hysCv =		nvmValidateField(buffer[6], CV_NONE, CV2, CV_NONE);
+}
+
+/*
+ *	take the CV controlled threshold, hysteresis & invert, working the trip
+ *	points out again only when the threshold or hysteresis has actually moved
+ *	NOTE: for the threshold, we will take the raw CV voltage as the comparator 
+ *	      threshold, regardless of the selected range setting
+*/
+static inline void updateInputCv(struct InputSettings *settings, struct InputState *state, struct Cv *cv) {
+	int16_t thresh = settings->threshold;
+	uint8_t hys = settings->hysteresis;
+	uint16_t win = settings->winSize;
 	
 	if (settings->thresholdCv != CV_NONE) {
-		sprintf(settings->thresholdStr, (settings->thresholdCv == CV1)? "CV1":"CV2");
+		thresh = cv->value[settings->thresholdCv-1];
+	}
+	if (settings->hysCv != CV_NONE) {
+		hys = normalizeCvUint8(cv, settings->hysCv, HYS_MIN, HYS_MAX, state->cv_hys_prev);
+		state->cv_hys_prev = hys;
+	}
+	if (settings->invertCv != CV_NONE) {
+		state->invert_mask = normalizeCvBool(cv, settings->invertCv, state->cv_invert_prev);
+		state->cv_invert_prev = state->invert_mask;
 	}
-	else {	// not under CV control
-		sprintf(settings->thresholdStr, "%dmV", settings->threshold);
+	if (state->window && settings->winSizeCv != CV_NONE) {
+		win = normalizeCvUint16(cv, settings->winSizeCv, WIN_SIZE_MIN, WIN_SIZE_MAX, state->cv_winSize_prev);
+		state->cv_winSize_prev = win;
 	}
 	
-	// check if param is default for display invert
-	settings->thresholdDef = ((settings->thresholdCv == CV_NONE) && \
-						(settings->threshold == THRESH_DEFAULT));
+	if (thresh != state->trip_thresh || hys != state->trip_hys || win != state->trip_win) {
+		setInputTrips(state, thresh, hys, win);
+	}
 }
 
 /*
- *	increment/decrement current invert parameter and update CV and string parameters,
- *	used by menu functions
+ *	set the comparator trip points for a threshold, hysteresis (in 10mV steps)
+ *	& window size. the window's edges share the hysteresis, the bottom zone
+ *	has no way down & the top zone no way up
 */
-void updateInvert(struct InputSettings *settings, bool inc) {
+static inline void setInputTrips(struct InputState *state, int16_t thresh, uint8_t hys, uint16_t win) {
+	int16_t top = thresh + win;
 	
-	updateBool(&settings->invert, &settings->invertCv, inc);
+	state->trip_thresh = thresh;
+	state->trip_hys = hys;
+	state->trip_win = win;
+	state->trip_high = thresh + (hys*10);
+	state->trip_low = thresh - (hys*10);
 	
-	if (settings->invertCv != CV_NONE) {
-		sprintf(settings->invertStr, (settings->invertCv == CV1)? "CV1":"CV2");
+	state->zone_up[ZONE_BELOW] = state->trip_high;
+	state->zone_up[ZONE_INSIDE] = top + (hys*10);
+	state->zone_up[ZONE_ABOVE] = INT16_MAX;
+	state->zone_down[ZONE_BELOW] = INT16_MIN;
+	state->zone_down[ZONE_INSIDE] = state->trip_low;
+	state->zone_down[ZONE_ABOVE] = top - (hys*10);
+}
+
+/*
+ *	window comparator, moving at most a zone up or down per trip point crossed.
+ *	a sample can cross the whole window, so up to two steps are taken
+*/
+static inline void processWindow(struct InputState *state, int16_t in_raw) {
+	uint8_t zone = state->zone;
+	
+	if (in_raw > state->zone_up[zone]) {
+		zone++;
+		if (in_raw > state->zone_up[zone]) {
+			zone++;
+		}
 	}
-	else {	// not under CV control
-		sprintf(settings->invertStr, (settings->invert)? "true":"false");
+	else if (in_raw <= state->zone_down[zone]) {
+		zone--;
+		if (in_raw <= state->zone_down[zone]) {
+			zone--;
+		}
 	}
 	
-	// check if param is default for display invert
-	settings->invertDef = ((settings->invertCv == CV_NONE) && (settings->invert == false));
+	state->zone = zone;
+	state->comp_prev = (zone == state->zone_out);
 }
 
 /*
- *	increment/decrement the current hysteresis parameter and update CV
- *	and string parameters, used by menu functions
+ *	slope detector, sampling the input every ms. the threshold & hysteresis
+ *	apply to the slope in mV per 100ms. peak & trough latch the direction,
+ *	turning only once the slope passes the threshold (plus hysteresis) the
+ *	other way, so a slow turnaround or a plateau doesn't chatter
 */
-void updateHys(struct InputSettings *settings, bool inc) {
-	
-	updateUint8t(&settings->hysteresis, &settings->hysCv, inc, HYS_MIN, HYS_MAX, HYS_INC);
-	
-	if (settings->hysCv != CV_NONE) {
-		sprintf(settings->hysStr, (settings->hysCv == CV1)? "CV1":"CV2");
+static inline void processSlope(struct InputState *state, int16_t in_raw, uint32_t timebaseCount) {
+	if (state->slope_fill) {
+		// the ring was refilled at publish from an earlier sample, offset
+		// everything after so it reads as filled from this one
+		state->slope_offset = in_raw - state->slope_ring[0];
+		state->slope_last = timebaseCount;
+		state->slope_fill = false;
 	}
-	else {
-		sprintf(settings->hysStr, "%d0mV", settings->hysteresis);
+	else if ((timebaseCount - state->slope_last) >= SLOPE_SAMPLE_COUNTS) {
+		pushSlopeSample(state, in_raw);
+		state->slope_last += SLOPE_SAMPLE_COUNTS;
+		// loop was held up for longer than a sample, carry on from here
+		if ((timebaseCount - state->slope_last) >= SLOPE_SAMPLE_COUNTS) {
+			state->slope_last = timebaseCount;
+		}
 	}
 	
-	// check if param is default for display invert
-	settings->hysDef = ((settings->hysCv == CV_NONE) && (settings->hysteresis == HYS_DEFAULT));
+	switch (state->slope_mode) {
+		case SLOPE_RISE:
+			state->comp_prev = state->slope > (state->comp_prev ? state->trip_low : state->trip_high);
+			break;
+		case SLOPE_FALL:
+			state->comp_prev = -state->slope > (state->comp_prev ? state->trip_low : state->trip_high);
+			break;
+		default:
+			if (state->slope > state->trip_high) {
+				state->slope_falling = false;
+			}
+			else if (-state->slope > state->trip_high) {
+				state->slope_falling = true;
+			}
+			state->comp_prev = (state->slope_mode == SLOPE_PEAK) ? state->slope_falling : !state->slope_falling;
+			break;
+	}
 }
 
 /*
- *	increment/decrement the current 'copy in1' parameter, no
- *	CV for this option
+ *	add a sample to the ring. the sample a window-half back moves from the
+ *	newer half's sum to the older's & the one a whole window back drops out,
+ *	so the sums cost the same for any window
 */
-void updateCopyIn1(struct Input *input, bool inc) {
-		
-	// only 2 options here, so we just need to toggle :)
-	input->copyIn1 = !input->copyIn1;
-	sprintf(input->copyIn1Str, (input->copyIn1) ? "Yes":"No");
-	input->copyIn1Def = !input->copyIn1;
+static inline void pushSlopeSample(struct InputState *state, int16_t in_raw) {
+	uint8_t len = state->slope_len;
+	uint8_t head = state->slope_head;
+	int16_t sample = in_raw - state->slope_offset;
+	int16_t mid = state->slope_ring[(uint8_t)(head - len) & (SLOPE_RING - 1)];
+	int16_t last = state->slope_ring[(uint8_t)(head - (2*len)) & (SLOPE_RING - 1)];
+	
+	state->slope_sum_new += sample - mid;
+	state->slope_sum_old += mid - last;
+	state->slope_ring[head] = sample;
+	state->slope_head = (head + 1) & (SLOPE_RING - 1);
+	
+	// difference of the two averages is the change over a window-half
+	state->slope = scaleSlope(state->slope_sum_new - state->slope_sum_old, state->slope_scale);
 }
 
 /*
- *	sets isDefault states for all settings within an Input struct
+ *	scale a difference of the window-half sums to mV per 100ms, by the
+ *	reciprocal worked out at publish rather than a divide per sample. rounds
+ *	towards zero either way so rise & fall trip alike
 */
-void readInputDefaultStates(struct Input *input) {
-	for (uint8_t i=0; i<2; i++) {
-		// threshold
-		input->input_settings[i].thresholdDef = ((input->input_settings[i].thresholdCv == CV_NONE) && \
-					(input->input_settings[i].threshold == THRESH_DEFAULT));
-					
-		// invert
-		input->input_settings[i].invertDef = ((input->input_settings[i].invertCv == CV_NONE) && \
-					(input->input_settings[i].invert == false));
-					
-		// hysteresis
-		input->input_settings[i].hysDef = ((input->input_settings[i].hysCv == CV_NONE) && \
-					(input->input_settings[i].hysteresis == HYS_DEFAULT));
-	}
-	
-	input->copyIn1Def = !input->copyIn1;
+static inline int32_t scaleSlope(int32_t diff, uint32_t scale) {
+	if (diff < 0) {
+		return -(int32_t)(((uint32_t)-diff * scale) >> SLOPE_SCALE_SHIFT);
+	}
+	return (int32_t)(((uint32_t)diff * scale) >> SLOPE_SCALE_SHIFT);
 }
+
+/*
+ *	start the ring over from a steady input, after a change of slope settings.
+ *	called at publish, processing restarts the sample clock & lines the ring
+ *	up with its first sample. only the difference of the sums is ever used,
+ *	so they start from 0
+*/
+static inline void fillSlopeRing(struct InputState *state, int16_t in_raw) {
+	for (uint8_t i = 0; i < SLOPE_RING; i++) {
+		state->slope_ring[i] = in_raw;
+	}
+	state->slope_head = 0;
+	state->slope_sum_new = 0;
+	state->slope_sum_old = 0;
+	state->slope = 0;
+	state->slope_falling = false;
+	state->slope_fill = true;
+}
\ No newline at end of file
@@ -14,6 +14,40 @@
 #include "conf_menu.h"		// for parameter string max char limit
 #include "cv.h"
 #include "paramUtils.h"
+#include "hotPath.h"
+#include "nvmPack.h"
+#include "masterClock.h"
+
+enum InputSourceOptions {
+	INPUT_SOURCE_JACK,
+	INPUT_SOURCE_CLOCK		// internal master clock, see masterClock.h
+	};
+
+enum InputModeOptions {
+	INPUT_MODE_LEVEL,		// single threshold
+	INPUT_MODE_WINDOW		// window from the threshold up by the window size
+	};
+
+// zone of the input relative to the window, selecting the window mode output
+enum WindowOutOptions {
+	WINDOW_OUT_INSIDE,
+	WINDOW_OUT_ABOVE,
+	WINDOW_OUT_BELOW
+	};
+
+// rate of change detection, taking the place of the level or window comparator.
+// the threshold is then a slope in mV per 100ms. peak & trough are high from
+// that turnaround until the next, so their rising edges mark the turnarounds
+enum SlopeOptions {
+	SLOPE_OFF,
+	SLOPE_RISE,				// rising faster than the threshold
+	SLOPE_FALL,				// falling faster than the threshold
+	SLOPE_PEAK,
+	SLOPE_TROUGH
+	};
+
+// slope samples kept per input, twice the longest slope window (a power of two)
+#define SLOPE_RING			64
 
 struct InputSettings {
 	int16_t threshold;			// comparator threshold in mV
@@ -22,32 +56,97 @@ struct InputSettings {
 	uint8_t thresholdCv;
 	uint8_t invertCv;
 	uint8_t hysCv;
-	
+	uint8_t source;				// comparator source, per InputSourceOptions enum
+	uint8_t filter;				// minimum pulse width in 100us increments, 0 is off
+	uint8_t mode;				// comparator mode, per InputModeOptions enum
+	uint16_t winSize;			// window size above the threshold in mV
+	uint8_t winSizeCv;
+	uint8_t winOut;				// window zone the input is high for, per WindowOutOptions enum
+	uint8_t slope;				// slope detection, per SlopeOptions enum
+	uint8_t slopeLen;			// length in ms of each averaged half of the slope window
+	};	// 62 bits to NVM
+
+/*
+ *	display strings & 'default' states for the input settings, kept apart from
+ *	InputSettings so the settings snapshots only copy the stored values
+*/
+struct InputDisplay {
 	// mutable strings for printing current values to display
 	char thresholdStr[GFX_MONO_MENU_PARAM_MAX_CHAR];
 	char invertStr[GFX_MONO_MENU_PARAM_MAX_CHAR];
 	char hysStr[GFX_MONO_MENU_PARAM_MAX_CHAR];
+	char sourceStr[GFX_MONO_MENU_PARAM_MAX_CHAR];
+	char filterStr[GFX_MONO_MENU_PARAM_MAX_CHAR];
+	char modeStr[GFX_MONO_MENU_PARAM_MAX_CHAR];
+	char winSizeStr[GFX_MONO_MENU_PARAM_MAX_CHAR];
+	char winOutStr[GFX_MONO_MENU_PARAM_MAX_CHAR];
+	char slopeStr[GFX_MONO_MENU_PARAM_MAX_CHAR];
+	char slopeLenStr[GFX_MONO_MENU_PARAM_MAX_CHAR];
 	
 	// bools to keep track of whether current value is at the default,
 	// used by gfx_mono_menu for inverting parameter on the display
 	bool thresholdDef;
 	bool invertDef;
 	bool hysDef;
-	};	// 7 bytes to NVM, excludes char arrays & 'default' bools
+	bool sourceDef;
+	bool filterDef;
+	bool modeDef;
+	bool winSizeDef;
+	bool winOutDef;
+	bool slopeDef;
+	bool slopeLenDef;
+	};
 
 struct InputState {
 	int16_t input;				// current input in mV
 	bool comp_prev;				// previous compare out (before invert) for hysteresis
+	bool comp_filtered;			// compare out after the minimum pulse width filter
+	uint32_t filter_since;		// timebase count the compare out last matched the filtered
 	bool input_processed;		// final input state
 	
+	// comparator worked out ahead from the settings, see updateInputTrips()
+	int16_t trip_high;			// trip point for a low compare out, threshold + hysteresis
+	int16_t trip_low;			// trip point for a high compare out, threshold - hysteresis
+	bool invert_mask;
+	uint32_t filter_counts;		// filter width in timebase counts
+	bool cv_any;				// threshold, hysteresis or invert under CV
+	int16_t trip_thresh;		// threshold, hysteresis & window size the trip points are from
+	uint8_t trip_hys;
+	uint16_t trip_win;
+	
+	// window mode, zones numbered upwards from below the window. each zone's
+	// trip points sit in a table so a sample costs the same in any zone
+	bool window;
+	uint8_t zone;				// current zone, with hysteresis
+	uint8_t zone_out;			// zone the input is high for
+	int16_t zone_up[3];			// trip point into the zone above
+	int16_t zone_down[3];		// trip point into the zone below
+	
+	// slope mode, the rate of change between the averages of the two halves of
+	// a window of samples taken every ms, kept as running sums over a ring
+	uint8_t slope_mode;
+	uint8_t slope_len;			// samples in each half of the window
+	bool slope_fill;			// ring refilled, sampling to restart from the next sample
+	bool slope_falling;			// direction last seen, for peak & trough
+	uint8_t slope_head;			// ring position for the next sample
+	int32_t slope_sum_new;		// sum of the newer half
+	int32_t slope_sum_old;		// sum of the older half
+	int32_t slope;				// rate of change in mV per 100ms
+	uint32_t slope_scale;		// 100 / slope_len^2, fixed point with SLOPE_SCALE_SHIFT fraction bits
+	uint32_t slope_last;		// timebase count of the last sample
+	int16_t slope_offset;		// taken off samples going into the ring, lines a refilled ring up with the next sample
+	int16_t slope_ring[SLOPE_RING];
+	
 	// previous CV conversion values used for hysteresis when under CV selection
 	uint8_t cv_hys_prev;
 	bool cv_invert_prev;
+	uint16_t cv_winSize_prev;
 	};
 
 struct Input {
 	struct InputSettings input_settings[2];
 	struct InputState input_state[2];
+	struct InputDisplay input_display[2];
 	bool copyIn1;				// input 2 uses ADC conversion from input 1
 	
 	char copyIn1Str[GFX_MONO_MENU_PARAM_MAX_CHAR];
@@ -56,20 +155,35 @@ struct Input {
 
 void setInputDefaults(struct InputSettings *settings);
 void setInputStateDefaults(struct InputState *state);
-void processInput(struct InputSettings *settings, struct InputState *state, int16_t in_raw, struct Cv *cv);
-void processChannelInput(struct Input *input, int16_t in1_mV, int16_t in2_raw, struct Cv *cv);
+void updateInputTrips(struct InputSettings *settings, struct InputState *state);
+HOT_FUNC void processInput(struct InputSettings *settings, struct InputState *state, int16_t in_raw, struct Cv *cv, uint32_t timebaseCount);
+HOT_FUNC void processChannelInput(struct Input *input, struct InputSettings *settings, bool copyIn1, int16_t in1_mV, int16_t in2_raw, struct Cv *cv, uint32_t timebaseCount);
 
 /*
- *	functions for UI callbacks during menu interactions
+ *	parameter descriptors for InputSettings, in NVM packing order. strings & 'default'
+ *	states are relative to InputDisplay. a new parameter goes in wherever it fits,
+ *	since any change to the table moves the rest of the channel page along with
+ *	it and needs a schema version bump
 */
-void updateThreshold(struct InputSettings *settings, bool inc);
-void updateInvert(struct InputSettings *settings, bool inc);
-void updateHys(struct InputSettings *settings, bool inc);
-void updateCopyIn1(struct Input *input, bool inc);
+enum InputParams {
+	INPUT_PARAM_THRESHOLD,
+	INPUT_PARAM_INVERT,
+	INPUT_PARAM_HYS,
+	INPUT_PARAM_SOURCE,
+	INPUT_PARAM_FILTER,
+	INPUT_PARAM_MODE,
+	INPUT_PARAM_WIN_SIZE,
+	INPUT_PARAM_WIN_OUT,
+	INPUT_PARAM_SLOPE,
+	INPUT_PARAM_SLOPE_LEN,
+	INPUT_PARAM_COUNT
+	};
+
+extern const struct ParamDesc inputParams[INPUT_PARAM_COUNT];
 
 /*
- *	used after NVM read to set thresholdDef, invertDef, etc
+ *	migrate settings from a legacy (v0) NVM page, with per-field range checks
 */
-void readInputDefaultStates(struct Input *input);
+void unpackInputSettingsLegacy(struct InputSettings *settings, const uint8_t *buffer);
 
 #endif /* INPUTS_H_ */
\ No newline at end of file
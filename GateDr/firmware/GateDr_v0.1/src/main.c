@@ -17,6 +17,22 @@
 // input on E-variant SAMD21s
 #define PIN_SCAN_COUNT 8
 #define NVM_EEPROM_EMULATOR_SIZE_DEFAULT NVM_EEPROM_EMULATOR_SIZE_2048
+// ADC results are 12 bit, used to tell when the first scan has landed
+#define ADC_SCAN_EMPTY 0xFFFF
+// raw ADC read of 0V, see get_adc_mV()
+#define ADC_SCAN_ZERO 2047
+// time (in ms) to wait for the first scan, a full scan takes ~2ms
+#define ADC_SCAN_TIMEOUT 20
+
+// the display & menus are brought up in stages once processing is running,
+// one stage per processing loop
+enum BootStage {
+	BOOT_DISPLAY,		// SSD1306 interface init & reset
+	BOOT_DISPLAY_CMDS,	// SSD1306 setup commands, one per loop
+	BOOT_MENU_INIT,		// menu setup
+	BOOT_MENUS,			// draw menu framebuffers, one per loop
+	BOOT_DONE
+	};
 
 struct adc_module adc_instance;
 struct dma_resource dma_instance;
@@ -26,14 +42,24 @@ struct events_resource rtc_event;
 struct events_hook rtc_hook;
 struct rtc_module rtc_instance;
 struct tc_module tc3_instance;
+struct tc_module tc4_instance;
+
+// output pins W, X, Y, Z
+const uint8_t outputPins[OUTPUT_TIMER_COUNT] = {PIN_PA11, PIN_PA10, PIN_PA09, PIN_PA08};
 
 uint16_t adcBuffer[8] = {0};
 uint32_t rtcCount = 0;
+uint32_t timebaseCount = 0;
+uint8_t bootStage = BOOT_DISPLAY;
 
 void configure_adc(void);
 void configure_dma(struct dma_resource *resource, DmacDescriptor *descriptor, uint16_t *buffer);
 void configure_eeprom(void);
 void configure_bod(void);
+void configure_master_clock(void);
+void master_clock_callback(struct tc_module *const module);
+void wait_adc_scan(volatile uint16_t *buffer);
+void boot_display_task(void);
 unsigned int generate_seed(uint16_t *buffer);
 int16_t get_adc_mV(uint16_t rawAdc);
 
@@ -41,35 +67,49 @@ int main (void)
 {
 	system_init();
 	system_interrupt_enable_global();
+	
+	// RTC first, so boot time is measured from as early as possible. the
+	// stored long press time is loaded over the default by configure_eeprom()
+	ui_init(&rtc_event, &rtc_hook, &rtc_instance);		// RTC initialized within function
+	nvmCacheInit(&rtcCount);
 	configure_eeprom();
 	configure_bod();
-	ssd1306_init();
+	timebaseInit(&tc4_instance);			// TC4 initialized within function
+	outputTimerInit(&tc4_instance, outputPins);
+	configure_master_clock();
 	
-	ui_init(&rtc_event, &rtc_hook, &rtc_instance);		// RTC initialized within function
-	initChannel(&chan[0], &rtcCount, 0);
-	initChannel(&chan[1], &rtcCount, 1);
+	initChannel(&chan[0], &rtcCount, &timebaseCount, 0);
+	initChannel(&chan[1], &rtcCount, &timebaseCount, 1);
 	
+	for (uint8_t i = 0; i<PIN_SCAN_COUNT; i++) {
+		adcBuffer[i] = ADC_SCAN_EMPTY;
+	}
 	configure_adc();
 	configure_dma(&dma_instance, &dmac_descriptor, adcBuffer);
 	adc_start_conversion(&adc_instance);
 	dma_start_transfer_job(&dma_instance);
 	
-	// initialize menu
-	gfx_mono_init();
-	menuInit(&rtcCount, VER);
-	screenDrawInit(&tc3_instance);						// TC3 initialized within function
-	
 	int16_t adcResult[PIN_SCAN_COUNT] = {0};			// stores most recent ADC reads in mV
 	unsigned int seed = 0;
 	
-	// initialize the seed from ADC reads
+	// initialize the seed from ADC reads, once there are some
+	wait_adc_scan(adcBuffer);
 	seed = generate_seed(adcBuffer);
 	srand(seed);
 	
+	// the display & menus are initialized from the processing loop, 
+	// see boot_display_task()
 	while (1) {
 		
 		// get current RTC count to use in processing blocks
 		rtcCount = rtc_count_get_count(&rtc_instance);
+		timebaseCount = timebaseGetCount();
+		
+		// swap in a staged preset recall and publish any settings edits
+		// on the tick boundary
+		presetApply();
+		publishChannelSettings(&chan[0]);
+		publishChannelSettings(&chan[1]);
 		
 		// read all ADC inputs
 		// due to hardware positions, adc reads in the order:
@@ -80,20 +120,91 @@ int main (void)
 		cv_instance.value[0] = adcResult[7];
 		cv_instance.value[1] = adcResult[6];
 		
+		// pick up master clock tempo changes & latch its level for the inputs
+		masterClockUpdate(&masterClock, &cv_instance);
+		
 		processChannel(&chan[0], adcResult[5], adcResult[4], &cv_instance);
 		processChannel(&chan[1], adcResult[1], adcResult[0], &cv_instance);
 		
-		// set output states
-		port_pin_set_output_level(PIN_PA11, chan[0].out.output_state[0].out_processed);	// output W
-		port_pin_set_output_level(PIN_PA10, chan[0].out.output_state[1].out_processed);	// output X
-		port_pin_set_output_level(PIN_PA09, chan[1].out.output_state[0].out_processed);	// output Y
-		port_pin_set_output_level(PIN_PA08, chan[1].out.output_state[1].out_processed);	// output Z	
+		// set output states, & hand any edges known ahead of time to the output timer
+		outputTimerWrite(0, &chan[0].out.output_state[0], timebaseCount);	// output W
+		outputTimerWrite(1, &chan[0].out.output_state[1], timebaseCount);	// output X
+		outputTimerWrite(2, &chan[1].out.output_state[0], timebaseCount);	// output Y
+		outputTimerWrite(3, &chan[1].out.output_state[1], timebaseCount);	// output Z	
+		
+		// save the output loops once one is locked, commit any settled settings
+		// edits, one emulator operation per loop
+		saveChannelLoops(&chan[0], 0);
+		saveChannelLoops(&chan[1], 1);
+		nvmCommitTask();
 		
-		processMenuAction();
+		// catch up after a preset recall, check for recall by CV
+		presetTask(&cv_instance);
+		
+		// bring up the display & menus once outputs are running
+		if (bootStage != BOOT_DONE) {
+			boot_display_task();
+		}
+		else {
+			processMenuAction();
+		}
 		
 	}
 }
 
+/*
+ *	block until the DMA has written a full ADC scan, an empty buffer would
+ *	otherwise read as +8V on every input for the first processing loops.
+ *	gives up after ADC_SCAN_TIMEOUT so a stalled ADC or DMA can't hang boot,
+ *	any input still empty then reads as 0V until the scan lands
+*/
+void wait_adc_scan(volatile uint16_t *buffer) {
+	uint32_t start = rtc_count_get_count(&rtc_instance);
+	
+	for (uint8_t i = 0; i<PIN_SCAN_COUNT; i++) {
+		while (buffer[i] == ADC_SCAN_EMPTY) {
+			if ((rtc_count_get_count(&rtc_instance) - start) >= ADC_SCAN_TIMEOUT) {
+				break;
+			}
+		}
+		if (buffer[i] == ADC_SCAN_EMPTY) {
+			buffer[i] = ADC_SCAN_ZERO;
+		}
+	}
+}
+
+/*
+ *	bring up the display and menus a stage at a time, called once per processing
+ *	loop until done so the outputs are never held up by the display. the first
+ *	call is on the first processing loop, after the outputs have been set
+*/
+void boot_display_task(void) {
+	switch (bootStage) {
+		case BOOT_DISPLAY:
+			writeBootTime(&globalSettings, rtcCount);
+			
+			ssd1306_init_interface();
+			bootStage = BOOT_DISPLAY_CMDS;
+			break;
+		case BOOT_DISPLAY_CMDS:
+			if (!ssd1306_init_next()) {
+				bootStage = BOOT_MENU_INIT;
+			}
+			break;
+		case BOOT_MENU_INIT:
+			gfx_mono_init();
+			menuInit(&rtcCount, VER);
+			bootStage = BOOT_MENUS;
+			break;
+		case BOOT_MENUS:
+			if (!menuDrawNext()) {
+				screenDrawInit(&tc3_instance);			// TC3 initialized within function
+				bootStage = BOOT_DONE;
+			}
+			break;
+	}
+}
+
 /*
  *	setup for ASF ADC module
 */
@@ -142,7 +253,7 @@ void configure_dma(struct dma_resource *resource, DmacDescriptor *descriptor, ui
 /*
  *	setup for emulated EEPROM module, writes fuses & stalls program if NVM fuses have not been
  *	set properly for emulated EEPROM usage, initializes and writes defaults 
- *	if uninitialized or corrupted
+ *	if uninitialized or corrupted, and loads the preset slots
 */
 void configure_eeprom(void) {
 	enum status_code error_code = eeprom_emulator_init();
@@ -182,6 +293,9 @@ void configure_eeprom(void) {
 		readChannelNVM(&chan[0], 0);
 		readChannelNVM(&chan[1], 1);
 	}
+	
+	// load the preset slots into the NVM cache so recalls never read from flash
+	presetInit();
 }
 
 /*
@@ -199,13 +313,40 @@ void configure_bod(void) {
 	system_interrupt_enable(SYSTEM_INTERRUPT_MODULE_SYSCTRL);
 }
 
+/*
+ *	start the master clock from the loaded settings & hook CC1 of the timebase
+ *	TC, must be called after the settings have been read & timebaseInit()
+*/
+void configure_master_clock(void) {
+	masterClockInit(&masterClock, timebaseGetCount());
+	
+	tc_set_compare_value(&tc4_instance, TC_COMPARE_CAPTURE_CHANNEL_1, masterClock.next);
+	tc_register_callback(&tc4_instance, master_clock_callback, TC_CALLBACK_CC_CHANNEL1);
+	tc_enable_callback(&tc4_instance, TC_CALLBACK_CC_CHANNEL1);
+}
+
+/*
+ *	CC1 match interrupt, lands the master clock's due edges & points CC1 at
+ *	the next one. an edge that comes due while the compare syncs would only
+ *	match after the counter wraps, so it's landed straight away instead
+*/
+void master_clock_callback(struct tc_module *const module) {
+	uint32_t next;
+	
+	do {
+		next = masterClockAdvance(&masterClock, timebaseGetCount());
+		tc_set_compare_value(module, TC_COMPARE_CAPTURE_CHANNEL_1, next);
+	} while ((int32_t)(next - timebaseGetCount()) <= 1);
+}
+
 /*
  *	SYSCTRL interrupt function, called on BOD event
 */
 void SYSCTRL_Handler (void) {
-	// clear BOD interrupt flag and dump the contents of the EEPROM buffer to NVM
+	// clear BOD interrupt flag and commit the EEPROM buffer and any held off
+	// pages to NVM, see nvmCommitFlush()
 	if (SYSCTRL->INTFLAG.reg & SYSCTRL_INTFLAG_BOD33DET) {
-		eeprom_emulator_commit_page_buffer();
+		nvmCommitFlush();
 		SYSCTRL->INTFLAG.reg = SYSCTRL_INTFLAG_BOD33DET;
 	}
 }
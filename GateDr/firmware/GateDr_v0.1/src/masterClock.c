@@ -0,0 +1,125 @@
+/*
+ * source file for the internal master clock
+ *
+ * pulses come in pairs, the on-beat pulse taking 'swing' % of the pair and the
+ * off-beat the rest, and each pulse is high for half of the shorter pulse so
+ * there's always a low between them. the schedule runs off its own edge times
+ * (each edge is placed from the one before it, never from when it was landed),
+ * so a late interrupt doesn't drift the clock
+ */
+
+#include "masterClock.h"
+#include "timebase.h"
+
+#define BPM_DEFAULT			120
+#define BPM_MIN				20
+#define BPM_MAX				300
+#define BPM_INC				1
+#define SWING_DEFAULT		50
+#define SWING_MIN			50
+#define SWING_MAX			75
+#define SWING_INC			1
+
+#define CLOCK_FIELD(x)		offsetof(struct MasterClockSettings, x)
+
+const struct ParamDesc clockParams[CLOCK_PARAM_COUNT] = {
+	[CLOCK_PARAM_BPM] =		{PARAM_UINT16, PARAM_FLAG_CV, BPM_MIN, BPM_MAX, BPM_INC, BPM_DEFAULT,
+								"%d", NULL, CLOCK_FIELD(bpm), CLOCK_FIELD(bpmCv),
+								CLOCK_FIELD(bpmStr), CLOCK_FIELD(bpmDef)},
+	[CLOCK_PARAM_SWING] =	{PARAM_UINT8, 0, SWING_MIN, SWING_MAX, SWING_INC, SWING_DEFAULT,
+								"%d%%", NULL, CLOCK_FIELD(swing), 0,
+								CLOCK_FIELD(swingStr), CLOCK_FIELD(swingDef)}
+	};
+
+// declaration for static inline helper functions
+static inline uint32_t getClockStep(uint16_t bpm);
+
+/*
+ *	sets all master clock settings to their defaults
+*/
+void setMasterClockDefaults(struct MasterClockSettings *settings) {
+	paramsSetDefaults(clockParams, CLOCK_PARAM_COUNT, settings);
+}
+
+/*
+ *	start the clock from the current settings, with the first pulse one step
+ *	from 'now'. must be called before the interrupt is enabled
+*/
+void masterClockInit(struct MasterClock *clk, uint32_t now) {
+	clk->bpm_prev = clk->settings.bpm;
+	clk->cv_bpm_prev = clk->settings.bpm;
+	clk->step = getClockStep(clk->settings.bpm);
+	clk->swing = clk->settings.swing;
+	
+	clk->level = false;
+	clk->rises = 0;
+	clk->next_rise = now + clk->step;
+	clk->next = clk->next_rise;
+	clk->off_beat = false;
+	
+	clk->out = false;
+	clk->rises_seen = 0;
+}
+
+/*
+ *	land every edge due by 'now' & return the timebase count of the next one.
+ *	called from the compare match interrupt, each pulse takes the step & swing
+ *	in place at its rising edge
+*/
+uint32_t masterClockAdvance(struct MasterClock *clk, uint32_t now) {
+	uint32_t pair;
+	uint32_t on;
+	uint32_t off;
+	
+	while ((int32_t)(now - clk->next) >= 0) {
+		if (clk->level) {
+			clk->level = false;
+			clk->next = clk->next_rise;
+		}
+		else {
+			pair = clk->step << 1;
+			on = (pair * clk->swing) / 100;
+			off = pair - on;
+			
+			clk->level = true;
+			clk->rises++;
+			clk->next = clk->next_rise + (off >> 1);
+			clk->next_rise += clk->off_beat ? off : on;
+			clk->off_beat = !clk->off_beat;
+		}
+	}
+	
+	return clk->next;
+}
+
+/*
+ *	once per processing loop, pick up tempo & swing changes for the interrupt
+ *	and latch the clock level for the channel inputs. a pulse that came & went
+ *	since the last loop still reads high for this one
+*/
+HOT_FUNC void masterClockUpdate(struct MasterClock *clk, struct Cv *cv) {
+	uint16_t bpm = clk->settings.bpm;
+	uint8_t rises = clk->rises;
+	
+	if (clk->settings.bpmCv != CV_NONE) {
+		bpm = normalizeCvUint16(cv, clk->settings.bpmCv, BPM_MIN, BPM_MAX, clk->cv_bpm_prev);
+		clk->cv_bpm_prev = bpm;
+	}
+	
+	// the divide is only worth doing on a tempo change
+	if (bpm != clk->bpm_prev) {
+		clk->step = getClockStep(bpm);
+		clk->bpm_prev = bpm;
+	}
+	clk->swing = clk->settings.swing;
+	
+	clk->out = clk->level || (rises != clk->rises_seen);
+	clk->rises_seen = rises;
+}
+
+/*
+ *	timebase counts per pulse at the given tempo
+*/
+static inline uint32_t getClockStep(uint16_t bpm) {
+	return (TIMEBASE_HZ * 60) / ((uint32_t)bpm * CLOCK_PPQN);
+}
\ No newline at end of file
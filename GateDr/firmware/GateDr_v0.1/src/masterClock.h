@@ -0,0 +1,76 @@
+/*
+ *	internal master clock, a swung pulse clock that any channel input can take
+ *	in place of its jack. the edges are scheduled on the timebase counter &
+ *	landed by a compare match interrupt (see main.c) at exact intervals, the
+ *	processing loop only reads the clock's level
+ */
+
+
+#ifndef MASTERCLOCK_H_
+#define MASTERCLOCK_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "conf_menu.h"		// for parameter string max char limit
+#include "cv.h"
+#include "paramUtils.h"
+#include "hotPath.h"
+
+// pulses per quarter note, the clock runs in 16ths so swing falls on the off-16ths
+#define CLOCK_PPQN			4
+
+struct MasterClockSettings {
+	uint16_t bpm;				// tempo in quarter notes per minute
+	uint8_t swing;				// share of each pulse pair given to the on-beat, in %
+	uint8_t bpmCv;
+	
+	// mutable strings for printing current values to display
+	char bpmStr[GFX_MONO_MENU_PARAM_MAX_CHAR];
+	char swingStr[GFX_MONO_MENU_PARAM_MAX_CHAR];
+	
+	// bools to keep track of whether current value is at the default,
+	// used by gfx_mono_menu for inverting parameter on the display
+	bool bpmDef;
+	bool swingDef;
+	};	// 16 bits to NVM, excludes char arrays & 'default' bools
+
+struct MasterClock {
+	struct MasterClockSettings settings;
+	
+	// pulse timing, written by the loop & read by the interrupt
+	volatile uint32_t step;		// timebase counts per unswung pulse
+	volatile uint8_t swing;
+	uint16_t bpm_prev;			// tempo the step was last worked out for
+	uint16_t cv_bpm_prev;
+	
+	// schedule, owned by the interrupt
+	volatile bool level;		// current clock level
+	volatile uint8_t rises;		// rising edges landed, wraps
+	uint32_t next;				// timebase count of the next edge
+	uint32_t next_rise;			// timebase count of the next rising edge
+	bool off_beat;				// the next pulse is the swung one of its pair
+	
+	// clock level as seen by this processing loop
+	bool out;
+	uint8_t rises_seen;
+	};
+
+struct MasterClock masterClock;
+
+void setMasterClockDefaults(struct MasterClockSettings *settings);
+void masterClockInit(struct MasterClock *clk, uint32_t now);
+uint32_t masterClockAdvance(struct MasterClock *clk, uint32_t now);
+HOT_FUNC void masterClockUpdate(struct MasterClock *clk, struct Cv *cv);
+
+/*
+ *	parameter descriptors for MasterClockSettings, in NVM packing order
+*/
+enum MasterClockParams {
+	CLOCK_PARAM_BPM,
+	CLOCK_PARAM_SWING,
+	CLOCK_PARAM_COUNT
+	};
+
+extern const struct ParamDesc clockParams[CLOCK_PARAM_COUNT];
+
+#endif /* MASTERCLOCK_H_ */
\ No newline at end of file
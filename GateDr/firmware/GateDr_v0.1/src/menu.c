@@ -3,10 +3,20 @@
  */ 
 
 #include "menu.h"
+#include "preset.h"		// for preset save/recall
+#include "textFormat.h"
 
 #define DEFAULT_MENU	MENU_CHANNEL_1
 #define MENU_COUNT		8
 
+// encoder acceleration- time per detent (in ms) under which each multiplier
+// applies, fastest first. the step count for a batch is capped so the largest
+// step for any parameter still fits in its type
+#define ENC_ACCEL_STAGES	3
+#define ENC_ACCEL_MAX_STEPS	40
+static const uint16_t encAccelTimes[ENC_ACCEL_STAGES] = {25, 50, 100};
+static const uint8_t encAccelMultipliers[ENC_ACCEL_STAGES] = {10, 4, 2};
+
 // framebuffers for each menu page 
 static uint8_t framebuffers[MENU_COUNT][GFX_MONO_LCD_FRAMEBUFFER_SIZE];
 
@@ -14,11 +24,14 @@ static uint8_t framebuffers[MENU_COUNT][GFX_MONO_LCD_FRAMEBUFFER_SIZE];
 char globalTitleScreen[24];
 
 // string lists for menu parameters
-const char *globalSettingsStrings[] = {"CH1", "CH2", "CV", "Reset", "Long-press", "Screen off"};
+const char *globalSettingsStrings[] = {"CH1", "CH2", "CV", "Reset", "Long-press", "Screen off",
+				"Save preset", "Load preset", "Preset CV", "Clock BPM", "Clock swing", "Boot time"};
 const char *channelMenuStrings[] = {"Inputs", "OP 1", "OP 2", "Outputs"};
-const char *inputsMenuStrings[] = {"1-thrsh", "1-hys", "1-inv", "2-copy in1", "2-thrsh", "2-hys", "2-inv"};
-const char *outputsMenuStrings[] = {"1-div", "1-div phase", "1-div reset", "1-delay", "1-prob", "1-trig mode", "1-trig len", 
-				"2-mode", "2-div", "2-div phase", "2-div reset", "2-delay", "2-prob", "2-trig mode", "2-trig len"};
+const char *inputsMenuStrings[] = {"1-source", "1-mode", "1-slope", "1-slope len", "1-thrsh", "1-win size",
+				"1-win out", "1-hys", "1-inv", "1-filter", "2-copy in1", "2-source", "2-mode",
+				"2-slope", "2-slope len", "2-thrsh", "2-win size", "2-win out", "2-hys", "2-inv", "2-filter"};
+const char *outputsMenuStrings[] = {"1-mult", "1-div", "1-div phase", "1-div reset", "1-div duty", "1-euc steps", "1-euc fills", "1-euc rotate", "1-delay", "1-prob", "1-prob mode", "1-prob lock", "1-prob len", "1-burst", "1-burst time", "1-trig mode", "1-trig len", 
+				"2-mode", "2-mult", "2-div", "2-div phase", "2-div reset", "2-div duty", "2-euc steps", "2-euc fills", "2-euc rotate", "2-delay", "2-prob", "2-prob mode", "2-prob lock", "2-prob len", "2-burst", "2-burst time", "2-trig mode", "2-trig len"};
 const char *cvMenuStrings[] = {"CV1 range", "CV1 thresh", "CV2 range", "CV2 thresh"};
 	
 // screen saver count times
@@ -31,28 +44,129 @@ struct gfx_mono_menu *menuList[] = {&globalMenu, &channel1Menu, &inputs1Menu,
 // declaration for static inline helper functions
 //static inline void drawScreen(void);
 static inline void setMenu(uint8_t menu_index);
+static inline uint8_t getMenuNvmPage(void);
 static inline void writeNVM(void);
+static inline uint8_t getEncoderSteps(uint8_t count);
+static inline void editMenuParam(bool inc, uint8_t count);
+static inline void *getParamBase(uint8_t base);
+static inline void *getParamDisplay(uint8_t base);
 
 // this second batch of helper functions is to keep the higher level processAction
 // functions cleaner and avoid nested switches 
-static void updateGlobalMenuParam(bool inc);
+static void updateMenuParam(bool inc, uint8_t detents, uint8_t steps);
 static void globalMenuEnter(void);
-static void updateChannelMenuParam(bool inc);
 static void channelMenuEnter(void);
-static void updateInputsMenuParam(bool inc);
 static void inputsMenuEnter(void);
-static void updateOutputsMenuParam(bool inc);
 static void outputsMenuEnter(void);
-static void updateCvMenuParam(bool inc);
 static void cvMenuEnter(void);
 
-// generalized pointers to updateParam and menuEnter functions, used by higher level
-// processAction functions
-typedef void (*updateMenuParam)(bool inc);
-static const updateMenuParam updateParamTable[MENU_COUNT] = {updateGlobalMenuParam, updateChannelMenuParam,
-					updateInputsMenuParam, updateOutputsMenuParam, updateChannelMenuParam,
-					updateInputsMenuParam, updateOutputsMenuParam, updateCvMenuParam};
-
+// settings struct a menu parameter's descriptor is relative to, resolved
+// against the current channel context
+enum ParamBase {
+	BASE_NONE,		// submenu, not an editable parameter
+	BASE_GLOBAL,
+	BASE_CHANNEL,
+	BASE_INPUT_1,
+	BASE_INPUT_2,
+	BASE_OUTPUT_1,
+	BASE_OUTPUT_2,
+	BASE_CV_1,
+	BASE_CV_2,
+	BASE_CLOCK
+	};
+
+struct MenuParam {
+	const struct ParamDesc *desc;
+	uint8_t base;
+	};
+
+// parameters for each menu entry, in menu order
+static const struct MenuParam globalMenuParams[] = {
+	{NULL, BASE_NONE}, {NULL, BASE_NONE}, {NULL, BASE_NONE},
+	{&globalParams[GLOBAL_PARAM_RESET], BASE_GLOBAL},
+	{&globalParams[GLOBAL_PARAM_LONG_PRESS], BASE_GLOBAL},
+	{&globalParams[GLOBAL_PARAM_SCREENSAVER], BASE_GLOBAL},
+	{&globalParams[GLOBAL_PARAM_PRESET_SAVE], BASE_GLOBAL},
+	{&globalParams[GLOBAL_PARAM_PRESET_RECALL], BASE_GLOBAL},
+	{&globalParams[GLOBAL_PARAM_PRESET_CV], BASE_GLOBAL},
+	{&clockParams[CLOCK_PARAM_BPM], BASE_CLOCK},
+	{&clockParams[CLOCK_PARAM_SWING], BASE_CLOCK},
+	{NULL, BASE_NONE}};
+static const struct MenuParam channelMenuParams[] = {
+	{NULL, BASE_NONE},
+	{&channelParams[CHANNEL_PARAM_OP_1], BASE_CHANNEL},
+	{&channelParams[CHANNEL_PARAM_OP_2], BASE_CHANNEL},
+	{NULL, BASE_NONE}};
+static const struct MenuParam inputsMenuParams[] = {
+	{&inputParams[INPUT_PARAM_SOURCE], BASE_INPUT_1},
+	{&inputParams[INPUT_PARAM_MODE], BASE_INPUT_1},
+	{&inputParams[INPUT_PARAM_SLOPE], BASE_INPUT_1},
+	{&inputParams[INPUT_PARAM_SLOPE_LEN], BASE_INPUT_1},
+	{&inputParams[INPUT_PARAM_THRESHOLD], BASE_INPUT_1},
+	{&inputParams[INPUT_PARAM_WIN_SIZE], BASE_INPUT_1},
+	{&inputParams[INPUT_PARAM_WIN_OUT], BASE_INPUT_1},
+	{&inputParams[INPUT_PARAM_HYS], BASE_INPUT_1},
+	{&inputParams[INPUT_PARAM_INVERT], BASE_INPUT_1},
+	{&inputParams[INPUT_PARAM_FILTER], BASE_INPUT_1},
+	{&channelParams[CHANNEL_PARAM_COPY_IN1], BASE_CHANNEL},
+	{&inputParams[INPUT_PARAM_SOURCE], BASE_INPUT_2},
+	{&inputParams[INPUT_PARAM_MODE], BASE_INPUT_2},
+	{&inputParams[INPUT_PARAM_SLOPE], BASE_INPUT_2},
+	{&inputParams[INPUT_PARAM_SLOPE_LEN], BASE_INPUT_2},
+	{&inputParams[INPUT_PARAM_THRESHOLD], BASE_INPUT_2},
+	{&inputParams[INPUT_PARAM_WIN_SIZE], BASE_INPUT_2},
+	{&inputParams[INPUT_PARAM_WIN_OUT], BASE_INPUT_2},
+	{&inputParams[INPUT_PARAM_HYS], BASE_INPUT_2},
+	{&inputParams[INPUT_PARAM_INVERT], BASE_INPUT_2},
+	{&inputParams[INPUT_PARAM_FILTER], BASE_INPUT_2}};
+static const struct MenuParam outputsMenuParams[] = {
+	{&outputParams[OUTPUT_PARAM_CLK_MULT], BASE_OUTPUT_1},
+	{&outputParams[OUTPUT_PARAM_CLK_DIV], BASE_OUTPUT_1},
+	{&outputParams[OUTPUT_PARAM_CLK_PHASE], BASE_OUTPUT_1},
+	{&outputParams[OUTPUT_PARAM_DIV_RST], BASE_OUTPUT_1},
+	{&outputParams[OUTPUT_PARAM_DIV_DUTY], BASE_OUTPUT_1},
+	{&outputParams[OUTPUT_PARAM_EUC_STEPS], BASE_OUTPUT_1},
+	{&outputParams[OUTPUT_PARAM_EUC_FILLS], BASE_OUTPUT_1},
+	{&outputParams[OUTPUT_PARAM_EUC_ROTATE], BASE_OUTPUT_1},
+	{&outputParams[OUTPUT_PARAM_DELAY], BASE_OUTPUT_1},
+	{&outputParams[OUTPUT_PARAM_PROBABILITY], BASE_OUTPUT_1},
+	{&outputParams[OUTPUT_PARAM_PROB_MODE], BASE_OUTPUT_1},
+	{&outputParams[OUTPUT_PARAM_PROB_LOCK], BASE_OUTPUT_1},
+	{&outputParams[OUTPUT_PARAM_PROB_LENGTH], BASE_OUTPUT_1},
+	{&outputParams[OUTPUT_PARAM_BURST_COUNT], BASE_OUTPUT_1},
+	{&outputParams[OUTPUT_PARAM_BURST_INTERVAL], BASE_OUTPUT_1},
+	{&outputParams[OUTPUT_PARAM_TRIG], BASE_OUTPUT_1},
+	{&outputParams[OUTPUT_PARAM_TRIG_LEN], BASE_OUTPUT_1},
+	{&channelParams[CHANNEL_PARAM_OUT2], BASE_CHANNEL},
+	{&outputParams[OUTPUT_PARAM_CLK_MULT], BASE_OUTPUT_2},
+	{&outputParams[OUTPUT_PARAM_CLK_DIV], BASE_OUTPUT_2},
+	{&outputParams[OUTPUT_PARAM_CLK_PHASE], BASE_OUTPUT_2},
+	{&outputParams[OUTPUT_PARAM_DIV_RST], BASE_OUTPUT_2},
+	{&outputParams[OUTPUT_PARAM_DIV_DUTY], BASE_OUTPUT_2},
+	{&outputParams[OUTPUT_PARAM_EUC_STEPS], BASE_OUTPUT_2},
+	{&outputParams[OUTPUT_PARAM_EUC_FILLS], BASE_OUTPUT_2},
+	{&outputParams[OUTPUT_PARAM_EUC_ROTATE], BASE_OUTPUT_2},
+	{&outputParams[OUTPUT_PARAM_DELAY], BASE_OUTPUT_2},
+	{&outputParams[OUTPUT_PARAM_PROBABILITY], BASE_OUTPUT_2},
+	{&outputParams[OUTPUT_PARAM_PROB_MODE], BASE_OUTPUT_2},
+	{&outputParams[OUTPUT_PARAM_PROB_LOCK], BASE_OUTPUT_2},
+	{&outputParams[OUTPUT_PARAM_PROB_LENGTH], BASE_OUTPUT_2},
+	{&outputParams[OUTPUT_PARAM_BURST_COUNT], BASE_OUTPUT_2},
+	{&outputParams[OUTPUT_PARAM_BURST_INTERVAL], BASE_OUTPUT_2},
+	{&outputParams[OUTPUT_PARAM_TRIG], BASE_OUTPUT_2},
+	{&outputParams[OUTPUT_PARAM_TRIG_LEN], BASE_OUTPUT_2}};
+static const struct MenuParam cvMenuParams[] = {
+	{&cvParams[CV_PARAM_RANGE], BASE_CV_1},
+	{&cvParams[CV_PARAM_THRESHOLD], BASE_CV_1},
+	{&cvParams[CV_PARAM_RANGE], BASE_CV_2},
+	{&cvParams[CV_PARAM_THRESHOLD], BASE_CV_2}};
+
+// list of parameter tables corresponding to the Menus enum
+static const struct MenuParam *const menuParamTable[MENU_COUNT] = {globalMenuParams, channelMenuParams,
+					inputsMenuParams, outputsMenuParams, channelMenuParams,
+					inputsMenuParams, outputsMenuParams, cvMenuParams};
+
+// generalized pointer to menuEnter functions, used by higher level processAction functions
 typedef void (*menuEnter)(void);
 static const menuEnter menuEnterTable[MENU_COUNT] = {globalMenuEnter, channelMenuEnter, inputsMenuEnter,
 					outputsMenuEnter, channelMenuEnter, inputsMenuEnter,
@@ -83,17 +197,42 @@ static inline void setMenu(uint8_t menu_index) {
 	}
 	
 	gfx_mono_set_framebuffer(menuList[menu.currentMenu]->fbPointer);
+	
+	// redraw if settings changed since this menu was last drawn
+	if (menu.staleMenus & (1 << menu.currentMenu)) {
+		menu.staleMenus &= ~(1 << menu.currentMenu);
+		gfx_mono_menu_init(menuList[menu.currentMenu]);
+	}
+}
+
+/*
+ *	get the emulated EEPROM page holding the settings for the current menu context
+*/
+static inline uint8_t getMenuNvmPage(void) {
+	switch(menu.currentMenu) {
+		// emulated EEPROM page 2
+		case MENU_GLOBAL:
+		case MENU_CV:
+			return 2;
+		// emulated EEPROM pages 0 & 1
+		default:
+			return menu.currentChannel;
+	}
 }
 
 /*
  *	called when a parameter has been edited, writes the current channel or
  *	global settings (determined on current menu context) to non-volatile memory.
  *	
- *	this shouldn't be too bad to the physical NVM as the buffer implemented in the 
- *	emulated EEPROM service will only write to physical NVM when a different channel
- *	context is edited, or on BOD
+ *	this only packs the page into the NVM write-back cache, the physical write
+ *	happens later in nvmCommitTask() once edits have settled, or on BOD. nothing
+ *	is packed at all if no parameter on the page was touched
 */
 static inline void writeNVM(void) {
+	if (!nvmCacheIsDirty(getMenuNvmPage())) {
+		return;
+	}
+	
 	switch(menu.currentMenu) {
 		// emulated EEPROM page 2
 		case MENU_GLOBAL:
@@ -107,17 +246,61 @@ static inline void writeNVM(void) {
 	}
 }
 
+/*
+ *	converts the number of encoder detents since the last parameter edit into
+ *	a number of parameter steps, scaled up when the encoder is turned quickly
+*/
+static inline uint8_t getEncoderSteps(uint8_t count) {
+	uint32_t detentTime = (*menu.rtcCurrentCount - menu.lastDetent) / count;
+	uint16_t steps = count;
+	
+	menu.lastDetent = *menu.rtcCurrentCount;
+	
+	for (uint8_t i=0; i<ENC_ACCEL_STAGES; i++) {
+		if (detentTime < encAccelTimes[i]) {
+			steps *= encAccelMultipliers[i];
+			break;
+		}
+	}
+	
+	return (steps > ENC_ACCEL_MAX_STEPS) ? ENC_ACCEL_MAX_STEPS : steps;
+}
+
+/*
+ *	apply a batch of encoder detents to the selected parameter. channel edits
+ *	are bracketed so the settings are only published to processing once the
+ *	whole update (value, CV selection, etc) is complete
+*/
+static inline void editMenuParam(bool inc, uint8_t count) {
+	uint8_t page = getMenuNvmPage();
+	
+	// emulated EEPROM pages 0 & 1 are the channels
+	if (page < 2) {
+		beginChannelEdit(&chan[page]);
+	}
+	
+	updateMenuParam(inc, count, getEncoderSteps(count));
+	
+	if (page < 2) {
+		endChannelEdit(&chan[page]);
+	}
+	
+	nvmCacheMarkDirty(page);
+}
+
 /*
  *	initialize all menus with their default values, draw default menu
 */
 void menuInit(uint32_t *currentCount, const char *version) {
-	sprintf(globalTitleScreen, "Global          v%s", version);
+	uint8_t len = textCopy(globalTitleScreen, sizeof(globalTitleScreen), "Global          v");
+	
+	textCopy(&globalTitleScreen[len], sizeof(globalTitleScreen) - len, version);
 	
 	globalMenu.title = globalTitleScreen;
 	globalMenu.strings = globalSettingsStrings;
 	globalMenu.params = globalSettings.globalSettingsParams;
 	globalMenu.defaults = globalSettings.globalSettingsDefaults;
-	globalMenu.num_elements = 6;
+	globalMenu.num_elements = 12;
 	globalMenu.current_selection = 0;
 	globalMenu.current_page = 0;
 	globalMenu.paramEdit = false;
@@ -135,7 +318,7 @@ void menuInit(uint32_t *currentCount, const char *version) {
 	inputs1Menu.strings = inputsMenuStrings;
 	inputs1Menu.params = chan[0].inputsMenuParams;
 	inputs1Menu.defaults = chan[0].inputsMenuDefaults;
-	inputs1Menu.num_elements = 7;
+	inputs1Menu.num_elements = 21;
 	inputs1Menu.current_selection = 0;
 	inputs1Menu.current_page = 0;
 	inputs1Menu.paramEdit = false;
@@ -144,7 +327,7 @@ void menuInit(uint32_t *currentCount, const char *version) {
 	outputs1Menu.strings = outputsMenuStrings;
 	outputs1Menu.params = chan[0].outputsMenuParams;
 	outputs1Menu.defaults = chan[0].outputsMenuDefaults;
-	outputs1Menu.num_elements = 15;
+	outputs1Menu.num_elements = 35;
 	outputs1Menu.current_selection = 0;
 	outputs1Menu.current_page = 0;
 	outputs1Menu.paramEdit = false;
@@ -162,7 +345,7 @@ void menuInit(uint32_t *currentCount, const char *version) {
 	inputs2Menu.strings = inputsMenuStrings;
 	inputs2Menu.params = chan[1].inputsMenuParams;
 	inputs2Menu.defaults = chan[1].inputsMenuDefaults;
-	inputs2Menu.num_elements = 7;
+	inputs2Menu.num_elements = 21;
 	inputs2Menu.current_selection = 0;
 	inputs2Menu.current_page = 0;
 	inputs2Menu.paramEdit = false;
@@ -171,7 +354,7 @@ void menuInit(uint32_t *currentCount, const char *version) {
 	outputs2Menu.strings = outputsMenuStrings;
 	outputs2Menu.params = chan[1].outputsMenuParams;
 	outputs2Menu.defaults = chan[1].outputsMenuDefaults;
-	outputs2Menu.num_elements = 15;
+	outputs2Menu.num_elements = 35;
 	outputs2Menu.current_selection = 0;
 	outputs2Menu.current_page = 0;
 	outputs2Menu.paramEdit = false;
@@ -185,25 +368,44 @@ void menuInit(uint32_t *currentCount, const char *version) {
 	cvMenu.current_page = 0;
 	cvMenu.paramEdit = false;
 	
-	// assign and initialize framebuffers
+	// assign framebuffers, drawn a menu at a time by menuDrawNext()
 	for (uint8_t i=0; i<MENU_COUNT; i++) {
 		menuList[i]->fbPointer = framebuffers[i];
-		gfx_mono_set_framebuffer(menuList[i]->fbPointer);
-		gfx_mono_menu_init(menuList[i]);
 	}
 	
 	menu.currentMenu = DEFAULT_MENU;
 	menu.currentChannel = 0;
 	menu.actionFlag = ACTION_NONE;
 	menu.lastInput = 0;
+	menu.lastDetent = 0;
 	menu.enc_count = 0;
 	menu.screenSaved = false;
 	menu.drawQueue = 0;
+	menu.staleMenus = 0xFF;
+	menu.ready = false;
 	menu.rtcCurrentCount = currentCount;
 	
 	gfx_mono_set_framebuffer(menuList[menu.currentMenu]->fbPointer);
 }
 
+/*
+ *	draw the next stale menu into its framebuffer, used at boot to bring the
+ *	menus up one per processing loop. returns false once all menus are drawn
+*/
+bool menuDrawNext(void) {
+	for (uint8_t i=0; i<MENU_COUNT; i++) {
+		if (menu.staleMenus & (1 << i)) {
+			menu.staleMenus &= ~(1 << i);
+			gfx_mono_set_framebuffer(menuList[i]->fbPointer);
+			gfx_mono_menu_init(menuList[i]);
+			return true;
+		}
+	}
+	
+	gfx_mono_set_framebuffer(menuList[menu.currentMenu]->fbPointer);
+	return false;
+}
+
 /*
  *	initialize TC & screen draw callback
 */
@@ -225,9 +427,14 @@ void screenDrawInit(struct tc_module *tc_instance) {
 	tc_init(menu.tc, TC3, &conf);
 	tc_enable(menu.tc);
 	
+	// below the output timer, so drawing never holds up an output edge
+	system_interrupt_set_priority(SYSTEM_INTERRUPT_MODULE_TC3, SYSTEM_INTERRUPT_PRIORITY_LEVEL_1);
+	
 	// register & enable our callback
 	tc_register_callback(menu.tc, screenDrawCallback, TC_CALLBACK_CC_CHANNEL0);
 	tc_enable_callback(menu.tc, TC_CALLBACK_CC_CHANNEL0);
+	
+	menu.ready = true;
 }
 
 /*
@@ -269,6 +476,24 @@ void setMenuFlag(uint8_t flag) {
 	menu.actionFlag = flag;
 }
 
+/*
+ *	redraw the current menu and flag all others to be redrawn when next
+ *	entered, used when settings change from outside of the menu
+*/
+void menuInvalidate(void) {
+	// still booting, have every menu drawn (again) before the display comes up
+	if (!menu.ready) {
+		menu.staleMenus = 0xFF;
+		return;
+	}
+	
+	menu.staleMenus = ~(1 << menu.currentMenu);
+	gfx_mono_menu_init(menuList[menu.currentMenu]);
+	
+	menu.drawQueue += 1;
+	tc_enable_callback(menu.tc, TC_CALLBACK_CC_CHANNEL0);
+}
+
 /*
  *	check the current action flag and process action if applicable
 */
@@ -330,9 +555,9 @@ void processActionInc(void) {
 		}
 	}
 	else {	// else if we're in paramEdit mode
-		for (i=0; i<menu.enc_count; i++) {
-			updateParamTable[menu.currentMenu](true);	// this is a function call :)
-		}
+		// apply the whole batch of detents as a single (accelerated) update
+		editMenuParam(true, menu.enc_count);
+		
 		// write the change to the framebuffer
 		gfx_mono_menu_update_parameter(menuList[menu.currentMenu]);
 	}
@@ -355,9 +580,9 @@ void processActionDec(void) {
 		}
 	}
 	else {	// else if we're in paramEdit mode
-		for (i=0; i<count; i++) {
-			updateParamTable[menu.currentMenu](false);	// this is a function call :)
-		}
+		// apply the whole batch of detents as a single (accelerated) update
+		editMenuParam(false, count);
+		
 		// write the change to the framebuffer
 		gfx_mono_menu_update_parameter(menuList[menu.currentMenu]);
 	}
@@ -367,139 +592,72 @@ void processActionDec(void) {
 }
 
 /*
- *	utility function for determining which parameter to update within the 
- *	global settings menu, only called if in paramEdit mode
+ *	get the settings struct a menu parameter's descriptor is relative to, for
+ *	the current channel context
 */
-static void updateGlobalMenuParam(bool inc) {
-	switch (menuList[menu.currentMenu]->current_selection) {
-		case 3:	// reset
-			updateChReset(&globalSettings, inc);
-			break;
-		case 4:	// long-press time
-			updateLongPressTime(&globalSettings, inc);
-			break;
-		case 5:	// screen saver time
-			updateScreenSaverTime(&globalSettings, inc);
-	}
-}
-
-/*
- *	utility function for determining which parameter to update within the
- *	channel menu, only called if in paramEdit mode
-*/
-static void updateChannelMenuParam(bool inc) {
-	switch (menuList[menu.currentMenu]->current_selection) {
-		case 1:	// op 1
-			updateOp(&chan[menu.currentChannel], 0, inc);
-			break;
-		case 2:	// op 2
-			updateOp(&chan[menu.currentChannel], 1, inc);
-			break;
+static inline void *getParamBase(uint8_t base) {
+	struct Channel *ch = &chan[menu.currentChannel];
+	
+	switch (base) {
+		case BASE_GLOBAL:
+			return &globalSettings;
+		case BASE_CHANNEL:
+			return ch;
+		case BASE_INPUT_1:
+		case BASE_INPUT_2:
+			return &ch->input.input_settings[base - BASE_INPUT_1];
+		case BASE_OUTPUT_1:
+		case BASE_OUTPUT_2:
+			return &ch->out.output_settings[base - BASE_OUTPUT_1];
+		case BASE_CV_1:
+		case BASE_CV_2:
+			return &cv_instance.settings[base - BASE_CV_1];
+		case BASE_CLOCK:
+			return &masterClock.settings;
+		default:
+			return NULL;
 	}
 }
 
 /*
- *	utility function for determining which parameter to update within the
- *	inputs menu, only called if in paramEdit mode
+ *	get the struct a menu parameter's display string & 'default' state are
+ *	relative to, the settings struct itself unless it's kept in the snapshots
 */
-static void updateInputsMenuParam(bool inc) {	
-	switch (menuList[menu.currentMenu]->current_selection) {
-		case 0:	// in1 threshold
-			updateThreshold(&chan[menu.currentChannel].input.input_settings[0], inc);
-			break;
-		case 1:	// in1 hysteresis
-			updateHys(&chan[menu.currentChannel].input.input_settings[0], inc);
-			break;
-		case 2:	// in1 invert
-			updateInvert(&chan[menu.currentChannel].input.input_settings[0], inc);
-			break;
-		case 3: // in2 copy in1
-			updateCopyIn1(&chan[menu.currentChannel].input, inc);
-			break;
-		case 4:	// in2 threshold
-			updateThreshold(&chan[menu.currentChannel].input.input_settings[1], inc);
-			break;
-		case 5:	// in2 hysteresis
-			updateHys(&chan[menu.currentChannel].input.input_settings[1], inc);
-			break;
-		case 6:	// in2 invert
-			updateInvert(&chan[menu.currentChannel].input.input_settings[1], inc);
-			break;
+static inline void *getParamDisplay(uint8_t base) {
+	struct Channel *ch = &chan[menu.currentChannel];
+	
+	switch (base) {
+		case BASE_INPUT_1:
+		case BASE_INPUT_2:
+			return &ch->input.input_display[base - BASE_INPUT_1];
+		case BASE_OUTPUT_1:
+		case BASE_OUTPUT_2:
+			return &ch->out.output_display[base - BASE_OUTPUT_1];
+		default:
+			return getParamBase(base);
 	}
 }
 
 /*
- *	utility function for determining which parameter to update within the
- *	outputs menu, only called if in paramEdit mode
+ *	update the currently selected parameter using its descriptor & refresh
+ *	its string, only called if in paramEdit mode
+ *	note: enumerated parameters & CV selections move one option per detent,
+ *	      only numeric parameters take the accelerated 'steps'
 */
-static void updateOutputsMenuParam(bool inc) {	
-	switch (menuList[menu.currentMenu]->current_selection) {
-		case 0:	// out1 clock division
-			updateClkDiv(&chan[menu.currentChannel].out.output_settings[0], inc);
-			break;
-		case 1:		// out1 division phase
-			updateClkPhase(&chan[menu.currentChannel].out.output_settings[0], inc);
-			break;
-		case 2:		// out1 division reset input
-			updateDivRst(&chan[menu.currentChannel].out.output_settings[0], inc);
-			break;
-		case 3:		// out1 delay
-			updateDelay(&chan[menu.currentChannel].out.output_settings[0], inc);
-			break;
-		case 4:		// out1 probability
-			updateProbability(&chan[menu.currentChannel].out.output_settings[0], inc);
-			break;
-		case 5:		// out1 trig mode
-			updateTrig(&chan[menu.currentChannel].out.output_settings[0], inc);
-			break;
-		case 6:		// out1 trig length
-			updateTrigLen(&chan[menu.currentChannel].out.output_settings[0], inc);
-			break;
-		case 7:		// out2 settings mode
-			updateOut2Settings(&chan[menu.currentChannel].out, inc);
-			break;
-		case 8:		// out2 clock division
-			updateClkDiv(&chan[menu.currentChannel].out.output_settings[1], inc);
-			break;
-		case 9:		// out2 division phase
-			updateClkPhase(&chan[menu.currentChannel].out.output_settings[1], inc);
-			break;
-		case 10:	// out2 division reset input
-			updateDivRst(&chan[menu.currentChannel].out.output_settings[1], inc);
-			break;
-		case 11:	// out2 delay
-			updateDelay(&chan[menu.currentChannel].out.output_settings[1], inc);
-			break;
-		case 12:	// out2 probability
-			updateProbability(&chan[menu.currentChannel].out.output_settings[1], inc);
-			break;
-		case 13:	// out2 trig mode
-			updateTrig(&chan[menu.currentChannel].out.output_settings[1], inc);
-			break;
-		case 14:	// out2 trig length
-			updateTrigLen(&chan[menu.currentChannel].out.output_settings[1], inc);
-			break;
+static void updateMenuParam(bool inc, uint8_t detents, uint8_t steps) {
+	const struct MenuParam *param = &menuParamTable[menu.currentMenu][menuList[menu.currentMenu]->current_selection];
+	void *base = getParamBase(param->base);
+	
+	if (param->desc == NULL) {	// submenu
+		return;
 	}
-}
-
-/*
- *	utility function for determining which parameter to update within the
- *	CV menu, only called if in paramEdit mode
-*/
-static void updateCvMenuParam(bool inc) {	
-	switch (menuList[menu.currentMenu]->current_selection) {
-		case 0:	// CV1 range
-			updateCvRange(&cv_instance.settings[0], inc);
-			break;
-		case 1:	// CV1 threshold
-			updateCvThreshold(&cv_instance.settings[0], inc);
-			break;
-		case 2:	// CV2 range
-			updateCvRange(&cv_instance.settings[1], inc);
-			break;
-		case 3:	// CV2 threshold
-			updateCvThreshold(&cv_instance.settings[1], inc);
-			break;
+	
+	paramUpdate(param->desc, base, inc, detents, steps);
+	paramRender(param->desc, base, getParamDisplay(param->base));
+	
+	// long-press time applies straight away
+	if (param->desc == &globalParams[GLOBAL_PARAM_LONG_PRESS]) {
+		writeLongPressTimes(globalSettings.longPressTime);
 	}
 }
 
@@ -515,6 +673,11 @@ void processActionEnter(void) {
 		if (menu.currentMenu == MENU_GLOBAL && menuList[menu.currentMenu]->current_selection == 3) {
 			checkReset();
 		}
+		// check to see if we need to save or load a preset
+		if (menu.currentMenu == MENU_GLOBAL && (menuList[menu.currentMenu]->current_selection == 6 ||
+				menuList[menu.currentMenu]->current_selection == 7)) {
+			checkPreset();
+		}
 		gfx_mono_menu_toggle_mode(menuList[menu.currentMenu]);
 		writeNVM();
 	}
@@ -543,9 +706,15 @@ static void globalMenuEnter(void) {
 		case 3:	// reset
 		case 4:	// long-press time
 		case 5:	// screen saver time
-		case 6:	// display contrast
+		case 6:	// save preset
+		case 7:	// load preset
+		case 8:	// preset CV
+		case 9:	// clock BPM
+		case 10:	// clock swing
 			gfx_mono_menu_toggle_mode(menuList[menu.currentMenu]);
 			break;
+		case 11:	// boot time, display only
+			break;
 	}
 }
 
@@ -720,12 +889,40 @@ void checkReset(void) {
 		gfx_mono_set_framebuffer(menuList[menu.currentMenu]->fbPointer);
 		
 		// update reset setting back to default
-		globalSettings.chReset = RESET_NONE;
-		sprintf(globalSettings.chResetStr, "None");
+		paramSetDefault(&globalParams[GLOBAL_PARAM_RESET], &globalSettings);
+		paramRender(&globalParams[GLOBAL_PARAM_RESET], &globalSettings, &globalSettings);
 		menuList[menu.currentMenu]->current_selection = 3;
 		gfx_mono_menu_update_parameter(menuList[menu.currentMenu]);
 		
 		// re-enable screen draw callback
 		tc_enable_callback(menu.tc, TC_CALLBACK_CC_CHANNEL0);
 	}
+}
+
+/*
+ *	check if a preset slot has been selected to save to or load from. saving
+ *	writes the current settings to the slot, loading stages the slot to be
+ *	swapped in on the next processing tick
+*/
+void checkPreset(void) {
+	if (globalSettings.presetSave != PRESET_NONE) {
+		presetSave(globalSettings.presetSave - 1);
+	}
+	
+	// show 'empty' if there's nothing saved in the slot to load
+	if (globalSettings.presetRecall != PRESET_NONE) {
+		if (!presetStage(globalSettings.presetRecall - 1)) {
+			globalSettings.presetRecall = PRESET_NONE;
+			textCopy(globalSettings.presetRecallStr, GFX_MONO_MENU_PARAM_MAX_CHAR, "empty");
+			gfx_mono_menu_update_parameter(menuList[menu.currentMenu]);
+			return;
+		}
+	}
+	
+	// update slot selections back to default
+	paramSetDefault(&globalParams[GLOBAL_PARAM_PRESET_SAVE], &globalSettings);
+	paramSetDefault(&globalParams[GLOBAL_PARAM_PRESET_RECALL], &globalSettings);
+	paramRender(&globalParams[GLOBAL_PARAM_PRESET_SAVE], &globalSettings, &globalSettings);
+	paramRender(&globalParams[GLOBAL_PARAM_PRESET_RECALL], &globalSettings, &globalSettings);
+	gfx_mono_menu_update_parameter(menuList[menu.currentMenu]);
 }
\ No newline at end of file
@@ -6,7 +6,6 @@
 #ifndef MENU_H_
 #define MENU_H_
 
-#include <stdio.h>
 #include <ssd1306.h>
 #include "gfx_mono_menu.h"
 #include "rtc_count.h"
@@ -49,8 +48,14 @@ struct Menu {
 	uint32_t *rtcCurrentCount;	// pointer to the current RTC count (updated on processing
 								// loop start)
 	uint32_t lastInput;			// keeps track of time since most recent action
+	uint32_t lastDetent;		// RTC count of the most recent parameter edit, used
+								// to measure encoder speed for acceleration
 	bool screenSaved;			// true when no input for *screenSaverTime* minutes
 	uint8_t drawQueue;
+	uint8_t staleMenus;			// bitmask of menus to redraw when next entered, set when
+								// settings change outside of the menu (preset recall)
+	bool ready;					// false until the display & screen draw TC are up, the
+								// menus are brought up after processing starts at boot
 	
 	struct tc_module *tc;		// 10kHz TC module for drawing to screen 
 	};
@@ -67,10 +72,12 @@ struct gfx_mono_menu cvMenu;
 struct Menu menu;
 
 void menuInit(uint32_t *currentCount, const char *version);
+bool menuDrawNext(void);
 void screenDrawInit(struct tc_module *tc_instance);
 void screenDrawCallback(struct tc_module *const tc_instance);
 
 void setMenuFlag(uint8_t flag);
+void menuInvalidate(void);
 void processMenuAction(void);
 
 void processActionNone(void);
@@ -83,6 +90,7 @@ void processActionCh2(void);
 void processActionGlobal(void);
 void processActionCv(void);
 void checkReset(void);
+void checkPreset(void);
 
 // generalized pointer to a menu process function to be used in conjunction
 // with the action flags
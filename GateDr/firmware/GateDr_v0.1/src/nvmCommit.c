@@ -0,0 +1,173 @@
+/*
+ * source file for the deferred NVM commit engine
+ *
+ * settings writes land in a RAM image of each page and are committed to the
+ * emulated EEPROM by a small state machine, called once per processing loop,
+ * which performs at most one emulator operation per call. an operation isn't
+ * one flash operation though: when the page's row is full, writing it has the
+ * emulator move the row's other page to the spare row & erase the old row, so
+ * the worst case for a single call is one page write plus one row erase
+ * (about 8.5ms at the datasheet maximums of 2.5ms & 6ms, typically much less),
+ * during which the CPU stalls on any flash access. tools/host/replay checks
+ * that bound against the emulator over a simulated flash area. edits are held off
+ * until they settle so repeated changes to the same page coalesce into a
+ * single commit. on BOD, nvmCommitFlush() commits the page already in the
+ * emulator page buffer and then writes & commits every page still held off,
+ * the most recently edited first
+ *
+ * pages are compared against what the emulator holds for them, so packing a
+ * page that hasn't actually changed (or was changed and then changed back)
+ * never reaches the emulator. the stored copy is read back from the emulator
+ * rather than kept in RAM
+ */ 
+
+#include "nvmCommit.h"
+
+// helper function declaration
+static void flushPage(uint8_t page);
+
+// time (in ms) a page must go unedited before it is committed
+#define NVM_COMMIT_HOLDOFF	3000
+
+/*
+ *	initialize the cache & commit engine, must be called before any settings
+ *	are written
+*/
+void nvmCacheInit(uint32_t *currentCount) {
+	nvm_cache.pending = 0;
+	nvm_cache.dirty = 0;
+	nvm_cache.state = NVM_IDLE;
+	nvm_cache.page = 0;
+	nvm_cache.lastPage = 0;
+	nvm_cache.busy = false;
+	nvm_cache.lastEdit = 0;
+	nvm_cache.rtcCurrentCount = currentCount;
+}
+
+/*
+ *	seed the cache with a page just read from NVM, so later writes of the same
+ *	contents are skipped
+*/
+void nvmCacheLoadPage(uint8_t page, const uint8_t *data) {
+	memcpy(nvm_cache.image[page], data, EEPROM_PAGE_SIZE);
+	nvm_cache.pending &= ~(1 << page);
+	nvm_cache.dirty &= ~(1 << page);
+}
+
+/*
+ *	copy a packed settings page into the cache and mark it for a deferred commit
+ *	if the contents differ from what's stored in NVM
+*/
+void nvmCacheWritePage(uint8_t page, const uint8_t *data) {
+	uint8_t stored[EEPROM_PAGE_SIZE];
+	
+	nvm_cache.dirty &= ~(1 << page);
+	
+	// skip the copy entirely if nothing changed since the last write
+	if (memcmp(nvm_cache.image[page], data, EEPROM_PAGE_SIZE) == 0) {
+		return;
+	}
+	
+	// a BOD flush passes over the page while its image is half copied, and
+	// writes it out as soon as it's whole
+	nvm_cache.pending &= ~(1 << page);
+	memcpy(nvm_cache.image[page], data, EEPROM_PAGE_SIZE);
+	nvm_cache.pending |= (1 << page);
+	nvm_cache.lastEdit = *nvm_cache.rtcCurrentCount;
+	nvm_cache.lastPage = page;
+	
+	// the emulator's copy includes a page written but not yet committed. a
+	// BOD flush landing in this read only leaves the compare stale, the page
+	// is already written out by then
+	if ((eeprom_emulator_read_page(page, stored) == STATUS_OK) &&
+			(memcmp(nvm_cache.image[page], stored, EEPROM_PAGE_SIZE) == 0)) {
+		// edited back to the stored contents, cancel any pending commit
+		nvm_cache.pending &= ~(1 << page);
+	}
+}
+
+/*
+ *	flag a page as having edited settings that will need packing
+*/
+void nvmCacheMarkDirty(uint8_t page) {
+	nvm_cache.dirty |= (1 << page);
+}
+
+/*
+ *	check if a page has edited settings that haven't been packed yet
+*/
+bool nvmCacheIsDirty(uint8_t page) {
+	return nvm_cache.dirty & (1 << page);
+}
+
+/*
+ *	advance the commit engine by a single step, called between processing
+ *	ticks so a commit never holds the outputs for more than one emulator
+ *	operation, at worst a page write & a row erase (see above)
+*/
+void nvmCommitTask(void) {
+	switch (nvm_cache.state) {
+		case NVM_IDLE:
+			if (nvm_cache.pending && 
+					((*nvm_cache.rtcCurrentCount - nvm_cache.lastEdit) >= NVM_COMMIT_HOLDOFF)) {
+				// pick the lowest pending page
+				nvm_cache.page = 0;
+				while (!(nvm_cache.pending & (1 << nvm_cache.page))) {
+					nvm_cache.page++;
+				}
+				nvm_cache.state = NVM_WRITE_PAGE;
+			}
+			break;
+		case NVM_WRITE_PAGE:
+			// clear the pending bit first, an edit from here on re-queues the page
+			nvm_cache.pending &= ~(1 << nvm_cache.page);
+			nvm_cache.busy = true;
+			eeprom_emulator_write_page(nvm_cache.page, nvm_cache.image[nvm_cache.page]);
+			nvm_cache.busy = false;
+			nvm_cache.state = NVM_COMMIT_PAGE;
+			break;
+		case NVM_COMMIT_PAGE:
+			nvm_cache.busy = true;
+			eeprom_emulator_commit_page_buffer();
+			nvm_cache.busy = false;
+			nvm_cache.state = NVM_IDLE;
+			break;
+	}
+}
+
+/*
+ *	called from the BOD interrupt, commits the page already in the emulator
+ *	page buffer then writes out every pending page without waiting on the
+ *	holdoff, the most recently edited first in case the supply doesn't last.
+ *	the emulator isn't reentrant, so nothing is done if the interrupt landed
+ *	in the middle of another emulator call, the previously committed copies
+ *	are still good
+*/
+void nvmCommitFlush(void) {
+	if (nvm_cache.busy) {
+		return;
+	}
+	
+	eeprom_emulator_commit_page_buffer();
+	
+	if (nvm_cache.pending & (1 << nvm_cache.lastPage)) {
+		flushPage(nvm_cache.lastPage);
+	}
+	for (uint8_t i = 0; i < NVM_PAGE_COUNT; i++) {
+		if (nvm_cache.pending & (1 << i)) {
+			flushPage(i);
+		}
+	}
+	
+	// the supply may recover, start the engine over
+	nvm_cache.state = NVM_IDLE;
+}
+
+/*
+ *	write & commit a pending page straight away
+*/
+static void flushPage(uint8_t page) {
+	nvm_cache.pending &= ~(1 << page);
+	eeprom_emulator_write_page(page, nvm_cache.image[page]);
+	eeprom_emulator_commit_page_buffer();
+}
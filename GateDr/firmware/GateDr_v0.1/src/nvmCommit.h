@@ -0,0 +1,50 @@
+/*
+ *	write-back cache and deferred commit engine for the emulated EEPROM
+ *	settings pages
+ */ 
+
+
+#ifndef NVMCOMMIT_H_
+#define NVMCOMMIT_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>		// for memcpy()
+#include "eeprom.h"
+
+// logical emulated EEPROM pages cached in RAM:
+// 0 & 1 for the channels, 2 for the global & CV settings, followed by a copy
+// of those three pages per preset slot (3-5, 6-8, 9-11)
+#define NVM_SETTINGS_PAGES	3
+#define NVM_PRESET_COUNT	3
+#define NVM_PAGE_COUNT		(NVM_SETTINGS_PAGES * (NVM_PRESET_COUNT + 1))
+
+enum NvmCommitState {
+	NVM_IDLE,			// waiting for edits to settle
+	NVM_WRITE_PAGE,		// copy the next pending page into the emulator page buffer
+	NVM_COMMIT_PAGE		// commit the emulator page buffer to physical NVM
+	};
+
+struct NvmCache {
+	uint8_t image[NVM_PAGE_COUNT][EEPROM_PAGE_SIZE];	// most recent packed settings pages
+	volatile uint16_t pending;	// bitmask of pages that differ from their committed contents
+	uint16_t dirty;				// bitmask of pages with settings edited since they were last packed
+	uint8_t state;				// commit engine state, as per above enum
+	uint8_t page;				// page currently being committed
+	uint8_t lastPage;			// page of the most recent edit, first to go on BOD
+	volatile bool busy;			// set while the commit engine is inside an emulator call
+	uint32_t lastEdit;			// RTC count of the most recent page edit
+	uint32_t *rtcCurrentCount;	// current RTC count (updated on processing loop start)
+	};
+
+struct NvmCache nvm_cache;
+
+void nvmCacheInit(uint32_t *currentCount);
+void nvmCacheLoadPage(uint8_t page, const uint8_t *data);
+void nvmCacheWritePage(uint8_t page, const uint8_t *data);
+void nvmCacheMarkDirty(uint8_t page);
+bool nvmCacheIsDirty(uint8_t page);
+void nvmCommitTask(void);
+void nvmCommitFlush(void);
+
+#endif /* NVMCOMMIT_H_ */
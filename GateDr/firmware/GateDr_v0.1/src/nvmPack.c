@@ -0,0 +1,149 @@
+/*
+ * source file for the NVM page format and bit-packing helpers
+ */ 
+
+#include "nvmPack.h"
+
+// helper function declaration
+static inline uint8_t getFieldBits(uint32_t range);
+
+/*
+ *	number of bits needed to store an offset of 0 to 'range'
+*/
+static inline uint8_t getFieldBits(uint32_t range) {
+	uint8_t bits = 0;
+	
+	while (range) {
+		bits++;
+		range >>= 1;
+	}
+	
+	return bits;
+}
+
+/*
+ *	point a packer at the payload of a page buffer, just past the header
+*/
+void nvmPackInit(struct NvmPacker *packer, uint8_t *buffer) {
+	packer->buffer = buffer;
+	packer->bitPos = NVM_HEADER_SIZE * 8;
+	packer->bitEnd = EEPROM_PAGE_SIZE * 8;
+	packer->overflow = false;
+}
+
+/*
+ *	move a packer to a fixed bit position in the page, for fields kept at a set
+ *	place rather than in sequence
+*/
+void nvmPackSeek(struct NvmPacker *packer, uint16_t bitPos) {
+	packer->bitPos = bitPos;
+}
+
+/*
+ *	end the region a packer reads/writes at 'bitEnd', so a run of fields can't
+ *	spill into a fixed place further on. a field reaching it is cut short, and
+ *	reads back as its default
+*/
+void nvmPackLimit(struct NvmPacker *packer, uint16_t bitEnd) {
+	packer->bitEnd = bitEnd;
+}
+
+/*
+ *	write a field as an offset from its minimum, LSB first. the buffer is 
+ *	expected to be zeroed beforehand
+*/
+void nvmPackField(struct NvmPacker *packer, int32_t value, int32_t min, int32_t max) {
+	uint8_t bits = getFieldBits(max - min);
+	uint32_t offset = value - min;
+	
+	for (uint8_t i=0; i<bits; i++) {
+		if (packer->bitPos >= packer->bitEnd) {	// region overflow check
+			packer->overflow = true;
+			return;
+		}
+		if (offset & (1UL << i)) {
+			packer->buffer[packer->bitPos >> 3] |= (1 << (packer->bitPos & 0x7));
+		}
+		packer->bitPos++;
+	}
+}
+
+/*
+ *	read back a field written by nvmPackField(), falling back to the default
+ *	if the stored value is outside of the field's range
+*/
+int32_t nvmUnpackField(struct NvmPacker *packer, int32_t min, int32_t max, int32_t def) {
+	uint8_t bits = getFieldBits(max - min);
+	uint32_t offset = 0;
+	
+	for (uint8_t i=0; i<bits; i++) {
+		if (packer->bitPos >= packer->bitEnd) {	// region overflow check
+			packer->overflow = true;
+			return def;
+		}
+		if (packer->buffer[packer->bitPos >> 3] & (1 << (packer->bitPos & 0x7))) {
+			offset |= (1UL << i);
+		}
+		packer->bitPos++;
+	}
+	
+	return nvmValidateField(min + (int32_t)offset, min, max, def);
+}
+
+/*
+ *	range check for a single field, used when migrating legacy pages
+*/
+int32_t nvmValidateField(int32_t value, int32_t min, int32_t max, int32_t def) {
+	return ((value < min) || (value > max)) ? def : value;
+}
+
+/*
+ *	write the header & CRC for a fully packed page
+*/
+void nvmSealPage(uint8_t *buffer) {
+	uint16_t crc = nvmCrc16(&buffer[NVM_HEADER_SIZE], EEPROM_PAGE_SIZE - NVM_HEADER_SIZE);
+	
+	buffer[0] = NVM_SCHEMA_MAGIC;
+	buffer[1] = NVM_SCHEMA_VERSION;
+	buffer[2] = (uint8_t)((crc >> 8) & 0xFF);
+	buffer[3] = (uint8_t)(crc & 0xFF);
+}
+
+/*
+ *	check a page read from NVM, returning a status as per the NvmPageStatus
+ *	enum and the schema version the page was written with
+*/
+uint8_t nvmCheckPage(const uint8_t *buffer, uint8_t *version) {
+	uint16_t crc;
+	
+	if (buffer[0] != NVM_SCHEMA_MAGIC) {
+		*version = 0;
+		return NVM_PAGE_LEGACY;
+	}
+	
+	*version = buffer[1];
+	crc = nvmCrc16(&buffer[NVM_HEADER_SIZE], EEPROM_PAGE_SIZE - NVM_HEADER_SIZE);
+	
+	if ((buffer[2] != (uint8_t)((crc >> 8) & 0xFF)) || (buffer[3] != (uint8_t)(crc & 0xFF))) {
+		return NVM_PAGE_CORRUPT;
+	}
+	
+	return NVM_PAGE_VALID;
+}
+
+/*
+ *	CRC-16/CCITT (poly 0x1021, init 0xFFFF), bitwise to keep the flash cost
+ *	down since it only runs at boot and when a page is packed
+*/
+uint16_t nvmCrc16(const uint8_t *data, uint16_t length) {
+	uint16_t crc = 0xFFFF;
+	
+	for (uint16_t i=0; i<length; i++) {
+		crc ^= (uint16_t)data[i] << 8;
+		for (uint8_t j=0; j<8; j++) {
+			crc = (crc & 0x8000) ? ((crc << 1) ^ 0x1021) : (crc << 1);
+		}
+	}
+	
+	return crc;
+}
@@ -0,0 +1,62 @@
+/*
+ *	versioned, CRC-protected page format and bit-packing helpers for
+ *	settings stored in non-volatile memory
+ */ 
+
+
+#ifndef NVMPACK_H_
+#define NVMPACK_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "eeprom.h"		// for EEPROM_PAGE_SIZE
+
+// page header: magic byte, schema version, CRC16 of the rest of the page.
+// the magic byte can't appear as the first byte of a legacy (v0) page, which
+// starts with either the high byte of a threshold or a CV range
+#define NVM_SCHEMA_MAGIC	0xD7
+// v2: preset recall CV appended to the global page
+// v3: output clock multiplier appended to the channel pages
+// v4: output clock divider duty appended to the channel pages
+// v5: output euclidean pattern appended to the channel pages
+// v6: output loop probability mode appended, loop registers at the channel page end
+// v7: output burst appended to the channel pages
+// v8: input source appended to the channel pages, master clock to the global page
+// v9: input minimum pulse width filter appended to the channel pages
+// v10: input window comparator mode appended to the channel pages
+// v11: input slope detection appended to the channel pages
+// v12: channel page settings packed from one table per input & output, the
+//      unreleased v1-v11 channel pages are reset to defaults
+#define NVM_SCHEMA_VERSION	12
+#define NVM_HEADER_SIZE		4
+
+enum NvmPageStatus {
+	NVM_PAGE_VALID,		// header & CRC check out
+	NVM_PAGE_LEGACY,	// no header, raw byte layout from before versioning
+	NVM_PAGE_CORRUPT	// header present but CRC mismatch
+	};
+
+/*
+ *	sequential bit reader/writer over a page payload. each field is stored as
+ *	an offset from its minimum, using just enough bits for its range, so
+ *	changing a parameter's range requires a schema version bump
+*/
+struct NvmPacker {
+	uint8_t *buffer;
+	uint16_t bitPos;
+	uint16_t bitEnd;		// fields stop short of this bit, see nvmPackLimit()
+	bool overflow;			// a field was cut short at bitEnd
+	};
+
+void nvmPackInit(struct NvmPacker *packer, uint8_t *buffer);
+void nvmPackSeek(struct NvmPacker *packer, uint16_t bitPos);
+void nvmPackLimit(struct NvmPacker *packer, uint16_t bitEnd);
+void nvmPackField(struct NvmPacker *packer, int32_t value, int32_t min, int32_t max);
+int32_t nvmUnpackField(struct NvmPacker *packer, int32_t min, int32_t max, int32_t def);
+int32_t nvmValidateField(int32_t value, int32_t min, int32_t max, int32_t def);
+
+void nvmSealPage(uint8_t *buffer);
+uint8_t nvmCheckPage(const uint8_t *buffer, uint8_t *version);
+uint16_t nvmCrc16(const uint8_t *data, uint16_t length);
+
+#endif /* NVMPACK_H_ */
@@ -4,18 +4,22 @@
 
 #include "operations.h"
 
-bool op_AND(bool a, bool b, bool prev, bool i) {return a&b;}
-bool op_NAND(bool a, bool b, bool prev, bool i) {return !(a&b);}
-bool op_OR(bool a, bool b, bool prev, bool i) {return a||b;}
-bool op_NOR(bool a, bool b, bool prev, bool i) {return !(a||b);}
-bool op_XOR(bool a, bool b, bool prev, bool i) {return a!=b;}
-bool op_XNOR(bool a, bool b, bool prev, bool i) {return a==b;}
+// kept next to the ops so the CV-selected lookup stays on the RAM hot path
+HOT_CONST const op_FN op_table[9] = {op_AND, op_NAND, op_OR, op_NOR, op_XOR, op_XNOR,
+	 op_SR, op_D, op_BYP};
+
+HOT_FUNC bool op_AND(bool a, bool b, bool prev, bool i) {return a&b;}
+HOT_FUNC bool op_NAND(bool a, bool b, bool prev, bool i) {return !(a&b);}
+HOT_FUNC bool op_OR(bool a, bool b, bool prev, bool i) {return a||b;}
+HOT_FUNC bool op_NOR(bool a, bool b, bool prev, bool i) {return !(a||b);}
+HOT_FUNC bool op_XOR(bool a, bool b, bool prev, bool i) {return a!=b;}
+HOT_FUNC bool op_XNOR(bool a, bool b, bool prev, bool i) {return a==b;}
 
 /*
  *	S-R latch
  *	No change if both S=R active
 */
-bool op_SR(bool a, bool b, bool prev, bool i) {
+HOT_FUNC bool op_SR(bool a, bool b, bool prev, bool i) {
 	// set
 	if (a&!b) {
 		return true;
@@ -32,7 +36,7 @@ bool op_SR(bool a, bool b, bool prev, bool i) {
 /*
  *	D-latch
 */
-bool op_D(bool a, bool b, bool prev, bool i) {
+HOT_FUNC bool op_D(bool a, bool b, bool prev, bool i) {
 	if (b) {
 		return a;
 	}
@@ -46,6 +50,6 @@ bool op_D(bool a, bool b, bool prev, bool i) {
  *	        of the 'num' parameter indicating if the op is
  *          the first or second in the channel
 */
-bool op_BYP(bool a, bool b, bool prev, bool i) {
+HOT_FUNC bool op_BYP(bool a, bool b, bool prev, bool i) {
 	return i ? b : a;
 }
\ No newline at end of file
@@ -8,6 +8,7 @@
 
 #include <stdbool.h>
 #include <stdint.h>
+#include "hotPath.h"
 
 enum Operations {
 	OP_AND,
@@ -27,18 +28,17 @@ enum Operations {
 */
 typedef bool (*op_FN)(bool a, bool b, bool prev, bool i);
 
-bool op_AND(bool a, bool b, bool prev, bool i);
-bool op_NAND(bool a, bool b, bool prev, bool i);
-bool op_OR(bool a, bool b, bool prev, bool i);
-bool op_NOR(bool a, bool b, bool prev, bool i);
-bool op_XOR(bool a, bool b, bool prev, bool i);
-bool op_XNOR(bool a, bool b, bool prev, bool i);
-bool op_SR(bool a, bool b, bool prev, bool i);
-bool op_D(bool a, bool b, bool prev, bool i);
-bool op_BYP(bool a, bool b, bool prev, bool i);
+HOT_FUNC bool op_AND(bool a, bool b, bool prev, bool i);
+HOT_FUNC bool op_NAND(bool a, bool b, bool prev, bool i);
+HOT_FUNC bool op_OR(bool a, bool b, bool prev, bool i);
+HOT_FUNC bool op_NOR(bool a, bool b, bool prev, bool i);
+HOT_FUNC bool op_XOR(bool a, bool b, bool prev, bool i);
+HOT_FUNC bool op_XNOR(bool a, bool b, bool prev, bool i);
+HOT_FUNC bool op_SR(bool a, bool b, bool prev, bool i);
+HOT_FUNC bool op_D(bool a, bool b, bool prev, bool i);
+HOT_FUNC bool op_BYP(bool a, bool b, bool prev, bool i);
 
 // operations table to be used when channel is under CV control
-static const op_FN op_table[9] = {op_AND, op_NAND, op_OR, op_NOR, op_XOR, op_XNOR,
-	 op_SR, op_D, op_BYP};
+extern const op_FN op_table[9];
 
 #endif /* OPERATIONS_H_ */
\ No newline at end of file
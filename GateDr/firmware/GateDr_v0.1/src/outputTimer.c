@@ -0,0 +1,165 @@
+/*
+ * source file for the output timer
+ *
+ * each output has one slot holding its next known edge, and the evenly spaced
+ * edges that follow it. the processing loop writes the pins as usual and
+ * refreshes the slots, and CC0 of the timebase counter is kept on the earliest
+ * armed slot. when it matches, the interrupt writes the pin itself & moves the
+ * slot on to its following edge, so a whole burst lands on time even when a
+ * loop is held up for several edges. a loop that read the timebase before an
+ * edge landed would write the old level back, so the loop skips a pin the
+ * timer has written since its timebase read
+ */ 
+
+#include "outputTimer.h"
+#include "tc.h"
+#include "tc_interrupt.h"
+#include "port.h"
+#include "timebase.h"
+
+struct OutputTimerSlot {
+	uint8_t pin;
+	volatile bool armed;		// an edge is waiting on the timer
+	volatile uint32_t when;		// timebase count of the edge
+	volatile bool level;		// pin level from the edge
+	volatile uint32_t step;		// timebase counts to each following edge
+	volatile uint8_t edges;		// following edges, each toggling the pin
+	volatile bool fired;		// timer has written the pin since the last loop write
+	volatile uint32_t written;	// timebase count the timer wrote the pin at
+	};
+
+static struct OutputTimerSlot slots[OUTPUT_TIMER_COUNT];
+static struct tc_module *outputTimerTc;
+
+// declaration for static helper functions
+static void outputTimerService(void);
+static void outputTimerRearm(void);
+
+/*
+ *	set up the slots for the given output pins & hook CC0 of the timebase TC,
+ *	must be called after timebaseInit(). the timer runs ahead of the display
+ *	draw interrupt so a redraw never holds an edge up
+*/
+void outputTimerInit(struct tc_module *tc_instance, const uint8_t *pins) {
+	outputTimerTc = tc_instance;
+	
+	for (uint8_t i = 0; i < OUTPUT_TIMER_COUNT; i++) {
+		slots[i].pin = pins[i];
+		slots[i].armed = false;
+		slots[i].fired = false;
+	}
+	
+	system_interrupt_set_priority(SYSTEM_INTERRUPT_MODULE_TC4, SYSTEM_INTERRUPT_PRIORITY_LEVEL_0);
+	tc_register_callback(outputTimerTc, outputTimerCallback, TC_CALLBACK_CC_CHANNEL0);
+	tc_enable_callback(outputTimerTc, TC_CALLBACK_CC_CHANNEL0);
+}
+
+/*
+ *	write an output pin from the processing loop & hand its next known edge to
+ *	the timer. loopCount is the timebase count the loop processed with
+*/
+void outputTimerWrite(uint8_t out, struct OutputState *state, uint32_t loopCount) {
+	struct OutputTimerSlot *slot = &slots[out];
+	
+	system_interrupt_enter_critical_section();
+	
+	// the timer is already past this loop's view of the output
+	if (!(slot->fired && (int32_t)(slot->written - loopCount) > 0)) {
+		port_pin_set_output_level(slot->pin, state->out_processed);
+	}
+	
+	slot->fired = false;
+	slot->armed = state->timer_armed;
+	slot->when = state->timer_when;
+	slot->level = state->timer_level;
+	slot->step = state->timer_step;
+	slot->edges = state->timer_edges;
+	
+	system_interrupt_leave_critical_section();
+	
+	if (state->timer_armed) {
+		outputTimerRearm();
+	}
+}
+
+/*
+ *	CC0 match interrupt
+*/
+void outputTimerCallback(struct tc_module *const tc_instance) {
+	outputTimerService();
+	outputTimerRearm();
+}
+
+/*
+ *	land any armed edges that are due, moving each slot on to its following edge
+*/
+static void outputTimerService(void) {
+	uint32_t now = timebaseGetCount();
+	
+	system_interrupt_enter_critical_section();
+	
+	for (uint8_t i = 0; i < OUTPUT_TIMER_COUNT; i++) {
+		if (slots[i].armed && (int32_t)(now - slots[i].when) >= 0) {
+			port_pin_set_output_level(slots[i].pin, slots[i].level);
+			slots[i].fired = true;
+			slots[i].written = now;
+			
+			if (slots[i].edges != 0) {
+				slots[i].edges--;
+				slots[i].when += slots[i].step;
+				slots[i].level = !slots[i].level;
+			}
+			else {
+				slots[i].armed = false;
+			}
+		}
+	}
+	
+	system_interrupt_leave_critical_section();
+}
+
+/*
+ *	point CC0 at the earliest armed edge. an edge that's already due by the
+ *	time the compare is written would only match after the counter wraps, so
+ *	it's serviced straight away instead. called from both the loop & the
+ *	interrupt, so the whole update is kept in a critical section
+*/
+static void outputTimerRearm(void) {
+	uint32_t now;
+	int32_t next;
+	int32_t wait;
+	bool armed;
+	
+	system_interrupt_enter_critical_section();
+	
+	do {
+		armed = false;
+		next = INT32_MAX;
+		now = timebaseGetCount();
+		
+		for (uint8_t i = 0; i < OUTPUT_TIMER_COUNT; i++) {
+			if (slots[i].armed) {
+				wait = (int32_t)(slots[i].when - now);
+				next = (wait < next) ? wait : next;
+				armed = true;
+			}
+		}
+		
+		if (!armed) {
+			break;
+		}
+		
+		if (next > 1) {
+			tc_set_compare_value(outputTimerTc, TC_COMPARE_CAPTURE_CHANNEL_0, now + next);
+			
+			// check the edge didn't come due while the compare synced
+			next = (int32_t)(now + next - timebaseGetCount());
+		}
+		
+		if (next <= 1) {
+			outputTimerService();
+		}
+	} while (next <= 1);
+	
+	system_interrupt_leave_critical_section();
+}
\ No newline at end of file
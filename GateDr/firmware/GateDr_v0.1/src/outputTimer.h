@@ -0,0 +1,24 @@
+/*
+ *	output timer, lands output edges that are known ahead of time (burst
+ *	triggers) on a TC4 compare match rather than on the next processing loop,
+ *	so they stay on time while the loop is held up by the display or NVM
+ */ 
+
+
+#ifndef OUTPUTTIMER_H_
+#define OUTPUTTIMER_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "outputs.h"
+
+// outputs in pin order W, X, Y, Z
+#define OUTPUT_TIMER_COUNT	4
+
+struct tc_module;
+
+void outputTimerInit(struct tc_module *tc_instance, const uint8_t *pins);
+void outputTimerWrite(uint8_t out, struct OutputState *state, uint32_t loopCount);
+void outputTimerCallback(struct tc_module *const tc_instance);
+
+#endif /* OUTPUTTIMER_H_ */
\ No newline at end of file
@@ -3,6 +3,7 @@
  */ 
 
 #include "outputs.h"
+#include "euclidMasks.h"
 
 #define PROB_DEFAULT		100
 #define PROB_MIN			0
@@ -25,42 +26,115 @@
 #define DIV_PHASE_MIN		1
 #define DIV_PHASE_MAX		32
 #define DIV_RST_DEFAULT		DIV_RST_NONE
+#define DIV_DUTY_DEFAULT	DIV_DUTY_INPUT
+#define MULT_DEFAULT		1
+#define MULT_MIN			1
+#define MULT_MAX			16
+#define MULT_INC			1
+#define MULT_MIN_PERIOD		2		// shortest multiplied pulse period, in timebase counts
+#define EUC_STEPS_DEFAULT	1		// 1 step with 1 fill passes every pulse
+#define EUC_STEPS_MIN		1
+#define EUC_STEPS_MAX		32		// one pattern per 32 bit mask
+#define EUC_FILLS_DEFAULT	1
+#define EUC_FILLS_MIN		1
+#define EUC_FILLS_MAX		32
+#define EUC_ROTATE_DEFAULT	0
+#define EUC_ROTATE_MIN		0
+#define EUC_ROTATE_MAX		31
+#define EUC_STEP_RESTART	UINT8_MAX	// wraps the next pulse to step 0
+#define PROB_MODE_DEFAULT	PROB_MODE_ROLL
+#define PROB_LOCK_DEFAULT	0		// nothing kept, every looped bit is a fresh roll
+#define PROB_LOCK_MIN		0
+#define PROB_LOCK_MAX		100
+#define PROB_LOCK_INC		5
+#define PROB_LEN_DEFAULT	2
+#define PROB_LEN_MIN		2
+#define PROB_LEN_MAX		32		// one loop per 32 bit register
+#define BURST_COUNT_DEFAULT	1
+#define BURST_COUNT_MIN		1
+#define BURST_COUNT_MAX		16
+#define BURST_INT_DEFAULT	10
+#define BURST_INT_MIN		10
+#define BURST_INT_MAX		500
+#define BURST_INT_INC		5
+
+#define OUTPUT_FIELD(x)		offsetof(struct OutputSettings, x)
+#define OUTPUT_DISPLAY(x)	offsetof(struct OutputDisplay, x)
+
+// declaration for static inline helper functions
+static inline void updatePeriod(struct OutputState *state, uint32_t now);
+static inline uint32_t median3(uint32_t a, uint32_t b, uint32_t c);
+static inline bool processMultiplier(struct OutputState *state, bool op_out, bool rising, uint8_t mult, uint32_t now);
+static inline bool processDividerHalf(struct OutputState *state, uint8_t clkDv, uint8_t clkPhs, uint8_t mult, uint32_t now);
+static inline uint32_t getEuclidMask(uint8_t steps, uint8_t fills, uint8_t rotate);
+static inline uint8_t processLoopRoll(struct OutputState *state, uint8_t lock, uint8_t length);
+static inline bool processBurst(struct OutputState *state, uint8_t count, uint16_t interval, uint32_t now);
 
 // strings to store enum parameters for display
 static const char *trigStrings[] = {"off", "rise", "fall", "COV", "toggle"};
 static const char *divRstStrings[] = {"none", "CV1", "CV2", "In1", "In2"};
-static const char *out2Strings[] = {"sep", "foll", "inv", "bern"};
+static const char *divDutyStrings[] = {"input", "50%"};
+static const char *probModeStrings[] = {"roll", "loop"};
+
+const struct ParamDesc outputParams[OUTPUT_PARAM_COUNT] = {
+	[OUTPUT_PARAM_PROBABILITY] =	{PARAM_UINT8, PARAM_FLAG_CV, PROB_MIN, PROB_MAX, PROB_INC, PROB_DEFAULT,
+										"%d%%", NULL, OUTPUT_FIELD(probability), OUTPUT_FIELD(probabilityCv),
+										OUTPUT_DISPLAY(probabilityStr), OUTPUT_DISPLAY(probabilityDef)},
+	[OUTPUT_PARAM_TRIG] =			{PARAM_UINT8, PARAM_FLAG_CV, TRIG_OFF, TRIG_TOGGLE, 1, TRIG_DEFAULT,
+										NULL, trigStrings, OUTPUT_FIELD(trig), OUTPUT_FIELD(trigCv),
+										OUTPUT_DISPLAY(trigStr), OUTPUT_DISPLAY(trigDef)},
+	[OUTPUT_PARAM_TRIG_LEN] =		{PARAM_UINT16, PARAM_FLAG_CV, TRIG_LEN_MIN, TRIG_LEN_MAX, TRIG_LEN_INC, TRIG_LEN_DEFAULT,
+										"%dms", NULL, OUTPUT_FIELD(trigLen), OUTPUT_FIELD(trigLenCv),
+										OUTPUT_DISPLAY(trigLenStr), OUTPUT_DISPLAY(trigLenDef)},
+	[OUTPUT_PARAM_CLK_DIV] =		{PARAM_UINT8, PARAM_FLAG_CV, DIV_MIN, DIV_MAX, DIV_INC, DIV_DEFAULT,
+										"/%d", NULL, OUTPUT_FIELD(clkDiv), OUTPUT_FIELD(clkDivCv),
+										OUTPUT_DISPLAY(clkDivStr), OUTPUT_DISPLAY(clkDivDef)},
+	[OUTPUT_PARAM_CLK_PHASE] =		{PARAM_UINT8, PARAM_FLAG_CV, DIV_PHASE_MIN, DIV_PHASE_MAX, DIV_INC, DIV_PHASE_DEFAULT,
+										"%d", NULL, OUTPUT_FIELD(clkPhase), OUTPUT_FIELD(clkPhaseCv),
+										OUTPUT_DISPLAY(clkPhaseStr), OUTPUT_DISPLAY(clkPhaseDef)},
+	[OUTPUT_PARAM_DIV_RST] =		{PARAM_UINT8, 0, DIV_RST_NONE, DIV_RST_IN2, 1, DIV_RST_DEFAULT,
+										NULL, divRstStrings, OUTPUT_FIELD(divRst), 0,
+										OUTPUT_DISPLAY(divRstStr), OUTPUT_DISPLAY(divRstDef)},
+	[OUTPUT_PARAM_DELAY] =			{PARAM_UINT16, PARAM_FLAG_CV, DELAY_MIN, DELAY_MAX, DELAY_INC, DELAY_DEFAULT,
+										"%dms", NULL, OUTPUT_FIELD(delay), OUTPUT_FIELD(delayCv),
+										OUTPUT_DISPLAY(delayStr), OUTPUT_DISPLAY(delayDef)},
+	[OUTPUT_PARAM_CLK_MULT] =		{PARAM_UINT8, PARAM_FLAG_CV, MULT_MIN, MULT_MAX, MULT_INC, MULT_DEFAULT,
+										"x%d", NULL, OUTPUT_FIELD(clkMult), OUTPUT_FIELD(clkMultCv),
+										OUTPUT_DISPLAY(clkMultStr), OUTPUT_DISPLAY(clkMultDef)},
+	[OUTPUT_PARAM_DIV_DUTY] =		{PARAM_UINT8, 0, DIV_DUTY_INPUT, DIV_DUTY_HALF, 1, DIV_DUTY_DEFAULT,
+										NULL, divDutyStrings, OUTPUT_FIELD(divDuty), 0,
+										OUTPUT_DISPLAY(divDutyStr), OUTPUT_DISPLAY(divDutyDef)},
+	[OUTPUT_PARAM_EUC_STEPS] =		{PARAM_UINT8, PARAM_FLAG_CV, EUC_STEPS_MIN, EUC_STEPS_MAX, 1, EUC_STEPS_DEFAULT,
+										"%d", NULL, OUTPUT_FIELD(eucSteps), OUTPUT_FIELD(eucStepsCv),
+										OUTPUT_DISPLAY(eucStepsStr), OUTPUT_DISPLAY(eucStepsDef)},
+	[OUTPUT_PARAM_EUC_FILLS] =		{PARAM_UINT8, PARAM_FLAG_CV, EUC_FILLS_MIN, EUC_FILLS_MAX, 1, EUC_FILLS_DEFAULT,
+										"%d", NULL, OUTPUT_FIELD(eucFills), OUTPUT_FIELD(eucFillsCv),
+										OUTPUT_DISPLAY(eucFillsStr), OUTPUT_DISPLAY(eucFillsDef)},
+	[OUTPUT_PARAM_EUC_ROTATE] =	{PARAM_UINT8, PARAM_FLAG_CV, EUC_ROTATE_MIN, EUC_ROTATE_MAX, 1, EUC_ROTATE_DEFAULT,
+										"%d", NULL, OUTPUT_FIELD(eucRotate), OUTPUT_FIELD(eucRotateCv),
+										OUTPUT_DISPLAY(eucRotateStr), OUTPUT_DISPLAY(eucRotateDef)},
+	[OUTPUT_PARAM_PROB_MODE] =		{PARAM_UINT8, 0, PROB_MODE_ROLL, PROB_MODE_LOOP, 1, PROB_MODE_DEFAULT,
+										NULL, probModeStrings, OUTPUT_FIELD(probMode), 0,
+										OUTPUT_DISPLAY(probModeStr), OUTPUT_DISPLAY(probModeDef)},
+	[OUTPUT_PARAM_PROB_LOCK] =		{PARAM_UINT8, PARAM_FLAG_CV, PROB_LOCK_MIN, PROB_LOCK_MAX, PROB_LOCK_INC, PROB_LOCK_DEFAULT,
+										"%d%%", NULL, OUTPUT_FIELD(probLock), OUTPUT_FIELD(probLockCv),
+										OUTPUT_DISPLAY(probLockStr), OUTPUT_DISPLAY(probLockDef)},
+	[OUTPUT_PARAM_PROB_LENGTH] =	{PARAM_UINT8, PARAM_FLAG_CV, PROB_LEN_MIN, PROB_LEN_MAX, 1, PROB_LEN_DEFAULT,
+										"%d", NULL, OUTPUT_FIELD(probLength), OUTPUT_FIELD(probLengthCv),
+										OUTPUT_DISPLAY(probLengthStr), OUTPUT_DISPLAY(probLengthDef)},
+	[OUTPUT_PARAM_BURST_COUNT] =	{PARAM_UINT8, PARAM_FLAG_CV, BURST_COUNT_MIN, BURST_COUNT_MAX, 1, BURST_COUNT_DEFAULT,
+										"%d", NULL, OUTPUT_FIELD(burstCount), OUTPUT_FIELD(burstCountCv),
+										OUTPUT_DISPLAY(burstCountStr), OUTPUT_DISPLAY(burstCountDef)},
+	[OUTPUT_PARAM_BURST_INTERVAL] =	{PARAM_UINT16, PARAM_FLAG_CV, BURST_INT_MIN, BURST_INT_MAX, BURST_INT_INC, BURST_INT_DEFAULT,
+										"%dms", NULL, OUTPUT_FIELD(burstInterval), OUTPUT_FIELD(burstIntervalCv),
+										OUTPUT_DISPLAY(burstIntervalStr), OUTPUT_DISPLAY(burstIntervalDef)}
+	};
 
 /*
  *	set all output settings to their defaults
 */
 void setOutputSettingsDefaults(struct OutputSettings *settings) {
-	settings->probability =		PROB_DEFAULT;
-	settings->delay =			DELAY_DEFAULT;
-	settings->trig =			TRIG_DEFAULT;
-	settings->trigLen =			TRIG_LEN_DEFAULT;
-	settings->clkDiv =			DIV_DEFAULT;
-	settings->clkPhase =		DIV_PHASE_DEFAULT;
-	settings->divRst =			DIV_RST_DEFAULT;
-	settings->probabilityCv =	CV_NONE;
-	settings->delayCv =			CV_NONE;
-	settings->trigLenCv =		CV_NONE;
-	settings->clkDivCv =		CV_NONE;
-	settings->clkPhaseCv =		CV_NONE;
-	sprintf(settings->probabilityStr, "%d%%", PROB_DEFAULT);
-	sprintf(settings->delayStr, "%dms", DELAY_DEFAULT);
-	sprintf(settings->trigStr, trigStrings[settings->trig]);
-	sprintf(settings->trigLenStr, "%dms", TRIG_LEN_DEFAULT);
-	sprintf(settings->clkDivStr, "/%d", DIV_DEFAULT);
-	sprintf(settings->clkPhaseStr, "%d", DIV_PHASE_DEFAULT);
-	sprintf(settings->divRstStr, divRstStrings[settings->divRst]);
-	settings->probabilityDef =	true;
-	settings->delayDef =		true;
-	settings->trigDef =			true;
-	settings->trigLenDef =		true;
-	settings->clkDivDef =		true;
-	settings->clkPhaseDef =		true;
-	settings->divRstDef =		true;
+	paramsSetDefaults(outputParams, OUTPUT_PARAM_COUNT, settings);
 }
 
 /*
@@ -68,9 +142,21 @@ void setOutputSettingsDefaults(struct OutputSettings *settings) {
 */
 void setOutputStateDefaults(struct OutputState *state) {
 	state->op_prev =		false;
+	state->edge_index =		0;
+	state->edge_count =		0;
+	state->period =			0;
+	state->mult_out =		false;
+	state->mult_prev =		false;
+	state->mult_left =		0;
 	state->last_roll =		0;
+	state->loop_reg =		0;
+	state->loop_locked =	false;
+	state->loop_save =		false;
 	state->prob_out =		false;
 	state->prob_prev =		false;
+	state->burst_left =		0;
+	state->burst_out =		false;
+	state->burst_prev =		false;
 	state->delay_out =		false;
 	state->delay_prev =		false;
 	state->trig_count =		0;
@@ -79,8 +165,18 @@ void setOutputStateDefaults(struct OutputState *state) {
 	state->div_count =		0;
 	state->div_out =		false;
 	state->div_prev =		false;
+	state->div_next =		0;
+	state->euc_step =		EUC_STEP_RESTART;
+	state->euc_mask =		0;
+	state->euc_steps =		0;		// matches no pattern, the first pulse builds the mask
+	state->euc_fills =		0;
+	state->euc_rotate =		0;
+	state->euc_hit =		false;
+	state->euc_out =		false;
+	state->euc_prev =		false;
 	state->divRst_prev =	false;
 	state->out_processed =	false;
+	state->timer_armed =	false;
 	
 	state->cv_probability_prev = PROB_DEFAULT;
 	state->cv_delay_prev = DELAY_DEFAULT;
@@ -88,19 +184,218 @@ void setOutputStateDefaults(struct OutputState *state) {
 	state->cv_trigLen_prev = TRIG_LEN_DEFAULT;
 	state->cv_clkDiv_prev = DIV_DEFAULT;
 	state->cv_clkPhase_prev = DIV_PHASE_DEFAULT;
+	state->cv_clkMult_prev = MULT_DEFAULT;
+	state->cv_eucSteps_prev = EUC_STEPS_DEFAULT;
+	state->cv_eucFills_prev = EUC_FILLS_DEFAULT;
+	state->cv_eucRotate_prev = EUC_ROTATE_DEFAULT;
+	state->cv_probLock_prev = PROB_LOCK_DEFAULT;
+	state->cv_probLength_prev = PROB_LEN_DEFAULT;
+	state->cv_burstCount_prev = BURST_COUNT_DEFAULT;
+	state->cv_burstInterval_prev = BURST_INT_DEFAULT;
+}
+
+/*
+ *	log an op out rising edge & update the period estimate, the median of the
+ *	last 3 intervals once there are enough edges for it
+*/
+static inline void updatePeriod(struct OutputState *state, uint32_t now) {
+	uint8_t i = (state->edge_index + 1) & (OUTPUT_EDGE_RING - 1);	// ring size is a power of 2
+	uint32_t *t = state->edge_times;
+	
+	t[i] = now;
+	state->edge_index = i;
+	
+	if (state->edge_count < OUTPUT_EDGE_RING) {
+		state->edge_count++;
+	}
+	
+	switch (state->edge_count) {
+		case 1:
+			break;
+		case 2:
+			state->period = t[i] - t[(i - 1) & (OUTPUT_EDGE_RING - 1)];
+			break;
+		case 3:
+			state->period = (t[i] - t[(i - 2) & (OUTPUT_EDGE_RING - 1)]) >> 1;
+			break;
+		default:
+			state->period = median3(t[i] - t[(i - 1) & (OUTPUT_EDGE_RING - 1)],
+									t[(i - 1) & (OUTPUT_EDGE_RING - 1)] - t[(i - 2) & (OUTPUT_EDGE_RING - 1)],
+									t[(i - 2) & (OUTPUT_EDGE_RING - 1)] - t[(i - 3) & (OUTPUT_EDGE_RING - 1)]);
+			break;
+	}
+}
+
+static inline uint32_t median3(uint32_t a, uint32_t b, uint32_t c) {
+	uint32_t temp;
+	
+	if (a > b) {
+		temp = a;
+		a = b;
+		b = temp;
+	}
+	
+	return (c < a) ? a : ((c > b) ? b : c);
+}
+
+/*
+ *	clock multiplier, each real rising edge resets the phase & starts 'mult'
+ *	evenly spaced pulses across the estimated period. pulse edges are scheduled
+ *	on the timebase, so between real edges this is a single compare per tick.
+ *	passes the op out through at x1 or until there's a period estimate
+*/
+static inline bool processMultiplier(struct OutputState *state, bool op_out, bool rising, uint8_t mult, uint32_t now) {
+	uint32_t period;
+	
+	if (mult <= 1 || state->period == 0) {
+		state->mult_left = 0;
+		return op_out;
+	}
+	
+	if (rising) {
+		period = state->period / mult;
+		period = (period < MULT_MIN_PERIOD) ? MULT_MIN_PERIOD : period;
+		
+		state->mult_high = period >> 1;
+		state->mult_low = period - state->mult_high;
+		state->mult_left = mult - 1;
+		state->mult_next = now + state->mult_high;
+		return true;
+	}
+	
+	// idle after the last pulse, until the next real edge
+	if (!state->mult_out && state->mult_left == 0) {
+		return false;
+	}
+	
+	if ((int32_t)(now - state->mult_next) < 0) {
+		return state->mult_out;
+	}
+	
+	if (state->mult_out) {
+		state->mult_next += state->mult_low;
+		return false;
+	}
+	
+	state->mult_left--;
+	state->mult_next += state->mult_high;
+	return true;
+}
+
+/*
+ *	50% duty clock divider, the divided pulse starts on the counted edge and is
+ *	held on the timebase for half of the divided period. the period is that of
+ *	the divider's input, so the op out period split by any multiplication
+*/
+static inline bool processDividerHalf(struct OutputState *state, uint8_t clkDv, uint8_t clkPhs, uint8_t mult, uint32_t now) {
+	uint32_t period;
+	
+	if (!(state->mult_prev) && state->mult_out) {	// rising edge check
+		state->div_count = (state->div_count + 1) % clkDv;
+		
+		if (state->div_count == clkPhs) {
+			period = (mult > 1) ? state->period / mult : state->period;
+			state->div_next = now + (period >> 1) * clkDv;
+			return true;
+		}
+	}
+	
+	if (state->div_out && (int32_t)(now - state->div_next) >= 0) {
+		return false;
+	}
+	
+	return state->div_out;
+}
+
+/*
+ *	the euclidean pattern as a mask, bit n set for a hit on step n. the table
+ *	holds the unrotated patterns (see euclidMasks.h), the rotation moves each
+ *	step's hit back by the rotate setting, wrapped to the pattern length
+*/
+static inline uint32_t getEuclidMask(uint8_t steps, uint8_t fills, uint8_t rotate) {
+	uint32_t mask = euclidMasks[steps - 1][fills - 1];
+	
+	rotate = rotate % steps;
+	if (rotate == 0) {
+		return mask;
+	}
+	
+	mask = (mask >> rotate) | (mask << (steps - rotate));
+	return (steps < 32) ? (mask & ((1UL << steps) - 1)) : mask;
+}
+
+/*
+ *	looped probability roll, in the style of a Turing machine. the bit leaving
+ *	the loop is fed back in as the newest bit, or rerolled unless the lock keeps
+ *	it, and the low byte of the register is scaled to a 0-99 roll. a fully
+ *	locked loop is just the shift & a compare against the lock
+*/
+static inline uint8_t processLoopRoll(struct OutputState *state, uint8_t lock, uint8_t length) {
+	uint32_t bit = (state->loop_reg >> (length - 1)) & 1;
+	int r;
+	
+	if (lock < PROB_LOCK_MAX) {
+		r = rand();
+		if ((r % 100) >= lock) {
+			bit = (r / 100) & 1;
+		}
+	}
+	
+	// bits past the loop length are just history, they shift out on their own
+	state->loop_reg = (state->loop_reg << 1) | bit;
+	
+	return ((state->loop_reg & 0xFF) * 100) >> 8;
+}
+
+/*
+ *	burst generator, each probability pulse starts 'count' triggers, each high
+ *	for half of the interval. edges are scheduled on the timebase like the clock
+ *	multiplier, but every edge that's come due is caught up on, so after a held
+ *	up loop this lands on the same level the output timer has already set
+*/
+static inline bool processBurst(struct OutputState *state, uint8_t count, uint16_t interval, uint32_t now) {
+	bool out = state->burst_out;
+	
+	if (!(state->prob_prev) && state->prob_out) {	// rising edge
+		state->burst_half = ((uint32_t)interval * TIMEBASE_PER_MS) >> 1;
+		state->burst_left = count - 1;
+		state->burst_next = now + state->burst_half;
+		return true;
+	}
+	
+	// stops idle after the last trigger, until the next pulse
+	while ((out || state->burst_left != 0) && (int32_t)(now - state->burst_next) >= 0) {
+		state->burst_next += state->burst_half;
+		
+		if (!out) {
+			state->burst_left--;
+		}
+		out = !out;
+	}
+	
+	return out;
 }
 
 /*
  *	processes an individual output given a current output state,
  *	the op out, and a settings struct
 */
-void processOutput(struct OutputState *state, bool op_out, struct OutputSettings *settings, struct Cv *cv, struct Input *input, uint32_t currentCount) {
+HOT_FUNC void processOutput(struct OutputState *state, bool op_out, struct OutputSettings *settings, struct Cv *cv, struct Input *input, uint32_t currentCount, uint32_t timebaseCount) {
 	uint8_t prob = settings->probability;
 	uint16_t dly = settings->delay;
 	uint8_t trg = settings->trig;
 	uint16_t trgLen = settings->trigLen;
 	uint8_t clkDv = settings->clkDiv;
 	uint8_t clkPhs = settings->clkPhase;
+	uint8_t clkMlt = settings->clkMult;
+	uint8_t eucStp = settings->eucSteps;
+	uint8_t eucFll = settings->eucFills;
+	uint8_t eucRot = settings->eucRotate;
+	uint8_t prbLck = settings->probLock;
+	uint8_t prbLen = settings->probLength;
+	uint8_t brstCnt = settings->burstCount;
+	uint16_t brstInt = settings->burstInterval;
+	bool opRising = op_out && !state->op_prev;
 	
 	// CV parameter checks
 	if (settings->probabilityCv != CV_NONE) {
@@ -127,6 +422,38 @@ void processOutput(struct OutputState *state, bool op_out, struct OutputSettings
 		clkPhs = normalizeCvUint8(cv, settings->clkPhaseCv, DIV_PHASE_MIN, DIV_PHASE_MAX, state->cv_clkPhase_prev);
 		state->cv_clkPhase_prev = clkPhs;
 	}
+	if (settings->clkMultCv != CV_NONE) {
+		clkMlt = normalizeCvUint8(cv, settings->clkMultCv, MULT_MIN, MULT_MAX, state->cv_clkMult_prev);
+		state->cv_clkMult_prev = clkMlt;
+	}
+	if (settings->eucStepsCv != CV_NONE) {
+		eucStp = normalizeCvUint8(cv, settings->eucStepsCv, EUC_STEPS_MIN, EUC_STEPS_MAX, state->cv_eucSteps_prev);
+		state->cv_eucSteps_prev = eucStp;
+	}
+	if (settings->eucFillsCv != CV_NONE) {
+		eucFll = normalizeCvUint8(cv, settings->eucFillsCv, EUC_FILLS_MIN, EUC_FILLS_MAX, state->cv_eucFills_prev);
+		state->cv_eucFills_prev = eucFll;
+	}
+	if (settings->eucRotateCv != CV_NONE) {
+		eucRot = normalizeCvUint8(cv, settings->eucRotateCv, EUC_ROTATE_MIN, EUC_ROTATE_MAX, state->cv_eucRotate_prev);
+		state->cv_eucRotate_prev = eucRot;
+	}
+	if (settings->probLockCv != CV_NONE) {
+		prbLck = normalizeCvUint8(cv, settings->probLockCv, PROB_LOCK_MIN, PROB_LOCK_MAX, state->cv_probLock_prev);
+		state->cv_probLock_prev = prbLck;
+	}
+	if (settings->probLengthCv != CV_NONE) {
+		prbLen = normalizeCvUint8(cv, settings->probLengthCv, PROB_LEN_MIN, PROB_LEN_MAX, state->cv_probLength_prev);
+		state->cv_probLength_prev = prbLen;
+	}
+	if (settings->burstCountCv != CV_NONE) {
+		brstCnt = normalizeCvUint8(cv, settings->burstCountCv, BURST_COUNT_MIN, BURST_COUNT_MAX, state->cv_burstCount_prev);
+		state->cv_burstCount_prev = brstCnt;
+	}
+	if (settings->burstIntervalCv != CV_NONE) {
+		brstInt = normalizeCvUint16(cv, settings->burstIntervalCv, BURST_INT_MIN, BURST_INT_MAX, state->cv_burstInterval_prev);
+		state->cv_burstInterval_prev = brstInt;
+	}
 	
 	// update previous output state parameters, used for edge detection for
 	// the various processing blocks
@@ -134,21 +461,34 @@ void processOutput(struct OutputState *state, bool op_out, struct OutputSettings
 	state->delay_prev = state->delay_out;
 	state->trig_prev = state->trig_out;
 	state->div_prev = state->div_out;
+	state->mult_prev = state->mult_out;
+	state->euc_prev = state->euc_out;
+	state->burst_prev = state->burst_out;
+	state->timer_armed = false;
+	
+	// track the op out period & process the clock multiplier
+	if (opRising) {
+		updatePeriod(state, timebaseCount);
+	}
+	state->mult_out = processMultiplier(state, op_out, opRising, clkMlt, timebaseCount);
 	
 	// process clock divider settings
-	if (!(op_out) || clkDv == 1) {	// skip if we're not dividing or don't care
-		state->div_out = op_out;
+	if (settings->divDuty == DIV_DUTY_HALF && clkDv > 1 && state->period != 0) {
+		state->div_out = processDividerHalf(state, clkDv, (clkPhs - 1) % clkDv, clkMlt, timebaseCount);
+	}
+	else if (!(state->mult_out) || clkDv == 1) {	// skip if we're not dividing or don't care
+		state->div_out = state->mult_out;
 	}
 	else {
 		clkPhs -= 1;	// update clkPhs to 0-based for easier math
 		
-		if (!(state->op_prev) && op_out) {	// rising edge check
+		if (!(state->mult_prev) && state->mult_out) {	// rising edge check
 			state->div_count = (state->div_count + 1) % clkDv;
 		}
 		
 		// force clock phase to be < clock divisor
 		clkPhs = clkPhs % clkDv;
-		state->div_out = op_out && (state->div_count == clkPhs);
+		state->div_out = state->mult_out && (state->div_count == clkPhs);
 	}
 	
 	bool reset = false;
@@ -171,39 +511,86 @@ void processOutput(struct OutputState *state, bool op_out, struct OutputSettings
 	// check for reset rising edge
 	if (reset && !state->divRst_prev) {
 		state->div_count = clkDv-1;
+		state->euc_step = EUC_STEP_RESTART;
+		
+		// resync a 50% duty output, the next counted edge starts a fresh pulse
+		if (settings->divDuty == DIV_DUTY_HALF) {
+			state->div_out = false;
+		}
 	}
 	state->divRst_prev = reset;
 	
 	// update op_prev now that we're done using it
 	state->op_prev = op_out;
 	
+	// process euclidean mask, each divided pulse steps through the pattern
+	if (eucStp == 1) {	// skip for a 1 step pattern, it can only pass every pulse
+		state->euc_out = state->div_out;
+	}
+	else {
+		// the mask is only rebuilt when the pattern changes, by menu or CV
+		if ((eucStp != state->euc_steps) || (eucFll != state->euc_fills) || (eucRot != state->euc_rotate)) {
+			state->euc_mask = getEuclidMask(eucStp, eucFll, eucRot);
+			state->euc_steps = eucStp;
+			state->euc_fills = eucFll;
+			state->euc_rotate = eucRot;
+		}
+		
+		if (!(state->div_prev) && state->div_out) {	// rising edge check
+			state->euc_step = (state->euc_step + 1 >= eucStp) ? 0 : state->euc_step + 1;
+			state->euc_hit = (state->euc_mask >> state->euc_step) & 1;
+		}
+		
+		state->euc_out = state->div_out && state->euc_hit;
+	}
+	
 	// process delay
 	if (dly == 0) {
-		state->delay_out = state->div_out;
+		state->delay_out = state->euc_out;
 	}
 	else {
 		// rising edge check
-		if (state->div_out && !state->div_prev) {
+		if (state->euc_out && !state->euc_prev) {
 			state->delay_count = currentCount;
 		}
 		
-		state->delay_out = state->div_out && (dly <= (currentCount - state->delay_count));
+		state->delay_out = state->euc_out && (dly <= (currentCount - state->delay_count));
 	}
 	
 	// process output probability
 	if (!(state->delay_prev) && state->delay_out) {	// rising edge
-		state->last_roll = rand() % 100;
+		if (settings->probMode == PROB_MODE_LOOP) {
+			state->last_roll = processLoopRoll(state, prbLck, prbLen);
+			
+			// a loop that has just been locked is the one worth keeping
+			// over a power cycle, flag it to be saved outside of processing
+			if ((prbLck >= PROB_LOCK_MAX) && !state->loop_locked) {
+				state->loop_save = true;
+			}
+			state->loop_locked = (prbLck >= PROB_LOCK_MAX);
+		}
+		else {
+			state->last_roll = rand() % 100;
+		}
 	}
 	
 	state->prob_out = state->delay_out && (prob > state->last_roll);
 	
+	// process burst, a burst of 1 passes the probability output as is
+	if (brstCnt == 1) {
+		state->burst_out = state->prob_out;
+	}
+	else {
+		state->burst_out = processBurst(state, brstCnt, brstInt, timebaseCount);
+	}
+	
 	// process trig settings
 	switch (trg) {
 		case TRIG_OFF:
-			state->trig_out = state->prob_out;
+			state->trig_out = state->burst_out;
 			break;
 		case TRIG_RISING:
-			if (!state->prob_prev && state->prob_out) {	// rising edge
+			if (!state->burst_prev && state->burst_out) {	// rising edge
 				state->trig_out = true;
 				state->trig_count = currentCount;
 			}
@@ -218,7 +605,7 @@ void processOutput(struct OutputState *state, bool op_out, struct OutputSettings
 			}
 			break;
 		case TRIG_FALLING:
-			if (state->prob_prev && !(state->prob_out)) {	// falling edge
+			if (state->burst_prev && !(state->burst_out)) {	// falling edge
 				state->trig_out = true;
 				state->trig_count = currentCount;
 			}
@@ -233,7 +620,7 @@ void processOutput(struct OutputState *state, bool op_out, struct OutputSettings
 			}
 			break;
 		case TRIG_COV:
-			if ((!(state->prob_prev) && state->prob_out) || (state->prob_prev && !(state->prob_out))) {	// COV check
+			if ((!(state->burst_prev) && state->burst_out) || (state->burst_prev && !(state->burst_out))) {	// COV check
 				state->trig_out = true;
 				state->trig_count = currentCount;
 			}
@@ -248,234 +635,81 @@ void processOutput(struct OutputState *state, bool op_out, struct OutputSettings
 			}
 			break;
 		case TRIG_TOGGLE:
-			if (!(state->prob_prev) && state->prob_out) {	// rising edge
+			if (!(state->burst_prev) && state->burst_out) {	// rising edge
 				state->trig_out = !state->trig_prev;
 			}
 			break;
 	}
 	
 	state->out_processed = state->trig_out;
+	
+	// without trig shaping the burst edges are the output edges, so the rest of
+	// the burst can be handed to the output timer
+	if (brstCnt > 1 && trg == TRIG_OFF && (state->burst_out || state->burst_left != 0)) {
+		state->timer_armed = true;
+		state->timer_when = state->burst_next;
+		state->timer_level = !state->burst_out;
+		state->timer_step = state->burst_half;
+		state->timer_edges = (state->burst_left << 1) - !state->burst_out;
+	}
 }
 
 /*
  *	takes a given channel output struct and op outs and determines the final outputs
- *	based on the output settings and associated channel 2 setting 
+ *	based on the given (published) output settings and associated channel 2 setting 
 */
-void processChannelOutput(struct Output *out, bool op_out1, bool op_out2, struct Cv *cv, struct Input *input) {
-	processOutput(&(out->output_state[0]), op_out1, &(out->output_settings[0]), cv, input, *out->rtcCurentCount);
+HOT_FUNC void processChannelOutput(struct Output *out, struct OutputSettings *settings, uint8_t out2_settings, bool op_out1, bool op_out2, struct Cv *cv, struct Input *input) {
+	processOutput(&(out->output_state[0]), op_out1, &settings[0], cv, input, *out->rtcCurentCount, *out->timebaseCount);
 	
-	switch (out->out2_settings) {
+	switch (out2_settings) {
 		case OUT2_SEPARATE:
-			processOutput(&(out->output_state[1]), op_out2, &(out->output_settings[1]), cv, input, *out->rtcCurentCount);
+			processOutput(&(out->output_state[1]), op_out2, &settings[1], cv, input, *out->rtcCurentCount, *out->timebaseCount);
 			break;
 		case OUT2_FOLLOW:
-			processOutput(&(out->output_state[1]), op_out2, &(out->output_settings[0]), cv, input, *out->rtcCurentCount);
+			processOutput(&(out->output_state[1]), op_out2, &settings[0], cv, input, *out->rtcCurentCount, *out->timebaseCount);
 			break;
 		case OUT2_INVERT:
 			out->output_state[1].out_processed = !(out->output_state[0].out_processed);
+			out->output_state[1].timer_armed = false;
 			break;
 		case OUT2_BERN:
 			out->output_state[1].out_processed = !(out->output_state[0].out_processed) && input->input_state[0].input_processed;
+			out->output_state[1].timer_armed = false;
 			break;
 	}
 }
 
 /*
- *	increment/decrement probability & update CV and string parameters,
- *	used by menu functions
-*/
-void updateProbability(struct OutputSettings *settings, bool inc) {
-	
-	updateUint8t(&settings->probability, &settings->probabilityCv, inc, PROB_MIN, PROB_MAX, PROB_INC);
-	
-	if (settings->probabilityCv != CV_NONE) {
-		sprintf(settings->probabilityStr, (settings->probabilityCv == CV1)? "CV1":"CV2");
-	}
-	else {	// not under CV control
-		sprintf(settings->probabilityStr, "%d%%", settings->probability);
-	}
-	
-	// check if param is default for display invert
-	settings->probabilityDef = ((settings->probabilityCv == CV_NONE) && \
-						(settings->probability == PROB_DEFAULT));
-}
-
-/*
- *	increment/decrement trig setting & update CV and parameter string,
- *	used by menu functions
-*/
-void updateTrig(struct OutputSettings *settings, bool inc) {
-	
-	updateUint8t(&settings->trig, &settings->trigCv, inc, TRIG_OFF, TRIG_TOGGLE, 1);
-	
-	if (settings->trigCv != CV_NONE) {
-		sprintf(settings->trigStr, (settings->trigCv == CV1)? "CV1":"CV2");
-	}
-	else {	// not under CV control
-		sprintf(settings->trigStr, "%s", trigStrings[settings->trig]);
-	}
-	
-	// check if param is default for display invert
-	settings->trigDef = ((settings->trigCv == CV_NONE) && (settings->trig == TRIG_DEFAULT));
-}
-
-/*
- *	increment/decrement the trig length parameter, updating the CV and
- *	 parameter string, used by menu functions
-*/
-void updateTrigLen(struct OutputSettings *settings, bool inc) {
-	
-	updateUint16t(&settings->trigLen, &settings->trigLenCv, inc, TRIG_LEN_MIN, TRIG_LEN_MAX, TRIG_LEN_INC);
-	
-	if (settings->trigLenCv != CV_NONE) {
-		sprintf(settings->trigLenStr, (settings->trigLenCv == CV1)? "CV1":"CV2");
-	}
-	else {	// not under CV control
-		sprintf(settings->trigLenStr, "%dms", settings->trigLen);
-	}
-	
-	// check if param is default for display invert
-	settings->trigLenDef = ((settings->trigLenCv == CV_NONE) && (settings->trigLen == TRIG_LEN_DEFAULT));
-}
-
-/*
- *	increment/decrement clock divider parameter, update CV and parameter
- *	string, used by menu functions
-*/
-void updateClkDiv(struct OutputSettings *settings, bool inc) {
-	
-	updateUint8t(&settings->clkDiv, &settings->clkDivCv, inc, DIV_MIN, DIV_MAX, DIV_INC);
-	
-	if (settings->clkDivCv != CV_NONE) {
-		sprintf(settings->clkDivStr, (settings->clkDivCv == CV1)? "CV1":"CV2");
-	}
-	else {	// not under CV control
-		sprintf(settings->clkDivStr, "/%d", settings->clkDiv);
-	}
-	
-	// check if param is default for display invert
-	settings->clkDivDef = ((settings->clkDivCv == CV_NONE) && (settings->clkDiv == DIV_DEFAULT));
-}
-
-/*
- *	increment/decrement the clock divider phase & update the CV and parameter
- *	string, used by menu functions
-*/
-void updateClkPhase(struct OutputSettings *settings, bool inc) {
-	
-	updateUint8t(&settings->clkPhase, &settings->clkPhaseCv, inc, DIV_PHASE_MIN, DIV_PHASE_MAX, DIV_INC);
-	
-	if (settings->clkPhaseCv != CV_NONE) {
-		sprintf(settings->clkPhaseStr, (settings->clkPhaseCv == CV1)? "CV1":"CV2");
-	}
-	else {	// not under CV control
-		sprintf(settings->clkPhaseStr, "%d", settings->clkPhase);
-	}
-	
-	// check if param is default for display invert
-	settings->clkPhaseDef = ((settings->clkPhaseCv == CV_NONE) && (settings->clkPhase == DIV_PHASE_DEFAULT));
-}
-
-/*
- *	increment/decrement the assignment for the clock divider reset
- *	input and update parameter string (no CV control), used by menu functions
+ *	migrate an output's settings from the 15 byte legacy (v0) layout:
+ *	1.probability 2.trig 3.trigLen (2 bytes) 4.clkDiv 5.clkPhase 6.divRst 
+ *	7.probability CV 8.trig CV 9.trigLen CV 10.clkDiv CV 11. clkPhase CV
+ *	12. delay (2 bytes) 13. delay CV
 */
-void updateDivRst(struct OutputSettings *settings, bool inc) {
-	
-	if (inc) {
-		settings->divRst += 1;
-		if (settings->divRst > DIV_RST_IN2) {	// overflow check
-			settings->divRst = DIV_RST_NONE;
-		}
-	}
-	else {	// decrementing
-		settings->divRst -= 1;
-		if (settings->divRst > DIV_RST_IN2) {	// underflow check for uint8_t
-			settings->divRst = DIV_RST_IN2;
-		}
-	}
-	sprintf(settings->divRstStr, "%s", divRstStrings[settings->divRst]);
-	
-	// check if param is default for display invert
-	settings->divRstDef = (settings->divRst == DIV_RST_DEFAULT);
+void unpackOutputSettingsLegacy(struct OutputSettings *settings, const uint8_t *buffer) {
+	uint16_t trgLen = (buffer[2] << 8) | buffer[3];
+	uint16_t dly = (buffer[12] << 8) | buffer[13];
+	
+	// settings added since are left at their defaults
+	paramsSetDefaults(outputParams, OUTPUT_PARAM_COUNT, settings);
+	
+	settings->probability =		nvmValidateField(buffer[0], PROB_MIN, PROB_MAX, PROB_DEFAULT);
+	settings->trig =			nvmValidateField(buffer[1], TRIG_OFF, TRIG_TOGGLE, TRIG_DEFAULT);
+	settings->trigLen =			nvmValidateField(trgLen, TRIG_LEN_MIN, TRIG_LEN_MAX, TRIG_LEN_DEFAULT);
+	settings->clkDiv =			nvmValidateField(buffer[4], DIV_MIN, DIV_MAX, DIV_DEFAULT);
+	settings->clkPhase =		nvmValidateField(buffer[5], DIV_PHASE_MIN, DIV_PHASE_MAX, DIV_PHASE_DEFAULT);
+	settings->divRst =			nvmValidateField(buffer[6], DIV_RST_NONE, DIV_RST_IN2, DIV_RST_DEFAULT);
+	settings->probabilityCv =	nvmValidateField(buffer[7], CV_NONE, CV2, CV_NONE);
+	settings->trigCv =			nvmValidateField(buffer[8], CV_NONE, CV2, CV_NONE);
+	settings->trigLenCv =		nvmValidateField(buffer[9], CV_NONE, CV2, CV_NONE);
+	settings->clkDivCv =		nvmValidateField(buffer[10], CV_NONE, CV2, CV_NONE);
+	settings->clkPhaseCv =		nvmValidateField(buffer[11], CV_NONE, CV2, CV_NONE);
+	settings->delay =			nvmValidateField(dly, DELAY_MIN, DELAY_MAX, DELAY_DEFAULT);
+	settings->delayCv =			nvmValidateField(buffer[14], CV_NONE, CV2, CV_NONE);
 }
 
 /*
- *	increment/decrement the delay parameter & update CV and parameter string,
- *	used by menu functions
+ *	migrate the channel's shared output 2 mode from a legacy (v0) NVM page
 */
-void updateDelay(struct OutputSettings *settings, bool inc) {
-	
-	updateUint16t(&settings->delay, &settings->delayCv, inc, DELAY_MIN, DELAY_MAX, DELAY_INC);
-	
-	if (settings->delayCv != CV_NONE) {
-		sprintf(settings->delayStr, (settings->delayCv == CV1)? "CV1":"CV2");
-	}
-	else {	// not under CV control
-		sprintf(settings->delayStr, "%dms", settings->delay);
-	}
-	
-	// check if param is default for display invert
-	settings->delayDef = ((settings->delayCv == CV_NONE) && (settings->delay == DELAY_DEFAULT));
-}
-
-/*
- *	increment/decrement the assignment for how output 2 processes its
- *	settings and update parameter string (no CV control), used by menu functions
-*/
-void updateOut2Settings(struct Output *out, bool inc) {
-	
-	if (inc) {
-		out->out2_settings += 1;
-		if (out->out2_settings > OUT2_BERN) {	// overflow check
-			out->out2_settings = OUT2_SEPARATE;
-		}
-	}
-	else {	// decrementing
-		out->out2_settings -= 1;
-		if (out->out2_settings > OUT2_BERN) {	// underflow check for uint8_t
-			out->out2_settings = OUT2_BERN;
-		}
-	}
-	sprintf(out->out2Str, "%s", out2Strings[out->out2_settings]);
-	
-	// check if param is default for display invert
-	out->out2Def = (out->out2_settings == OUT2_SEPARATE);
-}
-
-/*
- *	sets isDefault states for all settings within an Output struct
-*/
-void readOutputDefaultStates(struct Output *out) {
-	for (uint8_t i=0; i<2; i++) {
-		// probability
-		out->output_settings[i].probabilityDef = ((out->output_settings[i].probabilityCv == CV_NONE) && \
-		(out->output_settings[i].probability == PROB_DEFAULT));
-		
-		// trig type
-		out->output_settings[i].trigDef = ((out->output_settings[i].trigCv == CV_NONE) && \
-					(out->output_settings[i].trig == TRIG_DEFAULT));
-		
-		// trig length
-		out->output_settings[i].trigLenDef = ((out->output_settings[i].trigLenCv == CV_NONE) && \
-					(out->output_settings[i].trigLen == TRIG_LEN_DEFAULT));
-		
-		// clock division
-		out->output_settings[i].clkDivDef = ((out->output_settings[i].clkDivCv == CV_NONE) && \
-					(out->output_settings[i].clkDiv == DIV_DEFAULT));
-		
-		// clock div phase
-		out->output_settings[i].clkPhaseDef = ((out->output_settings[i].clkPhaseCv == CV_NONE) && \
-					(out->output_settings[i].clkPhase == DIV_PHASE_DEFAULT));
-		
-		// clock div reset input
-		out->output_settings[i].divRstDef = (out->output_settings[i].divRst == DIV_RST_DEFAULT);
-		
-		// delay
-		out->output_settings[i].delayDef = ((out->output_settings[i].delayCv == CV_NONE) && \
-		(out->output_settings[i].delay == DELAY_DEFAULT));
-	}
-	
-	// output 2 setting
-	out->out2Def = (out->out2_settings == OUT2_SEPARATE);
+void unpackOut2SettingsLegacy(struct Output *out, const uint8_t *buffer) {
+	out->out2_settings = nvmValidateField(buffer[0], OUT2_SEPARATE, OUT2_BERN, OUT2_SEPARATE);
 }
\ No newline at end of file
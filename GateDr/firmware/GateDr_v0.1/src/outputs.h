@@ -8,13 +8,19 @@
 
 #include <stdbool.h>
 #include <stdint.h>
-#include <stdio.h>
 #include <stdlib.h>
 #include "rtc_count.h"
 #include "conf_menu.h"	// for parameter string max char limit
 #include "inputs.h"
 #include "cv.h"
 #include "paramUtils.h"
+#include "hotPath.h"
+#include "nvmPack.h"
+#include "timebase.h"
+
+// rising edges kept for the period estimate, the median of the intervals
+// between them rides out a single late or missing edge
+#define OUTPUT_EDGE_RING	4
 
 /*
  *	Options for output trig settings
@@ -38,6 +44,24 @@ enum DivResetOptions {
 	DIV_RST_IN2
 	};
 
+/*
+ *	Options for the clock divider output pulse width
+*/
+enum DivDutyOptions {
+	DIV_DUTY_INPUT,		// divided pulses keep the width of the incoming pulse
+	DIV_DUTY_HALF		// divided pulses are held for half the divided period, from
+						// the measured input period
+	};
+
+/*
+ *	Options for how the probability stage rolls for each pulse
+*/
+enum ProbModeOptions {
+	PROB_MODE_ROLL,		// a fresh random roll on every pulse
+	PROB_MODE_LOOP		// rolls are read from a looping shift register, which the
+						// lock setting keeps from changing
+	};
+
 /*
  *	Options for how the channel will process the second output
 */
@@ -61,13 +85,37 @@ struct OutputSettings {
 	uint8_t clkDiv;			// clock divider division
 	uint8_t clkPhase;		// clock divider phase in steps
 	uint8_t divRst;			// chooses which input resets the clock div function
+	uint8_t clkMult;		// clock multiplier, ahead of the divider
+	uint8_t divDuty;		// clock divider pulse width, per DivDutyOptions
+	uint8_t eucSteps;		// euclidean pattern length
+	uint8_t eucFills;		// euclidean pattern hits, clamped to the steps
+	uint8_t eucRotate;		// euclidean pattern rotation in steps
+	uint8_t probMode;		// probability roll source, per ProbModeOptions
+	uint8_t probLock;		// chance in % that a looped bit is kept rather than rerolled
+	uint8_t probLength;		// loop length in pulses
+	uint8_t burstCount;		// triggers per burst, 1 for no burst
+	uint16_t burstInterval;	// time between burst triggers in ms
 	uint8_t probabilityCv;
 	uint8_t delayCv;
 	uint8_t trigCv;
 	uint8_t trigLenCv;
 	uint8_t clkDivCv;
 	uint8_t clkPhaseCv;
-	
+	uint8_t clkMultCv;
+	uint8_t eucStepsCv;
+	uint8_t eucFillsCv;
+	uint8_t eucRotateCv;
+	uint8_t probLockCv;
+	uint8_t probLengthCv;
+	uint8_t burstCountCv;
+	uint8_t burstIntervalCv;
+	};	// 118 bits to NVM
+
+/*
+ *	display strings & 'default' states for the output settings, kept apart from
+ *	OutputSettings so the settings snapshots only copy the stored values
+*/
+struct OutputDisplay {
 	// mutable strings for printing values to display
 	char probabilityStr[GFX_MONO_MENU_PARAM_MAX_CHAR];
 	char delayStr[GFX_MONO_MENU_PARAM_MAX_CHAR];
@@ -76,6 +124,16 @@ struct OutputSettings {
 	char clkDivStr[GFX_MONO_MENU_PARAM_MAX_CHAR];
 	char clkPhaseStr[GFX_MONO_MENU_PARAM_MAX_CHAR];
 	char divRstStr[GFX_MONO_MENU_PARAM_MAX_CHAR];
+	char clkMultStr[GFX_MONO_MENU_PARAM_MAX_CHAR];
+	char divDutyStr[GFX_MONO_MENU_PARAM_MAX_CHAR];
+	char eucStepsStr[GFX_MONO_MENU_PARAM_MAX_CHAR];
+	char eucFillsStr[GFX_MONO_MENU_PARAM_MAX_CHAR];
+	char eucRotateStr[GFX_MONO_MENU_PARAM_MAX_CHAR];
+	char probModeStr[GFX_MONO_MENU_PARAM_MAX_CHAR];
+	char probLockStr[GFX_MONO_MENU_PARAM_MAX_CHAR];
+	char probLengthStr[GFX_MONO_MENU_PARAM_MAX_CHAR];
+	char burstCountStr[GFX_MONO_MENU_PARAM_MAX_CHAR];
+	char burstIntervalStr[GFX_MONO_MENU_PARAM_MAX_CHAR];
 	
 	// bools to keep track of whether current value is at the default,
 	// used by gfx_mono_menu for inverting parameter on the display
@@ -86,7 +144,17 @@ struct OutputSettings {
 	bool clkDivDef;
 	bool clkPhaseDef;
 	bool divRstDef;
-	};	// 12 bytes to NVM, excludes char arrays & 'default' bools
+	bool clkMultDef;
+	bool divDutyDef;
+	bool eucStepsDef;
+	bool eucFillsDef;
+	bool eucRotateDef;
+	bool probModeDef;
+	bool probLockDef;
+	bool probLengthDef;
+	bool burstCountDef;
+	bool burstIntervalDef;
+	};
 
 /*
  *	a struct to hold all of the necessary values per-output that represent
@@ -94,20 +162,55 @@ struct OutputSettings {
 */
 struct OutputState {
 	bool op_prev;			// previous op result, pre-output processing
+	uint32_t edge_times[OUTPUT_EDGE_RING];	// timebase counts of the latest op out
+											// rising edges, for the period estimate
+	uint8_t edge_index;		// ring position of the latest edge
+	uint8_t edge_count;		// edges in the ring, up to OUTPUT_EDGE_RING
+	uint32_t period;		// median op out period in timebase counts, 0 until known
+	bool mult_out;			// clock multiplier output
+	bool mult_prev;			// previous clock multiplier output
+	uint8_t mult_left;		// multiplied pulses still to start before the next real edge
+	uint32_t mult_next;		// timebase count of the next multiplied pulse edge
+	uint32_t mult_high;		// multiplied pulse high & low times in timebase counts
+	uint32_t mult_low;
 	uint32_t delay_count;	// most recent RTC count for delay processing
 	bool delay_out;			// delay output
 	bool delay_prev;		// previous delay output
 	uint8_t div_count;		// count for clock divider status
 	bool div_out;			// clock divider output
 	bool div_prev;			// previous clock divider output
+	uint32_t div_next;		// timebase count to end a 50% duty divided pulse
+	uint8_t euc_step;		// pattern step of the latest divided pulse, wraps at the steps
+	uint32_t euc_mask;		// rotated pattern, bit n set for a hit on step n
+	uint8_t euc_steps;		// pattern settings the mask was built from
+	uint8_t euc_fills;
+	uint8_t euc_rotate;
+	bool euc_hit;			// latest divided pulse landed on a hit
+	bool euc_out;			// euclidean mask output
+	bool euc_prev;			// previous euclidean mask output
 	bool divRst_prev;	// previous states for each divRst input
 	uint8_t last_roll;		// used to store last probability roll
+	uint32_t loop_reg;		// looping shift register for PROB_MODE_LOOP, the newest
+							// bit is bit 0. stored in NVM with the channel settings
+	bool loop_locked;		// loop was fully locked at the latest roll
+	bool loop_save;			// loop has just locked, see saveChannelLoops()
 	bool prob_out;			// probability processing output
 	bool prob_prev;			// previous probability output
+	uint8_t burst_left;		// burst triggers still to start
+	uint32_t burst_next;	// timebase count of the next burst edge
+	uint32_t burst_half;	// burst trigger high & low time in timebase counts
+	bool burst_out;			// burst output
+	bool burst_prev;		// previous burst output
 	uint32_t trig_count;	// most recent RTC count for trigLen processing
 	bool trig_out;			// previous trig processing output
 	bool trig_prev;			// trig processing output
 	bool out_processed;		// final output state
+	bool timer_armed;		// the next final output edges are known ahead of time, they're
+							// handed to the output timer to land between processing loops
+	uint32_t timer_when;	// timebase count of the next edge
+	bool timer_level;		// output level from the next edge
+	uint32_t timer_step;	// timebase counts between the edges that follow it
+	uint8_t timer_edges;	// edges that follow it, each one toggling the output
 	
 	// previous CV conversion values used for hysteresis when under CV selection
 	uint8_t cv_delay_prev;
@@ -116,13 +219,23 @@ struct OutputState {
 	uint16_t cv_trigLen_prev;
 	uint8_t cv_clkDiv_prev;
 	uint8_t cv_clkPhase_prev;
+	uint8_t cv_clkMult_prev;
+	uint8_t cv_eucSteps_prev;
+	uint8_t cv_eucFills_prev;
+	uint8_t cv_eucRotate_prev;
+	uint8_t cv_probLock_prev;
+	uint8_t cv_probLength_prev;
+	uint8_t cv_burstCount_prev;
+	uint16_t cv_burstInterval_prev;
 	};
 
 struct Output {
 	struct OutputSettings output_settings[2];
 	struct OutputState output_state[2];
+	struct OutputDisplay output_display[2];
 	uint8_t out2_settings;		// sets channel out2 settings as per above enum
 	uint32_t *rtcCurentCount;	// current RTC count (updated on processing loop start)
+	uint32_t *timebaseCount;	// current timebase count (updated on processing loop start)
 	
 	char out2Str[GFX_MONO_MENU_PARAM_MAX_CHAR];
 	bool out2Def;
@@ -130,24 +243,42 @@ struct Output {
 
 void setOutputSettingsDefaults(struct OutputSettings *settings);
 void setOutputStateDefaults(struct OutputState *state);
-void processOutput(struct OutputState *state, bool op_out, struct OutputSettings *settings, struct Cv *cv, struct Input *input, uint32_t currentCount);
-void processChannelOutput(struct Output *out, bool op_out1, bool op_out2, struct Cv *cv, struct Input *input);
+HOT_FUNC void processOutput(struct OutputState *state, bool op_out, struct OutputSettings *settings, struct Cv *cv, struct Input *input, uint32_t currentCount, uint32_t timebaseCount);
+HOT_FUNC void processChannelOutput(struct Output *out, struct OutputSettings *settings, uint8_t out2_settings, bool op_out1, bool op_out2, struct Cv *cv, struct Input *input);
 
 /*
- *	functions for UI callbacks during menu interactions
+ *	parameter descriptors for OutputSettings, in NVM packing order. strings & 'default'
+ *	states are relative to OutputDisplay. a new parameter goes in wherever it fits,
+ *	since any change to the table moves the rest of the channel page along with
+ *	it and needs a schema version bump
 */
-void updateProbability(struct OutputSettings *settings, bool inc);
-void updateTrig(struct OutputSettings *settings, bool inc);
-void updateTrigLen(struct OutputSettings *settings, bool inc);
-void updateClkDiv(struct OutputSettings *settings, bool inc);
-void updateClkPhase(struct OutputSettings *settings, bool inc);
-void updateDivRst(struct OutputSettings *settings, bool inc);
-void updateDelay(struct OutputSettings *settings, bool inc);
-void updateOut2Settings(struct Output *out, bool inc);
+enum OutputParams {
+	OUTPUT_PARAM_PROBABILITY,
+	OUTPUT_PARAM_TRIG,
+	OUTPUT_PARAM_TRIG_LEN,
+	OUTPUT_PARAM_CLK_DIV,
+	OUTPUT_PARAM_CLK_PHASE,
+	OUTPUT_PARAM_DIV_RST,
+	OUTPUT_PARAM_DELAY,
+	OUTPUT_PARAM_CLK_MULT,
+	OUTPUT_PARAM_DIV_DUTY,
+	OUTPUT_PARAM_EUC_STEPS,
+	OUTPUT_PARAM_EUC_FILLS,
+	OUTPUT_PARAM_EUC_ROTATE,
+	OUTPUT_PARAM_PROB_MODE,
+	OUTPUT_PARAM_PROB_LOCK,
+	OUTPUT_PARAM_PROB_LENGTH,
+	OUTPUT_PARAM_BURST_COUNT,
+	OUTPUT_PARAM_BURST_INTERVAL,
+	OUTPUT_PARAM_COUNT
+	};
+
+extern const struct ParamDesc outputParams[OUTPUT_PARAM_COUNT];
 
 /*
- *	used after NVM read to set probabilityDef, delayDef, etc
+ *	migrate settings from a legacy (v0) NVM page, with per-field range checks
 */
-void readOutputDefaultStates(struct Output *out);
+void unpackOutputSettingsLegacy(struct OutputSettings *settings, const uint8_t *buffer);
+void unpackOut2SettingsLegacy(struct Output *out, const uint8_t *buffer);
 
 #endif /* OUTPUTS_H_ */
\ No newline at end of file
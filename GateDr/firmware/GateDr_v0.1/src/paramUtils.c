@@ -3,166 +3,281 @@
  */ 
 
 #include "paramUtils.h"
+#include "cv.h"		// for CV enums
+#include "textFormat.h"
+
+// display strings for a parameter under CV control, corresponds to CvSel enum
+static const char *paramCvStrings[] = {"", "CV1", "CV2"};
+
+// CV selections a CV-able parameter passes through past either limit
+#define PARAM_CV_COUNT	2
+
+// helper function declaration
+static inline uint8_t *getCvPtr(const struct ParamDesc *desc, void *base);
+static inline void updateOption(const struct ParamDesc *desc, void *base, uint8_t *cv, bool inc, uint8_t detents);
+static inline void updateCvSelection(const struct ParamDesc *desc, void *base, uint8_t *cv, bool inc, uint8_t detents);
 
 /*
- *	boolean 
+ *	get a pointer to a CV-able parameter's CV selection
 */
-void updateBool(bool *param, uint8_t *cv, bool inc) {
-	switch (*cv) {
-		case CV_NONE:
-			if ((*param)==true && inc) {
-				*cv = CV1;
-			}
-			else if ((*param)==false && !inc) {
-				*cv = CV2;
-			}
-			else {
-				*param = !(*param);
-			}
-			break;
-		case CV1:
-			if (inc) {
-				*cv = CV2;
-			}
-			else {	// decrementing
-				*cv = CV_NONE;
-				*param = true;
-			}
-			break;
-		case CV2:
-			if (inc) {
-				*cv = CV_NONE;
-				*param = false;
-			}
-			else {	// decrementing
-				*cv = CV1;
-			}
-			break;
+static inline uint8_t *getCvPtr(const struct ParamDesc *desc, void *base) {
+	return (uint8_t *)base + desc->cvOffset;
+}
+
+/*
+ *	read a parameter's current value, regardless of storage type
+*/
+int32_t paramGet(const struct ParamDesc *desc, const void *base) {
+	const uint8_t *ptr = (const uint8_t *)base + desc->offset;
+	
+	switch (desc->type) {
+		case PARAM_UINT16:
+			return *(const uint16_t *)ptr;
+		case PARAM_INT16:
+			return *(const int16_t *)ptr;
+		default:	// PARAM_UINT8
+			return *ptr;
 	}
 }
 
 /*
- *	uint8_t
+ *	write a parameter's value, regardless of storage type
 */
-void updateUint8t(uint8_t *param, uint8_t *cv, bool inc, uint8_t min, uint8_t max, uint8_t step) {
-	switch (*cv) {
-		case CV_NONE:
-			if (inc) {
-				*param += step;
-				
-				if (*param > max) {	// overflow check
-					*cv = CV1;
-				}
-			}
-			else {	// decrementing
-				*param -= step;
-				
-				if ((*param < min) || (*param > max)) {	// underflow check 
-					*cv = CV2;
-				}
-			}
+void paramSet(const struct ParamDesc *desc, void *base, int32_t value) {
+	uint8_t *ptr = (uint8_t *)base + desc->offset;
+	
+	switch (desc->type) {
+		case PARAM_UINT16:
+			*(uint16_t *)ptr = value;
 			break;
-		case CV1:
-			if (inc) {
-				*cv = CV2;
-			}
-			else {	// decrementing
-				*cv = CV_NONE;
-				*param = max;
-			}
+		case PARAM_INT16:
+			*(int16_t *)ptr = value;
 			break;
-		case CV2:
-			if (inc) {
-				*cv = CV_NONE;
-				*param = min;
-			}
-			else {	// decrementing
-				*cv = CV1;
-			}
+		default:	// PARAM_UINT8
+			*ptr = value;
 			break;
 	}
 }
 
 /*
- *	uint16_t
+ *	increment/decrement a parameter, used by menu functions. 'detents' is the raw
+ *	encoder count & 'steps' the same count after encoder acceleration.
+ *	note: enumerated parameters & CV selections move one option per detent and
+ *	      wrap around, only numeric parameters are accelerated. an accelerated
+ *	      step is clamped to min/max, and a numeric parameter only moves into
+ *	      its CV selections (or wraps, if it isn't CV-able) once it's already
+ *	      sitting at the limit
 */
-void updateUint16t(uint16_t *param, uint8_t *cv, bool inc, uint16_t min, uint16_t max, uint16_t step) {
-		switch (*cv) {
-			case CV_NONE:
-			if (inc) {
-				*param += step;
-				
-				if (*param > max) {	// overflow check
-					*cv = CV1;
-				}
-			}
-			else {	// decrementing
-				*param -= step;
-				
-				if ((*param < min) || (*param > max)) {	// underflow check
-					*cv = CV2;
-				}
-			}
-			break;
-			case CV1:
-			if (inc) {
-				*cv = CV2;
-			}
-			else {	// decrementing
-				*cv = CV_NONE;
-				*param = max;
-			}
-			break;
-			case CV2:
-			if (inc) {
-				*cv = CV_NONE;
-				*param = min;
-			}
-			else {	// decrementing
-				*cv = CV1;
-			}
-			break;
+void paramUpdate(const struct ParamDesc *desc, void *base, bool inc, uint8_t detents, uint8_t steps) {
+	uint8_t *cv = NULL;
+	int32_t value = paramGet(desc, base);
+	int32_t step = desc->step * steps;
+	
+	if (desc->flags & PARAM_FLAG_CV) {
+		cv = getCvPtr(desc, base);
+	}
+	
+	// enumerated parameters, unaccelerated
+	if (desc->names != NULL) {
+		updateOption(desc, base, cv, inc, detents);
+		return;
+	}
+	
+	// numeric parameters under CV, or heading into it from a limit, unaccelerated
+	if ((cv != NULL) && ((*cv != CV_NONE) || (inc && (value >= desc->max)) || (!inc && (value <= desc->min)))) {
+		updateCvSelection(desc, base, cv, inc, detents);
+		return;
+	}
+	
+	if (inc) {
+		if (value >= desc->max) {	// overflow check
+			value = desc->min;
+		}
+		else {
+			value += step;
+			value = (value > desc->max) ? desc->max : value;
 		}
+	}
+	else {	// decrementing
+		if (value <= desc->min) {	// underflow check
+			value = desc->max;
+		}
+		else {
+			value -= step;
+			value = (value < desc->min) ? desc->min : value;
+		}
+	}
+	
+	paramSet(desc, base, value);
 }
 
 /*
- *	int16_t
+ *	move an enumerated parameter 'detents' options along, wrapping around. a
+ *	CV-able one has CV1 & CV2 as two more options after the last
 */
-void updateInt16t(int16_t *param, uint8_t *cv, bool inc, int16_t min, int16_t max, int16_t step) {
-		switch (*cv) {
-			case CV_NONE:
-			if (inc) {
-				*param += step;
-				
-				if (*param > max) {	// overflow check
-					*cv = CV1;
-				}
-			}
-			else {	// decrementing
-				*param -= step;
-				
-				if (*param < min) {	// underflow check
-					*cv = CV2;
-				}
-			}
-			break;
-			case CV1:
-			if (inc) {
-				*cv = CV2;
-			}
-			else {	// decrementing
-				*cv = CV_NONE;
-				*param = max;
-			}
-			break;
-			case CV2:
-			if (inc) {
-				*cv = CV_NONE;
-				*param = min;
-			}
-			else {	// decrementing
-				*cv = CV1;
-			}
-			break;
+static inline void updateOption(const struct ParamDesc *desc, void *base, uint8_t *cv, bool inc, uint8_t detents) {
+	uint8_t options = desc->max - desc->min + 1;
+	uint8_t count = options + ((cv != NULL) ? PARAM_CV_COUNT : 0);
+	uint8_t pos = paramGet(desc, base) - desc->min;
+	
+	if ((cv != NULL) && (*cv != CV_NONE)) {
+		pos = options + (*cv - CV1);
+	}
+	
+	detents %= count;
+	pos = inc ? (pos + detents) % count : (pos + count - detents) % count;
+	
+	if (pos < options) {
+		paramSet(desc, base, desc->min + pos);
+		if (cv != NULL) {
+			*cv = CV_NONE;
 		}
+	}
+	else {
+		*cv = CV1 + (pos - options);
+	}
+}
+
+/*
+ *	move a numeric parameter at its limit (or under CV) 'detents' along the CV
+ *	selections, CV1 then CV2 going up & the other way round going down. it comes
+ *	out at the opposite limit, and any detents left over stop there
+*/
+static inline void updateCvSelection(const struct ParamDesc *desc, void *base, uint8_t *cv, bool inc, uint8_t detents) {
+	uint8_t pos = 0;	// the limit going in
+	
+	if (*cv != CV_NONE) {
+		pos = inc ? *cv : (PARAM_CV_COUNT + 1 - *cv);
+	}
+	
+	pos = ((pos + detents) > PARAM_CV_COUNT) ? (PARAM_CV_COUNT + 1) : (pos + detents);
+	
+	if (pos > PARAM_CV_COUNT) {
+		*cv = CV_NONE;
+		paramSet(desc, base, inc ? desc->min : desc->max);
+	}
+	else {
+		*cv = inc ? pos : (PARAM_CV_COUNT + 1 - pos);
+	}
 }
+
+/*
+ *	write a parameter's display string & 'default' state from its current value
+*/
+void paramRender(const struct ParamDesc *desc, const void *base, void *disp) {
+	char *str = (char *)disp + desc->strOffset;
+	int32_t value = paramGet(desc, base);
+	uint8_t cv = CV_NONE;
+	
+	if (desc->flags & PARAM_FLAG_CV) {
+		cv = *((const uint8_t *)base + desc->cvOffset);
+	}
+	
+	if (cv != CV_NONE) {
+		textCopy(str, GFX_MONO_MENU_PARAM_MAX_CHAR, paramCvStrings[cv]);
+	}
+	else if (desc->names != NULL) {
+		textCopy(str, GFX_MONO_MENU_PARAM_MAX_CHAR, desc->names[value - desc->min]);
+	}
+	else {
+		textFormatInt(str, GFX_MONO_MENU_PARAM_MAX_CHAR, desc->format, value);
+	}
+	
+	if (!(desc->flags & PARAM_FLAG_NO_DEF)) {
+		*(bool *)((uint8_t *)disp + desc->defOffset) = (cv == CV_NONE) && (value == desc->def);
+	}
+}
+
+/*
+ *	set a parameter to its default, off any CV selection. the string is left
+ *	for paramRender()
+*/
+void paramSetDefault(const struct ParamDesc *desc, void *base) {
+	paramSet(desc, base, desc->def);
+	if (desc->flags & PARAM_FLAG_CV) {
+		*getCvPtr(desc, base) = CV_NONE;
+	}
+}
+
+/*
+ *	pack a single parameter into an NVM page, followed by its CV selection
+*/
+void paramPack(const struct ParamDesc *desc, const void *base, struct NvmPacker *packer) {
+	nvmPackField(packer, paramGet(desc, base), desc->min, desc->max);
+	if (desc->flags & PARAM_FLAG_CV) {
+		nvmPackField(packer, *((const uint8_t *)base + desc->cvOffset), CV_NONE, CV2);
+	}
+}
+
+/*
+ *	unpack a single parameter & its CV selection, as packed by paramPack()
+*/
+void paramUnpack(const struct ParamDesc *desc, void *base, struct NvmPacker *packer) {
+	paramSet(desc, base, paramUnpackValue(desc, packer));
+	if (desc->flags & PARAM_FLAG_CV) {
+		*getCvPtr(desc, base) = paramUnpackCv(packer);
+	}
+}
+
+/*
+ *	unpack a single parameter value or CV selection from an NVM page, falling
+ *	back to the default when out of range
+*/
+int32_t paramUnpackValue(const struct ParamDesc *desc, struct NvmPacker *packer) {
+	return nvmUnpackField(packer, desc->min, desc->max, desc->def);
+}
+
+uint8_t paramUnpackCv(struct NvmPacker *packer) {
+	return nvmUnpackField(packer, CV_NONE, CV2, CV_NONE);
+}
+
+/*
+ *	set every parameter in a table to its default
+*/
+void paramsSetDefaults(const struct ParamDesc *table, uint8_t count, void *base) {
+	for (uint8_t i=0; i<count; i++) {
+		paramSetDefault(&table[i], base);
+	}
+}
+
+/*
+ *	write the display strings & 'default' states for every parameter in a table
+*/
+void paramsRender(const struct ParamDesc *table, uint8_t count, const void *base, void *disp) {
+	for (uint8_t i=0; i<count; i++) {
+		paramRender(&table[i], base, disp);
+	}
+}
+
+/*
+ *	pack every parameter in a table into an NVM page
+*/
+void paramsPack(const struct ParamDesc *table, uint8_t count, const void *base, struct NvmPacker *packer) {
+	uint8_t i;
+	
+	for (i=0; i<count; i++) {
+		nvmPackField(packer, paramGet(&table[i], base), table[i].min, table[i].max);
+	}
+	for (i=0; i<count; i++) {
+		if (table[i].flags & PARAM_FLAG_CV) {
+			nvmPackField(packer, *((const uint8_t *)base + table[i].cvOffset), CV_NONE, CV2);
+		}
+	}
+}
+
+/*
+ *	unpack every parameter in a table from an NVM page, any field out of range
+ *	falls back to its default
+*/
+void paramsUnpack(const struct ParamDesc *table, uint8_t count, void *base, struct NvmPacker *packer) {
+	uint8_t i;
+	
+	for (i=0; i<count; i++) {
+		paramSet(&table[i], base, paramUnpackValue(&table[i], packer));
+	}
+	for (i=0; i<count; i++) {
+		if (table[i].flags & PARAM_FLAG_CV) {
+			*getCvPtr(&table[i], base) = paramUnpackCv(packer);
+		}
+	}
+}
\ No newline at end of file
@@ -1,5 +1,10 @@
 /*
  *	Utility functions for parameter update functions
+ *
+ *	every user-facing parameter is described by a ParamDesc, kept in a const
+ *	table next to the settings struct it belongs to. the descriptor drives
+ *	menu edits, display strings, 'default' display states and NVM packing, so
+ *	a parameter's range, step, default and strings only live in one place
  */ 
 
 
@@ -8,11 +13,58 @@
 
 #include <stdbool.h>
 #include <stdint.h>
-#include "cv.h"		// for CV enums
+#include <stddef.h>		// for offsetof()
+#include "conf_menu.h"	// for parameter string max char limit
+#include "nvmPack.h"
 
-void updateBool(bool *param, uint8_t *cv, bool inc);
-void updateUint8t(uint8_t *param, uint8_t *cv, bool inc, uint8_t min, uint8_t max, uint8_t step);
-void updateUint16t(uint16_t *param, uint8_t *cv, bool inc, uint16_t min, uint16_t max, uint16_t step);
-void updateInt16t(int16_t *param, uint8_t *cv, bool inc, int16_t min, int16_t max, int16_t step);
+// storage type of a parameter's value within its settings struct
+enum ParamType {
+	PARAM_UINT8,		// uint8_t, also used for bools and enums
+	PARAM_UINT16,
+	PARAM_INT16
+	};
+
+// ParamDesc flags
+#define PARAM_FLAG_CV		0x01	// can be assigned to CV1/CV2 past either end of its range
+#define PARAM_FLAG_NO_DEF	0x02	// no 'default' display state to keep up to date
+
+struct ParamDesc {
+	uint8_t type;				// value storage, as per ParamType enum
+	uint8_t flags;				// PARAM_FLAG_ options
+	int16_t min;
+	int16_t max;
+	int16_t step;				// change per encoder step, enumerated params move one option per detent
+	int16_t def;				// default value
+	const char *format;			// display format for the value ("%d" & "%%" only), NULL for enumerated params
+	const char *const *names;	// display strings for enumerated params, indexed from 'min'
+	uint16_t offset;			// offsets within the settings struct of the value,
+	uint16_t cvOffset;			// and CV selection (if PARAM_FLAG_CV)
+	uint16_t strOffset;			// offsets within the display struct of the display string,
+	uint16_t defOffset;			// and 'default' display state (unless PARAM_FLAG_NO_DEF)
+	};
+
+/*
+ *	single parameter, 'base' points to the settings struct the value offsets are
+ *	relative to and 'disp' to the struct holding the strings. settings that are
+ *	never copied into a snapshot keep their strings alongside, with disp == base
+*/
+int32_t paramGet(const struct ParamDesc *desc, const void *base);
+void paramSet(const struct ParamDesc *desc, void *base, int32_t value);
+void paramUpdate(const struct ParamDesc *desc, void *base, bool inc, uint8_t detents, uint8_t steps);
+void paramRender(const struct ParamDesc *desc, const void *base, void *disp);
+void paramSetDefault(const struct ParamDesc *desc, void *base);
+void paramPack(const struct ParamDesc *desc, const void *base, struct NvmPacker *packer);
+void paramUnpack(const struct ParamDesc *desc, void *base, struct NvmPacker *packer);
+int32_t paramUnpackValue(const struct ParamDesc *desc, struct NvmPacker *packer);
+uint8_t paramUnpackCv(struct NvmPacker *packer);
+
+/*
+ *	whole tables, NVM layout is all values in table order followed by the 
+ *	CV selections of the CV-able params in table order
+*/
+void paramsSetDefaults(const struct ParamDesc *table, uint8_t count, void *base);
+void paramsRender(const struct ParamDesc *table, uint8_t count, const void *base, void *disp);
+void paramsPack(const struct ParamDesc *table, uint8_t count, const void *base, struct NvmPacker *packer);
+void paramsUnpack(const struct ParamDesc *table, uint8_t count, void *base, struct NvmPacker *packer);
 
 #endif /* PARAMUTILS_H_ */
\ No newline at end of file
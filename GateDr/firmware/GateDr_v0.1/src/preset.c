@@ -0,0 +1,148 @@
+/*
+ * source file for preset save & recall
+ *
+ * all preset slots are kept packed in the NVM write-back cache, read once at
+ * boot, so a recall never touches flash. a recall is decoded into a staged
+ * snapshot from the menu or CV path, then swapped into the live settings by
+ * presetApply() at the start of the next processing tick, and published to
+ * processing on that same tick. only settings are swapped, processing state 
+ * carries on, and the display strings, menus and
+ * working NVM pages are brought up to date afterwards in presetTask()
+ */ 
+
+#include "preset.h"
+#include "menu.h"		// for menuInvalidate()
+
+// helper function declaration
+static inline uint8_t getPresetPage(uint8_t slot);
+
+/*
+ *	first emulated EEPROM page of a preset slot (slots numbered from 0)
+*/
+static inline uint8_t getPresetPage(uint8_t slot) {
+	return PRESET_PAGE_START + (slot * NVM_SETTINGS_PAGES);
+}
+
+/*
+ *	read all preset slots into the NVM cache, must be called after the emulated 
+ *	EEPROM has been initialized
+*/
+void presetInit(void) {
+	uint8_t buffer[EEPROM_PAGE_SIZE];
+	
+	for (uint8_t page=PRESET_PAGE_START; page<NVM_PAGE_COUNT; page++) {
+		// an unreadable page reads as blank, and is treated as an empty slot
+		memset(buffer, 0, EEPROM_PAGE_SIZE);
+		eeprom_emulator_read_page(page, buffer);
+		nvmCacheLoadPage(page, buffer);
+	}
+	
+	presets.staged = false;
+	presets.refresh = false;
+	presets.cvSlotPrev = 0;
+}
+
+/*
+ *	save the current channel, CV and global settings to a preset slot
+*/
+void presetSave(uint8_t slot) {
+	uint8_t page = getPresetPage(slot);
+	
+	// make sure the working pages hold the current settings, these don't
+	// touch the cache if nothing has changed
+	writeChannelNVM(&chan[0], 0);
+	writeChannelNVM(&chan[1], 1);
+	writeGlobalSettingsNVM(&globalSettings, &cv_instance);
+	
+	for (uint8_t i=0; i<NVM_SETTINGS_PAGES; i++) {
+		nvmCacheWritePage(page + i, nvm_cache.image[i]);
+	}
+}
+
+/*
+ *	decode a preset slot into the staged snapshots, to be swapped in on the next
+ *	processing tick. returns false (and stages nothing) if the slot is empty
+*/
+bool presetStage(uint8_t slot) {
+	uint8_t page = getPresetPage(slot);
+	uint8_t version;
+	struct NvmPacker packer;
+	uint8_t i;
+	
+	// all three pages need to check out, a slot that has never been saved
+	// won't have a valid header, and one saved with another schema version 
+	// won't unpack into the right fields
+	for (i=0; i<NVM_SETTINGS_PAGES; i++) {
+		if ((nvmCheckPage(nvm_cache.image[page + i], &version) != NVM_PAGE_VALID) ||
+				(version != NVM_SCHEMA_VERSION)) {
+			return false;
+		}
+	}
+	
+	for (i=0; i<2; i++) {
+		nvmPackInit(&packer, nvm_cache.image[page + i]);
+		unpackChannelSnapshot(&presets.stagedChannel[i], &packer);
+	}
+	nvmPackInit(&packer, nvm_cache.image[page + 2]);
+	unpackGlobalSnapshot(&presets.stagedGlobal, &packer);
+	
+	presets.staged = true;
+	return true;
+}
+
+/*
+ *	swap a staged recall into the live settings, called at the start of a
+ *	processing tick (before the channel settings are published) so both
+ *	channels switch over on the same tick
+*/
+void presetApply(void) {
+	if (!presets.staged) {
+		return;
+	}
+	
+	// open both edits before loading either channel, so both publish together
+	beginChannelEdit(&chan[0]);
+	beginChannelEdit(&chan[1]);
+	loadChannelSnapshot(&chan[0], &presets.stagedChannel[0]);
+	loadChannelSnapshot(&chan[1], &presets.stagedChannel[1]);
+	endChannelEdit(&chan[0]);
+	endChannelEdit(&chan[1]);
+	loadGlobalSnapshot(&globalSettings, &cv_instance, &presets.stagedGlobal);
+	
+	presets.staged = false;
+	presets.refresh = true;
+}
+
+/*
+ *	called once per processing loop after the outputs are set. catches the 
+ *	display and working NVM pages up after a swap, and stages a recall when
+ *	the CV selected preset changes
+*/
+void presetTask(struct Cv *cv) {
+	uint8_t slot;
+	
+	if (presets.refresh) {
+		presets.refresh = false;
+		
+		for (uint8_t i=0; i<2; i++) {
+			refreshChannelStrings(&chan[i]);
+			writeChannelNVM(&chan[i], i);
+			writeChannelLoops(&chan[i], i);
+		}
+		writeGlobalStrings(&globalSettings, cv);
+		writeGlobalSettingsNVM(&globalSettings, cv);
+		
+		menuInvalidate();
+	}
+	
+	// recall by CV, only on a change of slot so the CV can be left parked
+	// on a preset while editing
+	if (globalSettings.presetCv != CV_NONE) {
+		slot = normalizeCvUint8(cv, globalSettings.presetCv, 0, NVM_PRESET_COUNT - 1, presets.cvSlotPrev);
+		
+		if (slot != presets.cvSlotPrev) {
+			presets.cvSlotPrev = slot;
+			presetStage(slot);
+		}
+	}
+}
\ No newline at end of file
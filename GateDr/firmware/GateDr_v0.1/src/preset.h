@@ -0,0 +1,39 @@
+/*
+ *	preset slots holding full snapshots of the channel, CV and global settings
+ */ 
+
+
+#ifndef PRESET_H_
+#define PRESET_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>		// for memset()
+#include "eeprom.h"
+#include "nvmCommit.h"
+#include "nvmPack.h"
+#include "channel.h"
+#include "cv.h"
+#include "globalSettings.h"
+
+// each slot is stored as a copy of the channel 1, channel 2 & global pages,
+// starting right after the working settings pages
+#define PRESET_PAGE_START	NVM_SETTINGS_PAGES
+
+struct Presets {
+	struct ChannelSnapshot stagedChannel[2];	// decoded recall waiting to be swapped in
+	struct GlobalSnapshot stagedGlobal;
+	bool staged;				// true when a decoded recall is waiting for the next tick
+	bool refresh;				// true after a swap until strings, menus & NVM are caught up
+	uint8_t cvSlotPrev;			// previous CV slot selection, for hysteresis & change detection
+	};
+
+struct Presets presets;
+
+void presetInit(void);
+void presetSave(uint8_t slot);
+bool presetStage(uint8_t slot);
+void presetApply(void);
+void presetTask(struct Cv *cv);
+
+#endif /* PRESET_H_ */
\ No newline at end of file
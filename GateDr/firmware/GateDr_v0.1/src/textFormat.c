@@ -0,0 +1,96 @@
+/*
+ * source file for display string formatting
+ */ 
+
+#include "textFormat.h"
+
+#define INT_DIGITS_MAX	10
+
+// decimal place values for converting without division, which is a library
+// call on the M0+
+static const uint32_t placeValues[INT_DIGITS_MAX] = {1000000000, 100000000, 10000000, 1000000,
+								100000, 10000, 1000, 100, 10, 1};
+
+// helper function declaration
+static inline uint8_t writeInt(char *dest, uint8_t space, int32_t value);
+
+/*
+ *	copy a string into 'dest', truncated to fit 'size' bytes including the
+ *	terminator. returns the length written
+*/
+uint8_t textCopy(char *dest, uint8_t size, const char *src) {
+	uint8_t len = 0;
+	
+	if (size == 0) {
+		return 0;
+	}
+	
+	while (src[len] != '\0' && len < (size - 1)) {
+		dest[len] = src[len];
+		len++;
+	}
+	dest[len] = '\0';
+	
+	return len;
+}
+
+/*
+ *	write 'format' into 'dest' with "%d" replaced by 'value' and "%%" by '%',
+ *	truncated to fit 'size' bytes including the terminator. returns the 
+ *	length written
+*/
+uint8_t textFormatInt(char *dest, uint8_t size, const char *format, int32_t value) {
+	uint8_t len = 0;
+	
+	if (size == 0) {
+		return 0;
+	}
+	
+	while (*format != '\0' && len < (size - 1)) {
+		if (format[0] == '%' && format[1] == 'd') {
+			len += writeInt(&dest[len], size - 1 - len, value);
+			format += 2;
+		}
+		else if (format[0] == '%' && format[1] == '%') {
+			dest[len++] = '%';
+			format += 2;
+		}
+		else {
+			dest[len++] = *format++;
+		}
+	}
+	dest[len] = '\0';
+	
+	return len;
+}
+
+/*
+ *	write a signed integer's digits (no terminator) into at most 'space' chars,
+ *	returns the number of chars written
+*/
+static inline uint8_t writeInt(char *dest, uint8_t space, int32_t value) {
+	uint32_t magnitude = (value < 0) ? -(uint32_t)value : (uint32_t)value;
+	uint8_t len = 0;
+	uint8_t i = 0;
+	char digit;
+	
+	if (value < 0 && len < space) {
+		dest[len++] = '-';
+	}
+	
+	// skip leading zeros, always writing the ones place
+	while (i < (INT_DIGITS_MAX - 1) && magnitude < placeValues[i]) {
+		i++;
+	}
+	
+	for (; i<INT_DIGITS_MAX && len < space; i++) {
+		digit = '0';
+		while (magnitude >= placeValues[i]) {
+			magnitude -= placeValues[i];
+			digit++;
+		}
+		dest[len++] = digit;
+	}
+	
+	return len;
+}
\ No newline at end of file
@@ -0,0 +1,16 @@
+/*
+ *	small, allocation-free formatting for display strings, covering the
+ *	handful of forms the menus need in place of sprintf(). the release build's
+ *	memory report fails if newlib's printf core is linked back in
+ */ 
+
+
+#ifndef TEXTFORMAT_H_
+#define TEXTFORMAT_H_
+
+#include <stdint.h>
+
+uint8_t textCopy(char *dest, uint8_t size, const char *src);
+uint8_t textFormatInt(char *dest, uint8_t size, const char *format, int32_t value);
+
+#endif /* TEXTFORMAT_H_ */
\ No newline at end of file
@@ -0,0 +1,40 @@
+/*
+ * source file for the free-running timebase
+ */ 
+
+#include "timebase.h"
+#include "tc.h"
+
+static struct tc_module *timebaseTc;
+
+/*
+ *	start TC4 (with TC5 as its upper half) counting freely from 0
+*/
+void timebaseInit(struct tc_module *tc_instance) {
+	struct tc_config conf;
+	
+	timebaseTc = tc_instance;
+	
+	// GCLK0 @ ~48MHz, /64 prescaler (750kHz), counts up to 0xFFFFFFFF & wraps
+	tc_get_config_defaults(&conf);
+	conf.counter_size = TC_COUNTER_SIZE_32BIT;
+	conf.clock_source = GCLK_GENERATOR_0;
+	conf.clock_prescaler = TC_CLOCK_PRESCALER_DIV64;
+	conf.wave_generation = TC_WAVE_GENERATION_NORMAL_FREQ;
+	conf.counter_32_bit.value = 0;
+	tc_init(timebaseTc, TC4, &conf);
+	tc_enable(timebaseTc);
+	
+	// keep COUNT synchronized continuously, so a read never has to request
+	// a sync & wait on it
+	while (tc_is_syncing(timebaseTc)) {
+	}
+	TC4->COUNT32.READREQ.reg = TC_READREQ_RCONT | TC_READREQ_ADDR(TC_COUNT32_COUNT_OFFSET);
+}
+
+/*
+ *	current timebase count, in TIMEBASE_HZ ticks
+*/
+uint32_t timebaseGetCount(void) {
+	return TC4->COUNT32.COUNT.reg;
+}
\ No newline at end of file
@@ -0,0 +1,23 @@
+/*
+ *	free-running 32-bit timebase for timing finer than the 1kHz RTC count,
+ *	TC4 & TC5 chained into a single 32-bit counter off GCLK0. CC0 is left
+ *	to the output timer & CC1 to the master clock
+ */ 
+
+
+#ifndef TIMEBASE_H_
+#define TIMEBASE_H_
+
+#include <stdint.h>
+
+// ~48MHz / 64, wraps every ~95 minutes. intervals are taken by unsigned
+// subtraction, so a wrap between two timestamps doesn't matter
+#define TIMEBASE_HZ			750000UL
+#define TIMEBASE_PER_MS		(TIMEBASE_HZ / 1000)
+
+struct tc_module;
+
+void timebaseInit(struct tc_module *tc_instance);
+uint32_t timebaseGetCount(void);
+
+#endif /* TIMEBASE_H_ */
\ No newline at end of file
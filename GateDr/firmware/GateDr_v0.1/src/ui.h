@@ -6,7 +6,6 @@
 #ifndef UI_H_
 #define UI_H_
 
-#include <stdio.h>
 #include <ssd1306.h>
 #include "conf_menu.h"	// for parameter string max char limit
 #include "extint.h"
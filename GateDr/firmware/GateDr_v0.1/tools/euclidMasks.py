@@ -0,0 +1,68 @@
+#!/usr/bin/env python3
+"""
+generates src/euclidMasks.h, the euclidean pattern for every steps & fills
+setting as a 32 bit mask, bit n set for a hit on step n
+
+hits are spread as by the usual Bresenham accumulator, which holds
+(step * fills) % steps at each step, so step 0 is always a hit. fills past
+the steps are clamped to them. rotation isn't in the table, outputs.c
+rotates the mask when the pattern changes
+
+usage: euclidMasks.py [out.h]
+"""
+
+import sys
+
+STEPS_MAX = 32
+FILLS_MAX = 32
+
+
+def mask(steps, fills):
+    fills = min(fills, steps)
+    bits = 0
+
+    for step in range(steps):
+        if (step * fills) % steps < fills:
+            bits |= 1 << step
+    return bits
+
+
+def main():
+    out = sys.argv[1] if len(sys.argv) > 1 else "src/euclidMasks.h"
+    lines = []
+
+    lines.append("/*")
+    lines.append(" *\teuclidean pattern masks, euclidMasks[steps - 1][fills - 1] has bit n set")
+    lines.append(" *\tfor a hit on step n, before the rotation. generated by")
+    lines.append(" *\ttools/euclidMasks.py, don't edit by hand")
+    lines.append(" *")
+    lines.append(" *\tonly outputs.c includes this. the table stays in flash, it's only read")
+    lines.append(" *\twhen an output's pattern changes")
+    lines.append(" */ ")
+    lines.append("")
+    lines.append("")
+    lines.append("#ifndef EUCLIDMASKS_H_")
+    lines.append("#define EUCLIDMASKS_H_")
+    lines.append("")
+    lines.append("#define EUCLID_MASK_STEPS\t%d" % STEPS_MAX)
+    lines.append("#define EUCLID_MASK_FILLS\t%d" % FILLS_MAX)
+    lines.append("")
+    lines.append("static const uint32_t euclidMasks[EUCLID_MASK_STEPS][EUCLID_MASK_FILLS] = {")
+    for steps in range(1, STEPS_MAX + 1):
+        masks = ["0x%08X" % mask(steps, fills) for fills in range(1, FILLS_MAX + 1)]
+        lines.append("\t// steps = %d" % steps)
+        lines.append("\t{")
+        for i in range(0, FILLS_MAX, 8):
+            lines.append("\t\t" + ", ".join(masks[i:i + 8]) + ("," if i + 8 < FILLS_MAX else ""))
+        lines.append("\t}" + ("," if steps < STEPS_MAX else ""))
+    lines.append("\t};")
+    lines.append("")
+    lines.append("")
+    lines.append("#endif /* EUCLIDMASKS_H_ */")
+
+    with open(out, "w", newline="\n") as f:
+        f.write("\n".join(lines))
+
+
+if __name__ == "__main__":
+    main()
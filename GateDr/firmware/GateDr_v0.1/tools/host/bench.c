@@ -0,0 +1,172 @@
+/*
+ *	throughput benchmark of processChannel() across a matrix of channel
+ *	configurations, for comparing the cost of changes to the processing
+ *	core between commits
+ *
+ *	both channels are set up the same and driven with busy inputs (fast
+ *	clocks, moving CVs). each configuration runs untimed warmup passes, then
+ *	timed repetitions, reported as ns per processChannel() call
+ *
+ *	usage: bench [--format json|csv] [--reps N] [--warmup N] [--ticks N]
+ */ 
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "benchConfigs.h"
+
+#define BENCH_REPS_DEFAULT		15
+#define BENCH_WARMUP_DEFAULT	3
+#define BENCH_TICKS_DEFAULT		(10 * HOST_TICK_RATE)
+
+enum BenchFormat {
+	FORMAT_JSON,
+	FORMAT_CSV
+	};
+
+struct BenchStats {
+	double min;
+	double median;
+	double mean;
+	double stddev;
+	double max;
+	};
+
+// helper function declaration
+static double runConfig(uint8_t config, const struct HostFrame *frames, uint32_t ticks);
+static void getStats(double *samples, uint16_t count, struct BenchStats *stats);
+static int compareDouble(const void *a, const void *b);
+
+int main(int argc, char **argv) {
+	uint8_t format = FORMAT_JSON;
+	uint16_t reps = BENCH_REPS_DEFAULT;
+	uint16_t warmup = BENCH_WARMUP_DEFAULT;
+	uint32_t ticks = BENCH_TICKS_DEFAULT;
+	struct HostFrame *frames;
+	double *samples;
+	struct BenchStats stats;
+	
+	for (int i = 1; i < argc; i++) {
+		bool hasValue = (i + 1) < argc;
+		
+		if (!strcmp(argv[i], "--format") && hasValue) {
+			i++;
+			if (!strcmp(argv[i], "csv")) {
+				format = FORMAT_CSV;
+			}
+			else if (strcmp(argv[i], "json")) {
+				fprintf(stderr, "unknown format '%s'\n", argv[i]);
+				return 2;
+			}
+		}
+		else if (!strcmp(argv[i], "--reps") && hasValue) {
+			reps = (uint16_t)atoi(argv[++i]);
+		}
+		else if (!strcmp(argv[i], "--warmup") && hasValue) {
+			warmup = (uint16_t)atoi(argv[++i]);
+		}
+		else if (!strcmp(argv[i], "--ticks") && hasValue) {
+			ticks = (uint32_t)atol(argv[++i]);
+		}
+		else {
+			fprintf(stderr, "usage: %s [--format json|csv] [--reps N] [--warmup N] [--ticks N]\n", argv[0]);
+			return 2;
+		}
+	}
+	
+	if (reps == 0 || ticks == 0) {
+		fprintf(stderr, "reps & ticks must be at least 1\n");
+		return 2;
+	}
+	
+	frames = malloc(ticks * sizeof(struct HostFrame));
+	samples = malloc(reps * sizeof(double));
+	if (frames == NULL || samples == NULL) {
+		return 1;
+	}
+	hostNoiseSeed(BENCH_SEED);
+	benchRenderInputs(frames, 0, ticks);
+	
+	if (format == FORMAT_CSV) {
+		printf("config,reps,warmup,ticks,min_ns,median_ns,mean_ns,stddev_ns,max_ns\n");
+	}
+	else {
+		printf("{\n  \"unit\": \"ns_per_processChannel\",\n  \"reps\": %u,\n  \"warmup\": %u,\n"
+				"  \"ticks\": %u,\n  \"results\": [\n", reps, warmup, ticks);
+	}
+	
+	for (uint8_t c = 0; c < BENCH_CONFIG_COUNT; c++) {
+		for (uint16_t i = 0; i < warmup; i++) {
+			runConfig(c, frames, ticks);
+		}
+		for (uint16_t i = 0; i < reps; i++) {
+			samples[i] = runConfig(c, frames, ticks);
+		}
+		getStats(samples, reps, &stats);
+		
+		if (format == FORMAT_CSV) {
+			printf("%s,%u,%u,%u,%.2f,%.2f,%.2f,%.2f,%.2f\n", benchConfigs[c].name, reps, warmup, ticks,
+					stats.min, stats.median, stats.mean, stats.stddev, stats.max);
+		}
+		else {
+			printf("    {\"config\": \"%s\", \"min\": %.2f, \"median\": %.2f, \"mean\": %.2f, "
+					"\"stddev\": %.2f, \"max\": %.2f}%s\n", benchConfigs[c].name, stats.min, stats.median,
+					stats.mean, stats.stddev, stats.max, (c + 1 < BENCH_CONFIG_COUNT) ? "," : "");
+		}
+	}
+	
+	if (format == FORMAT_JSON) {
+		printf("  ]\n}\n");
+	}
+	
+	free(samples);
+	free(frames);
+	return 0;
+}
+
+/*
+ *	one timed pass of a configuration from defaults, returns ns per
+ *	processChannel() call
+*/
+static double runConfig(uint8_t config, const struct HostFrame *frames, uint32_t ticks) {
+	volatile uint8_t sink = 0;
+	uint64_t start;
+	
+	benchStart(config);
+	start = hostTimeNs();
+	for (uint32_t t = 0; t < ticks; t++) {
+		sink ^= hostCoreTick(&frames[t]);
+	}
+	
+	// two processChannel() calls per tick
+	return (double)(hostTimeNs() - start) / (2.0 * ticks);
+}
+
+static void getStats(double *samples, uint16_t count, struct BenchStats *stats) {
+	double sum = 0;
+	double squares = 0;
+	
+	qsort(samples, count, sizeof(double), compareDouble);
+	
+	for (uint16_t i = 0; i < count; i++) {
+		sum += samples[i];
+	}
+	stats->mean = sum / count;
+	
+	for (uint16_t i = 0; i < count; i++) {
+		squares += (samples[i] - stats->mean) * (samples[i] - stats->mean);
+	}
+	stats->stddev = (count > 1) ? sqrt(squares / (count - 1)) : 0;
+	
+	stats->min = samples[0];
+	stats->max = samples[count - 1];
+	stats->median = (count & 1) ? samples[count / 2] : (samples[count / 2 - 1] + samples[count / 2]) / 2;
+}
+
+static int compareDouble(const void *a, const void *b) {
+	double x = *(const double *)a;
+	double y = *(const double *)b;
+	
+	return (x > y) - (x < y);
+}
\ No newline at end of file
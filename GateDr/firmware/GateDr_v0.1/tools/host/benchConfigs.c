@@ -0,0 +1,109 @@
+/*
+ * source file for the benchmark configurations
+ */ 
+
+#include "benchConfigs.h"
+
+/*
+ *	defaults, comparators & op only
+*/
+static void setupPlain(struct Channel *ch) {
+	(void)ch;
+}
+
+/*
+ *	every CV-assignable parameter under CV
+*/
+static void setupAllCv(struct Channel *ch) {
+	for (uint8_t i = 0; i < 2; i++) {
+		struct InputSettings *input = &ch->input.input_settings[i];
+		struct OutputSettings *output = &ch->out.output_settings[i];
+		uint8_t sel = i ? CV2 : CV1;
+		
+		input->thresholdCv = sel;
+		input->invertCv = sel;
+		input->hysCv = sel;
+		output->probabilityCv = sel;
+		output->delayCv = sel;
+		output->trigCv = sel;
+		output->trigLenCv = sel;
+		output->clkDivCv = sel;
+		output->clkPhaseCv = sel;
+		ch->op_cv[i] = sel;
+	}
+}
+
+/*
+ *	clock division, delay & triggers all active on both outputs
+*/
+static void setupDelayTrig(struct Channel *ch) {
+	for (uint8_t i = 0; i < 2; i++) {
+		struct OutputSettings *output = &ch->out.output_settings[i];
+		
+		output->clkDiv = 3;
+		output->clkPhase = 2;
+		output->divRst = DIV_RST_IN2;
+		output->delay = 5;
+		output->trig = i ? TRIG_COV : TRIG_RISING;
+		output->trigLen = 20;
+	}
+}
+
+/*
+ *	probability rolls on both outputs
+*/
+static void setupProbability(struct Channel *ch) {
+	ch->out.output_settings[0].probability = 50;
+	ch->out.output_settings[1].probability = 25;
+}
+
+const struct BenchConfig benchConfigs[BENCH_CONFIG_COUNT] = {
+	{"plain_gate",		setupPlain,			OP_AND},
+	{"all_cv",			setupAllCv,			OP_AND},
+	{"delay_trig",		setupDelayTrig,		OP_OR},
+	{"probability",		setupProbability,	OP_OR},
+	{"op_and",			setupPlain,			OP_AND},
+	{"op_nand",			setupPlain,			OP_NAND},
+	{"op_or",			setupPlain,			OP_OR},
+	{"op_nor",			setupPlain,			OP_NOR},
+	{"op_xor",			setupPlain,			OP_XOR},
+	{"op_xnor",			setupPlain,			OP_XNOR},
+	{"op_sr",			setupPlain,			OP_SR},
+	{"op_d",			setupPlain,			OP_D},
+	{"op_byp",			setupPlain,			OP_BYP}
+	};
+
+/*
+ *	reset the core & apply a configuration to both channels, ready to tick
+*/
+void benchStart(uint8_t config) {
+	const struct BenchConfig *bench = &benchConfigs[config];
+	
+	hostCoreInit();
+	for (uint8_t i = 0; i < 2; i++) {
+		beginChannelEdit(&chan[i]);
+		chan[i].op_select[0] = bench->op;
+		chan[i].op_select[1] = bench->op;
+		bench->setup(&chan[i]);
+		endChannelEdit(&chan[i]);
+	}
+	hostCoreSetSeed(BENCH_SEED);
+	hostNoiseSeed(BENCH_SEED);
+}
+
+/*
+ *	busy inputs: clocks into every jack & moving CVs, with some noise. frames
+ *	are rendered in order from 'first', and can be rendered in blocks
+*/
+void benchRenderInputs(struct HostFrame *frames, uint32_t first, uint32_t count) {
+	for (uint32_t i = 0; i < count; i++) {
+		uint32_t t = first + i;
+		
+		frames[i].in[HOST_IN_A] = hostPulse(t, HOST_HZ(40), HOST_HZ(80), 0, 5000) + hostNoise(50);
+		frames[i].in[HOST_IN_B] = hostPulse(t, HOST_HZ(7), HOST_HZ(21), 0, 5000) + hostNoise(50);
+		frames[i].in[HOST_IN_C] = hostTriangle(t, HOST_HZ(30), -5000, 5000);
+		frames[i].in[HOST_IN_D] = hostPulse(t, HOST_HZ(11), HOST_HZ(22), 0, 5000);
+		frames[i].in[HOST_IN_CV1] = hostTriangle(t, HOST_HZ(0.5), 0, 5000) + hostNoise(20);
+		frames[i].in[HOST_IN_CV2] = hostTriangle(t, HOST_HZ(0.3), -5000, 5000) + hostNoise(20);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,26 @@
+/*
+ *	the configuration matrix & input signals shared by the host benchmark
+ *	and the Cortex-M0 benchmark image
+ */ 
+
+
+#ifndef BENCHCONFIGS_H_
+#define BENCHCONFIGS_H_
+
+#include "hostCore.h"
+
+#define BENCH_SEED			0xB3C4
+#define BENCH_CONFIG_COUNT	13
+
+struct BenchConfig {
+	const char *name;
+	void (*setup)(struct Channel *ch);
+	uint8_t op;				// op for both channel ops, unless setup picks
+	};
+
+extern const struct BenchConfig benchConfigs[BENCH_CONFIG_COUNT];
+
+void benchStart(uint8_t config);
+void benchRenderInputs(struct HostFrame *frames, uint32_t first, uint32_t count);
+
+#endif /* BENCHCONFIGS_H_ */
\ No newline at end of file
@@ -0,0 +1,245 @@
+/*
+ * source file for the host processing core harness
+ */ 
+
+#include <stdlib.h>
+#include <string.h>
+#include "hostCore.h"
+
+// byte size of one CV input's settings in a legacy (v0) global page, as in globalSettings.c
+#define LEGACY_SIZE_CV	3
+
+// helper function declaration
+static void hostCoreReset(void);
+static void hostReadCvSettings(struct Cv *cv);
+
+// ticks since hostCoreInit(), hostRtcCount is derived from this
+static uint32_t hostTickCount;
+// state for hostNoise()
+static uint32_t hostNoiseState;
+
+/*
+ *	reset the core to factory defaults on a blank EEPROM, ready to tick
+*/
+void hostCoreInit(void) {
+	hostFlashErase();
+	hostTickCount = 0;
+	hostRtcCount = 0;
+	hostTimebaseCount = 0;
+	hostCommitWorst.pageWrites = 0;
+	hostCommitWorst.rowErases = 0;
+	hostCoreReset();
+	
+	// a blank flash area doesn't hold a valid emulator, format it the way
+	// configure_eeprom() does
+	if (eeprom_emulator_init() != STATUS_OK) {
+		eeprom_emulator_erase_memory();
+		eeprom_emulator_init();
+	}
+	
+	setCvDefaults(&cv_instance);
+	setMasterClockDefaults(&masterClock.settings);
+	masterClockInit(&masterClock, hostTimebaseCount);
+	
+	for (uint8_t i = 0; i < 2; i++) {
+		setChannelDefaults(&chan[i], i);
+		initChannel(&chan[i], &hostRtcCount, &hostTimebaseCount, i);
+	}
+	
+	hostCoreSetSeed(1);
+}
+
+/*
+ *	reset the core & boot it from a saved settings image (channel pages 0 & 1,
+ *	global/CV page 2), written to a blank EEPROM. returns a bit per page that
+ *	failed its CRC & was loaded with defaults
+*/
+uint8_t hostCoreLoadSettings(const uint8_t pages[NVM_SETTINGS_PAGES][EEPROM_PAGE_SIZE]) {
+	uint8_t defaulted = 0;
+	uint8_t version;
+	
+	hostCoreInit();
+	
+	for (uint8_t i = 0; i < NVM_SETTINGS_PAGES; i++) {
+		eeprom_emulator_write_page(i, pages[i]);
+		eeprom_emulator_commit_page_buffer();
+		if (nvmCheckPage(pages[i], &version) == NVM_PAGE_CORRUPT) {
+			defaulted |= (1 << i);
+		}
+	}
+	
+	hostCoreBoot();
+	return defaulted;
+}
+
+/*
+ *	restart the core from whatever the flash area holds, the way configure_eeprom()
+ *	and main() do at power up, through the firmware's own unpack code. the
+ *	timebase carries on from where it was so a run can continue over the restart
+*/
+void hostCoreBoot(void) {
+	hostCoreReset();
+	eeprom_emulator_init();
+	
+	hostReadCvSettings(&cv_instance);
+	setMasterClockDefaults(&masterClock.settings);
+	masterClockInit(&masterClock, hostTimebaseCount);
+	
+	for (uint8_t i = 0; i < 2; i++) {
+		readChannelNVM(&chan[i], i);
+		initChannel(&chan[i], &hostRtcCount, &hostTimebaseCount, i);
+	}
+}
+
+/*
+ *	cut the power. with 'bod' the brown-out interrupt gets its chance to commit
+ *	the page in the emulator's page buffer first, as it does on the module
+ *	for a slow enough supply drop, otherwise the page buffer is lost
+*/
+void hostCorePowerLoss(bool bod) {
+	if (bod) {
+		nvmCommitFlush();
+	}
+	
+	hostFlashPowerLoss();
+}
+
+/*
+ *	clear all of the core's working memory, as at power up
+*/
+static void hostCoreReset(void) {
+	memset(chan, 0, sizeof(chan));
+	memset(&cv_instance, 0, sizeof(cv_instance));
+	memset(&nvm_cache, 0, sizeof(nvm_cache));
+	nvmCacheInit(&hostRtcCount);
+}
+
+/*
+ *	the CV half of readGlobalSettingsNVM(). globalSettings.c brings in the UI
+ *	so it isn't built on the host, the CV settings are unpacked here with the
+ *	same descriptors & in the same order instead
+*/
+static void hostReadCvSettings(struct Cv *cv) {
+	uint8_t buffer[EEPROM_PAGE_SIZE];
+	uint8_t version;
+	struct NvmPacker packer;
+	
+	eeprom_emulator_read_page(2, buffer);
+	nvmCacheLoadPage(2, buffer);
+	
+	switch (nvmCheckPage(buffer, &version)) {
+		case NVM_PAGE_VALID:
+			nvmPackInit(&packer, buffer);
+			for (uint8_t i = 0; i < 2; i++) {
+				paramsUnpack(cvParams, CV_PARAM_COUNT, &cv->settings[i], &packer);
+			}
+			break;
+		case NVM_PAGE_LEGACY:
+			for (uint8_t i = 0; i < 2; i++) {
+				unpackCvSettingsLegacy(&cv->settings[i], &buffer[i*LEGACY_SIZE_CV]);
+			}
+			break;
+		case NVM_PAGE_CORRUPT:
+			setCvDefaults(cv);
+			break;
+	}
+}
+
+/*
+ *	seed the probability rolls, the module seeds from ADC noise at boot
+*/
+void hostCoreSetSeed(unsigned int seed) {
+	srand(seed);
+}
+
+/*
+ *	run one pass of the processing loop, returns the output states as
+ *	HostOutputs bits
+*/
+uint8_t hostCoreTick(const struct HostFrame *frame) {
+	uint8_t outputs = 0;
+	struct HostFlashOps ops;
+	
+	hostRtcCount = hostTickCount / HOST_TICKS_PER_MS;
+	hostTimebaseCount = hostTickCount * (TIMEBASE_HZ / HOST_TICK_RATE);
+	hostTickCount++;
+	
+	publishChannelSettings(&chan[0]);
+	publishChannelSettings(&chan[1]);
+	
+	cv_instance.value[0] = frame->in[HOST_IN_CV1];
+	cv_instance.value[1] = frame->in[HOST_IN_CV2];
+	
+	// the module lands master clock edges from an interrupt, here they're
+	// landed at the start of the tick they fall in
+	masterClockAdvance(&masterClock, hostTimebaseCount);
+	masterClockUpdate(&masterClock, &cv_instance);
+	
+	processChannel(&chan[0], frame->in[HOST_IN_A], frame->in[HOST_IN_B], &cv_instance);
+	processChannel(&chan[1], frame->in[HOST_IN_C], frame->in[HOST_IN_D], &cv_instance);
+	
+	saveChannelLoops(&chan[0], 0);
+	saveChannelLoops(&chan[1], 1);
+	
+	// commit engine, keeping track of the most flash work done by a single step
+	ops = hostFlashOps;
+	nvmCommitTask();
+	ops.pageWrites = hostFlashOps.pageWrites - ops.pageWrites;
+	ops.rowErases = hostFlashOps.rowErases - ops.rowErases;
+	if ((ops.pageWrites + ops.rowErases) > (hostCommitWorst.pageWrites + hostCommitWorst.rowErases)) {
+		hostCommitWorst = ops;
+	}
+	
+	outputs |= chan[0].out.output_state[0].out_processed ? HOST_OUT_W : 0;
+	outputs |= chan[0].out.output_state[1].out_processed ? HOST_OUT_X : 0;
+	outputs |= chan[1].out.output_state[0].out_processed ? HOST_OUT_Y : 0;
+	outputs |= chan[1].out.output_state[1].out_processed ? HOST_OUT_Z : 0;
+	
+	return outputs;
+}
+
+#ifndef HOST_BARE_METAL
+#include <time.h>
+
+/*
+ *	monotonic time in ns, for throughput measurements
+*/
+uint64_t hostTimeNs(void) {
+	struct timespec now;
+	
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec;
+}
+#endif
+
+/*
+ *	triangle wave between 'low' & 'high' over 'period' ticks
+*/
+int16_t hostTriangle(uint32_t tick, uint32_t period, int16_t low, int16_t high) {
+	uint32_t phase = tick % period;
+	int32_t span = high - low;
+	
+	if (phase < (period / 2)) {
+		return low + (int32_t)((int64_t)span * phase / (period / 2));
+	}
+	return high - (int32_t)((int64_t)span * (phase - period / 2) / (period - period / 2));
+}
+
+/*
+ *	pulse wave, 'high' for the first 'width' ticks of each 'period'
+*/
+int16_t hostPulse(uint32_t tick, uint32_t period, uint32_t width, int16_t low, int16_t high) {
+	return ((tick % period) < width) ? high : low;
+}
+
+void hostNoiseSeed(uint32_t seed) {
+	hostNoiseState = seed;
+}
+
+/*
+ *	deterministic noise within +/-amplitude, from a 32-bit LCG
+*/
+int16_t hostNoise(int16_t amplitude) {
+	hostNoiseState = hostNoiseState * 1664525u + 1013904223u;
+	return (int16_t)((int32_t)(hostNoiseState >> 16) % (2 * amplitude + 1)) - amplitude;
+}
\ No newline at end of file
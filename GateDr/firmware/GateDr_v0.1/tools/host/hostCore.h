@@ -0,0 +1,77 @@
+/*
+ *	runs the firmware's processing core (channels, CV, settings pages) on a
+ *	host, the same way the main loop does on the module
+ *
+ *	one host tick stands for one pass of the processing loop. the loop is
+ *	paced by the ADC scan, which is free-running at roughly 3.5kHz (8 inputs
+ *	from a 48MHz/256 ADC clock), so the RTC count advances once every
+ *	HOST_TICKS_PER_MS ticks, and the timebase by TIMEBASE_HZ / HOST_TICK_RATE
+ *	counts per tick
+ */ 
+
+
+#ifndef HOSTCORE_H_
+#define HOSTCORE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "channel.h"
+#include "cv.h"
+#include "nvmCommit.h"
+#include "hostFlash.h"
+
+#define HOST_TICKS_PER_MS	4
+#define HOST_TICK_RATE		(HOST_TICKS_PER_MS * 1000)
+
+// period in ticks of a signal at x Hz
+#define HOST_HZ(x)			((uint32_t)(HOST_TICK_RATE / (x)))
+
+// jacks, in the order used by HostFrame
+enum HostInputs {
+	HOST_IN_A,
+	HOST_IN_B,
+	HOST_IN_C,
+	HOST_IN_D,
+	HOST_IN_CV1,
+	HOST_IN_CV2,
+	HOST_IN_COUNT
+	};
+
+// output bits returned by hostCoreTick()
+enum HostOutputs {
+	HOST_OUT_W = 0x01,
+	HOST_OUT_X = 0x02,
+	HOST_OUT_Y = 0x04,
+	HOST_OUT_Z = 0x08
+	};
+
+// the input voltages (in mV) seen by one tick
+struct HostFrame {
+	int16_t in[HOST_IN_COUNT];
+	};
+
+uint32_t hostRtcCount;
+uint32_t hostTimebaseCount;
+struct HostFlashOps hostCommitWorst;	// most flash work done by one commit engine step since hostCoreInit()
+
+void hostCoreInit(void);
+uint8_t hostCoreLoadSettings(const uint8_t pages[NVM_SETTINGS_PAGES][EEPROM_PAGE_SIZE]);
+void hostCoreBoot(void);
+void hostCorePowerLoss(bool bod);
+void hostCoreSetSeed(unsigned int seed);
+uint8_t hostCoreTick(const struct HostFrame *frame);
+
+// not available in the bare metal benchmark image, see tools/m0bench
+#ifndef HOST_BARE_METAL
+uint64_t hostTimeNs(void);
+#endif
+
+/*
+ *	integer test signals, in mV, so generated inputs are the same everywhere
+*/
+int16_t hostTriangle(uint32_t tick, uint32_t period, int16_t low, int16_t high);
+int16_t hostPulse(uint32_t tick, uint32_t period, uint32_t width, int16_t low, int16_t high);
+void hostNoiseSeed(uint32_t seed);
+int16_t hostNoise(int16_t amplitude);
+
+#endif /* HOSTCORE_H_ */
\ No newline at end of file
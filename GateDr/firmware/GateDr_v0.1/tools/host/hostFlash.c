@@ -0,0 +1,116 @@
+/*
+ * source file for the host flash image & NVM driver stand-ins
+ */ 
+
+#include <string.h>
+#include <nvm.h>
+#include "hostFlash.h"
+
+#define HOST_FLASH_ROW_SIZE		(NVMCTRL_PAGE_SIZE * NVMCTRL_ROW_PAGES)
+
+// NVM controller page buffer, all 1s when clear like the hardware's
+static uint8_t hostPageBuffer[NVMCTRL_PAGE_SIZE];
+
+// helper function declaration
+static inline uint32_t getFlashOffset(uint32_t address);
+
+/*
+ *	offset into the flash image of a device address handed over by the emulator.
+ *	the emulator passes addresses as 32 bits, which keeps the low bits of a
+ *	pointer into hostFlash, so the offset still comes out right on a 64 bit host
+*/
+static inline uint32_t getFlashOffset(uint32_t address) {
+	return address - (uint32_t)(uintptr_t)hostFlash;
+}
+
+/*
+ *	erase the whole flash area & clear the page buffer, as on a new module
+*/
+void hostFlashErase(void) {
+	memset(hostFlash, 0xFF, sizeof(hostFlash));
+	memset(hostPageBuffer, 0xFF, sizeof(hostPageBuffer));
+	memset(&hostFlashOps, 0, sizeof(hostFlashOps));
+}
+
+/*
+ *	lose power, anything in the page buffer that hasn't been written is gone
+*/
+void hostFlashPowerLoss(void) {
+	memset(hostPageBuffer, 0xFF, sizeof(hostPageBuffer));
+}
+
+/*
+ *	NVM driver stand-ins, just the calls the EEPROM emulator makes
+*/
+enum status_code nvm_set_config(const struct nvm_config *const config) {
+	return STATUS_OK;
+}
+
+void nvm_get_parameters(struct nvm_parameters *const parameters) {
+	parameters->page_size = NVMCTRL_PAGE_SIZE;
+	parameters->nvm_number_of_pages = 2048;
+	parameters->eeprom_number_of_pages = HOST_FLASH_PAGES;
+	parameters->bootloader_number_of_pages = 0;
+}
+
+enum status_code nvm_write_buffer(const uint32_t destination_address, const uint8_t *buffer, uint16_t length) {
+	uint32_t offset = getFlashOffset(destination_address);
+	
+	if ((offset >= HOST_FLASH_SIZE) || ((offset % NVMCTRL_PAGE_SIZE) + length > NVMCTRL_PAGE_SIZE)) {
+		return STATUS_ERR_BAD_ADDRESS;
+	}
+	
+	// the driver clears the page buffer before loading it
+	memset(hostPageBuffer, 0xFF, sizeof(hostPageBuffer));
+	memcpy(&hostPageBuffer[offset % NVMCTRL_PAGE_SIZE], buffer, length);
+	return STATUS_OK;
+}
+
+enum status_code nvm_read_buffer(const uint32_t source_address, uint8_t *const buffer, uint16_t length) {
+	uint32_t offset = getFlashOffset(source_address);
+	
+	if ((offset >= HOST_FLASH_SIZE) || (offset + length > HOST_FLASH_SIZE)) {
+		return STATUS_ERR_BAD_ADDRESS;
+	}
+	
+	memcpy(buffer, &hostFlash[offset], length);
+	return STATUS_OK;
+}
+
+enum status_code nvm_erase_row(const uint32_t row_address) {
+	uint32_t offset = getFlashOffset(row_address);
+	
+	if ((offset >= HOST_FLASH_SIZE) || (offset % HOST_FLASH_ROW_SIZE)) {
+		return STATUS_ERR_BAD_ADDRESS;
+	}
+	
+	memset(&hostFlash[offset], 0xFF, HOST_FLASH_ROW_SIZE);
+	hostFlashOps.rowErases++;
+	return STATUS_OK;
+}
+
+enum status_code nvm_execute_command(const enum nvm_command command, const uint32_t address, const uint32_t parameter) {
+	uint32_t offset = getFlashOffset(address) & ~(uint32_t)(NVMCTRL_PAGE_SIZE - 1);
+	
+	if (offset >= HOST_FLASH_SIZE) {
+		return STATUS_ERR_BAD_ADDRESS;
+	}
+	
+	switch (command) {
+		case NVM_COMMAND_ERASE_ROW:
+			return nvm_erase_row(address);
+		case NVM_COMMAND_WRITE_PAGE:
+			// programming can only clear bits, the buffer is left clear afterwards
+			for (uint8_t i = 0; i < NVMCTRL_PAGE_SIZE; i++) {
+				hostFlash[offset + i] &= hostPageBuffer[i];
+			}
+			memset(hostPageBuffer, 0xFF, sizeof(hostPageBuffer));
+			hostFlashOps.pageWrites++;
+			return STATUS_OK;
+		case NVM_COMMAND_PAGE_BUFFER_CLEAR:
+			memset(hostPageBuffer, 0xFF, sizeof(hostPageBuffer));
+			return STATUS_OK;
+	}
+	
+	return STATUS_ERR_INVALID_ARG;
+}
\ No newline at end of file
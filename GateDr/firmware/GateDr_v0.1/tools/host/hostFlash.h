@@ -0,0 +1,30 @@
+/*
+ *	the flash area behind the EEPROM emulator, as a RAM image on the host.
+ *	the firmware's own emulator service (from its ASF tree) runs over it
+ *	through the NVM driver stand-ins in hostFlash.c, which model the NVM
+ *	controller's page buffer so a power loss can drop a write in flight
+ */ 
+
+
+#ifndef HOSTFLASH_H_
+#define HOSTFLASH_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <compiler.h>	// for the flash geometry
+
+#define HOST_FLASH_PAGES	(HOST_FLASH_SIZE / NVMCTRL_PAGE_SIZE)
+
+// flash operations since hostFlashErase(), the slow ones that hold the CPU
+struct HostFlashOps {
+	uint32_t pageWrites;
+	uint32_t rowErases;
+	};
+
+uint8_t hostFlash[HOST_FLASH_SIZE];
+struct HostFlashOps hostFlashOps;
+
+void hostFlashErase(void);
+void hostFlashPowerLoss(void);
+
+#endif /* HOSTFLASH_H_ */
\ No newline at end of file
@@ -0,0 +1,278 @@
+/*
+ *	renders a saved patch against recorded input, to reproduce what a module
+ *	did with real material. the settings image (the 3 settings pages: channel
+ *	1, channel 2 & global/CV, as written by writeChannelNVM() &
+ *	writeGlobalSettingsNVM()) is loaded through the firmware's own unpack
+ *	code, then the recording is streamed through the processing core & W/X/Y/Z
+ *	are written out at the module's tick rate
+ *
+ *	input channels go to A, B, C, D, CV1 & CV2 in order, or by name from a
+ *	CSV header row, or as listed by --map ('-' skips a channel). unpatched
+ *	jacks read 0V. inputs are sampled & held at the tick rate without any
+ *	filtering, like the ADC scan
+ *
+ *	usage: render [options] <input.wav|.csv|-> <output.wav|.csv|->
+ *	  --settings <file>     settings image, 3 pages of 60 bytes, or a full
+ *	                        EEPROM page dump starting from page 0. factory
+ *	                        defaults without one
+ *	  --map <jacks>         jack per input channel, e.g. A,B,-,CV1
+ *	  --full-scale <mV>     mV at WAV full scale, default 10000
+ *	  --rate <Hz>           CSV input sample rate, default the tick rate
+ *	  --high <mV>           WAV output level of a high gate, default 5000
+ *	  --changes             CSV output only has rows where an output changes
+ *	  --seed <n>            seed for the probability rolls
+ */ 
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include "hostCore.h"
+#include "signalFile.h"
+
+#define RENDER_FULL_SCALE	10000
+#define RENDER_HIGH			5000
+#define RENDER_SEED			1
+#define JACK_NONE			-1
+
+static const char *jackNames[HOST_IN_COUNT] = {"A", "B", "C", "D", "CV1", "CV2"};
+static const char *outputNames[SIGNAL_GATE_COUNT] = {"W", "X", "Y", "Z"};
+
+// helper function declaration
+static int readSettingsImage(const char *path, uint8_t pages[NVM_SETTINGS_PAGES][EEPROM_PAGE_SIZE]);
+static int8_t jackForName(const char *name);
+static int mapChannels(const struct SignalReader *reader, char *map, int8_t *jacks);
+
+int main(int argc, char **argv) {
+	const char *settingsPath = NULL;
+	const char *inputPath = NULL;
+	const char *outputPath = NULL;
+	char *map = NULL;
+	int32_t fullScale = RENDER_FULL_SCALE;
+	int32_t high = RENDER_HIGH;
+	uint32_t csvRate = HOST_TICK_RATE;
+	unsigned int seed = RENDER_SEED;
+	bool changesOnly = false;
+	
+	static struct SignalReader reader;
+	struct GateWriter writer;
+	uint8_t pages[NVM_SETTINGS_PAGES][EEPROM_PAGE_SIZE];
+	int8_t jacks[SIGNAL_MAX_CHANNELS];
+	int16_t sample[SIGNAL_MAX_CHANNELS];
+	struct HostFrame frame = {{0}};
+	uint32_t edges[SIGNAL_GATE_COUNT] = {0};
+	uint64_t tick = 0;
+	uint64_t samples = 0;
+	uint64_t start;
+	double seconds;
+	uint8_t outputs;
+	uint8_t last = 0;
+	int status = 0;
+	
+	for (int i = 1; i < argc; i++) {
+		if (!strcmp(argv[i], "--settings") && (i + 1) < argc) {
+			settingsPath = argv[++i];
+		}
+		else if (!strcmp(argv[i], "--map") && (i + 1) < argc) {
+			map = argv[++i];
+		}
+		else if (!strcmp(argv[i], "--full-scale") && (i + 1) < argc) {
+			fullScale = atoi(argv[++i]);
+		}
+		else if (!strcmp(argv[i], "--rate") && (i + 1) < argc) {
+			csvRate = (uint32_t)atoi(argv[++i]);
+		}
+		else if (!strcmp(argv[i], "--high") && (i + 1) < argc) {
+			high = atoi(argv[++i]);
+		}
+		else if (!strcmp(argv[i], "--changes")) {
+			changesOnly = true;
+		}
+		else if (!strcmp(argv[i], "--seed") && (i + 1) < argc) {
+			seed = (unsigned int)strtoul(argv[++i], NULL, 0);
+		}
+		else if (argv[i][0] != '-' || !strcmp(argv[i], "-")) {
+			if (inputPath == NULL) {
+				inputPath = argv[i];
+			}
+			else if (outputPath == NULL) {
+				outputPath = argv[i];
+			}
+			else {
+				inputPath = NULL;
+				break;
+			}
+		}
+		else {
+			inputPath = NULL;
+			break;
+		}
+	}
+	
+	if (inputPath == NULL || outputPath == NULL) {
+		fprintf(stderr, "usage: %s [--settings <image>] [--map <jacks>] [--full-scale <mV>] [--rate <Hz>]\n"
+				"       [--high <mV>] [--changes] [--seed <n>] <input.wav|.csv|-> <output.wav|.csv|->\n", argv[0]);
+		return 2;
+	}
+	if (fullScale <= 0 || csvRate == 0) {
+		fprintf(stderr, "--full-scale & --rate must be positive\n");
+		return 2;
+	}
+	
+	// settings
+	if (settingsPath != NULL) {
+		uint8_t defaulted;
+		
+		if (readSettingsImage(settingsPath, pages)) {
+			return 1;
+		}
+		defaulted = hostCoreLoadSettings(pages);
+		for (uint8_t i = 0; i < NVM_SETTINGS_PAGES; i++) {
+			if (defaulted & (1 << i)) {
+				fprintf(stderr, "%s: page %u failed its CRC, loaded defaults as the module would\n", settingsPath, i);
+			}
+		}
+	}
+	else {
+		hostCoreInit();
+	}
+	hostCoreSetSeed(seed);
+	
+	// streams
+	if (signalReaderOpen(&reader, inputPath, csvRate, fullScale) || mapChannels(&reader, map, jacks)) {
+		return 1;
+	}
+	if (gateWriterOpen(&writer, outputPath, HOST_TICK_RATE, high, fullScale, changesOnly)) {
+		signalReaderClose(&reader);
+		return 1;
+	}
+	
+	start = hostTimeNs();
+	
+	while (true) {
+		// the sample in effect at a tick is the latest one at or before it
+		uint64_t due = tick * reader.rate / HOST_TICK_RATE;
+		
+		while (samples <= due && (status = signalReaderNext(&reader, sample)) > 0) {
+			samples++;
+		}
+		if (status <= 0) {
+			break;
+		}
+		
+		for (uint16_t c = 0; c < reader.channels; c++) {
+			if (jacks[c] != JACK_NONE) {
+				frame.in[jacks[c]] = sample[c];
+			}
+		}
+		
+		outputs = hostCoreTick(&frame);
+		if (gateWriterPut(&writer, tick, outputs)) {
+			status = -1;
+			break;
+		}
+		
+		for (uint8_t i = 0; i < SIGNAL_GATE_COUNT; i++) {
+			edges[i] += (outputs & ~last) & (1 << i) ? 1 : 0;
+		}
+		last = outputs;
+		tick++;
+	}
+	
+	seconds = (hostTimeNs() - start) / 1e9;
+	signalReaderClose(&reader);
+	
+	if (gateWriterClose(&writer) || status < 0) {
+		fprintf(stderr, "%s\n", status < 0 ? "read or write error" : "write error");
+		return 1;
+	}
+	
+	fprintf(stderr, "%llu ticks (%.1fs at %dHz) in %.2fs, %.0fx real time\n", (unsigned long long)tick,
+			(double)tick / HOST_TICK_RATE, HOST_TICK_RATE, seconds,
+			seconds > 0 ? (double)tick / HOST_TICK_RATE / seconds : 0.0);
+	for (uint8_t i = 0; i < SIGNAL_GATE_COUNT; i++) {
+		fprintf(stderr, "%s: %u rising edges\n", outputNames[i], edges[i]);
+	}
+	
+	return 0;
+}
+
+/*
+ *	the first NVM_SETTINGS_PAGES pages of an image made of whole EEPROM pages
+*/
+static int readSettingsImage(const char *path, uint8_t pages[NVM_SETTINGS_PAGES][EEPROM_PAGE_SIZE]) {
+	FILE *file = fopen(path, "rb");
+	long size;
+	
+	if (file == NULL) {
+		fprintf(stderr, "%s: can't open for reading\n", path);
+		return -1;
+	}
+	
+	fseek(file, 0, SEEK_END);
+	size = ftell(file);
+	rewind(file);
+	
+	if (size < NVM_SETTINGS_PAGES * EEPROM_PAGE_SIZE || (size % EEPROM_PAGE_SIZE) != 0
+			|| fread(pages, EEPROM_PAGE_SIZE, NVM_SETTINGS_PAGES, file) != NVM_SETTINGS_PAGES) {
+		fprintf(stderr, "%s: expected at least %d whole %d byte pages\n", path, NVM_SETTINGS_PAGES, EEPROM_PAGE_SIZE);
+		fclose(file);
+		return -1;
+	}
+	
+	fclose(file);
+	return 0;
+}
+
+static int8_t jackForName(const char *name) {
+	for (int8_t i = 0; i < HOST_IN_COUNT; i++) {
+		if (!strcasecmp(name, jackNames[i])) {
+			return i;
+		}
+	}
+	return JACK_NONE;
+}
+
+/*
+ *	pick the jack for each input channel from --map, then the CSV header,
+ *	then the channel order
+*/
+static int mapChannels(const struct SignalReader *reader, char *map, int8_t *jacks) {
+	uint16_t mapped = 0;
+	
+	for (uint16_t c = 0; c < SIGNAL_MAX_CHANNELS; c++) {
+		jacks[c] = JACK_NONE;
+	}
+	
+	if (map != NULL) {
+		for (char *name = strtok(map, ","); name != NULL; name = strtok(NULL, ",")) {
+			if (mapped == reader->channels) {
+				fprintf(stderr, "--map lists more jacks than the input's %u channels\n", reader->channels);
+				return -1;
+			}
+			jacks[mapped] = jackForName(name);
+			if (jacks[mapped] == JACK_NONE && strcmp(name, "-")) {
+				fprintf(stderr, "--map: unknown jack '%s'\n", name);
+				return -1;
+			}
+			mapped++;
+		}
+	}
+	else if (reader->named) {
+		for (uint16_t c = 0; c < reader->channels; c++) {
+			jacks[c] = jackForName(reader->names[c]);
+		}
+	}
+	else {
+		for (uint16_t c = 0; c < reader->channels && c < HOST_IN_COUNT; c++) {
+			jacks[c] = c;
+		}
+	}
+	
+	for (uint16_t c = 0; c < reader->channels; c++) {
+		if (jacks[c] != JACK_NONE) {
+			fprintf(stderr, "input channel %u -> %s\n", c + 1, jackNames[jacks[c]]);
+		}
+	}
+	return 0;
+}
\ No newline at end of file
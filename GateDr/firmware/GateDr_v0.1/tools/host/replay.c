@@ -0,0 +1,1053 @@
+/*
+ *	replays a library of synthetic patch scenarios through the processing
+ *	core and summarizes each one by a hash of its output trace, along with
+ *	host throughput
+ *
+ *	each scenario's trace (every output change, tick and WXYZ states) is
+ *	checked against its golden copy in golden/<scenario>.txt. a scenario that
+ *	differs prints where its trace parts ways with the golden one and fails
+ *	the run. after an intended behavior change, --update-golden writes the
+ *	new traces over the golden ones to be checked in with the change
+ *
+ *	the hashes are a behavior fingerprint: build this against a reference
+ *	revision as well (make SRC=<checkout>/GateDr/firmware/GateDr_v0.1/src) and
+ *	compare the two summaries, run with --no-time so they diff cleanly. when
+ *	a hash differs, --trace <scenario> prints the trace to find where the two
+ *	builds part ways
+ *
+ *	after the scenarios, the glitch filter's latency is measured for every
+ *	filter setting: the delay in timebase counts from an input edge on the
+ *	unfiltered output to the same edge on the filtered one, which should be
+ *	the configured width give or take a sample (one processing loop). a pulse
+ *	shorter than the width should be rejected outright
+ *
+ *	the run finishes with a check of the deferred NVM commit engine against
+ *	the firmware's EEPROM emulator over a simulated flash area: settings
+ *	surviving a power cycle, held off edits lost to one without BOD & written
+ *	out with it, edits cancelled by editing back, the BOD commit, and enough
+ *	commits to move the emulator's rows around. a failed check fails the run
+ *
+ *	usage: replay [--no-time] [--list] [--trace <scenario>] [--update-golden]
+ */ 
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "hostCore.h"
+
+#define SCENARIO_TICKS		(20 * HOST_TICK_RATE)	// 20 seconds
+#define SCENARIO_SEED		0x6A7E
+#define TIMING_RUNS			5
+#define FNV_OFFSET			0x811C9DC5u
+#define FNV_PRIME			0x01000193u
+#define NVM_SETTLE_TICKS	(4 * HOST_TICK_RATE)	// past the commit holdoff
+#define NVM_EARLY_TICKS		(HOST_TICK_RATE / 2)	// well within it
+#define NVM_CYCLE_EDITS		200
+#define FILTER_WIDTH_COUNTS	(TIMEBASE_HZ / 10000)	// per filter setting step (100us)
+#define SAMPLE_COUNTS		(TIMEBASE_HZ / HOST_TICK_RATE)	// timebase counts per tick
+#define FILTER_MARGIN_TICKS	20		// settling time around each filter check pulse
+#define FILTER_HIGH			5000	// pulse levels, either side of the default threshold
+#define FILTER_LOW			0
+#define GOLDEN_DIFF_LINES	8		// differing trace lines shown per scenario
+#define TRACE_LINE_LEN		32
+
+#ifndef GOLDEN_DIR
+#define GOLDEN_DIR			"golden"
+#endif
+
+struct Scenario {
+	const char *name;
+	void (*setup)(void);
+	void (*inputs)(uint32_t tick, struct HostFrame *frame);
+	};
+
+struct TraceSummary {
+	uint32_t edges;			// output changes over the run
+	uint32_t hash;			// FNV-1a over each change's tick & output bits
+	};
+
+// timebase counts of a pulse's edges on the unfiltered (W) & filtered (X) outputs
+struct FilterEdges {
+	uint32_t rise;
+	uint32_t fall;
+	uint32_t filteredRise;
+	uint32_t filteredFall;
+	bool passed;			// the pulse made it to the unfiltered output
+	bool filtered;			// ...and through the filter
+	};
+
+// helper function declaration
+static void runScenario(const struct Scenario *scenario, const struct HostFrame *frames, FILE *trace, struct TraceSummary *summary);
+static uint32_t hashWord(uint32_t hash, uint32_t word);
+static FILE *openGolden(const char *name, const char *mode);
+static bool checkGolden(const char *name, FILE *trace);
+static bool checkGlitchFilter(void);
+static void runFilterPulse(uint32_t ticks, struct FilterEdges *edges);
+static bool filterDelayOk(uint32_t delay, uint32_t width);
+static bool checkNvmResume(void);
+static void runIdle(uint32_t ticks);
+static void editThreshold(int16_t threshold);
+static bool nvmCheck(bool pass, const char *what);
+
+/*
+ *	comparator thresholds & hysteresis against slow noisy LFOs
+*/
+static void setupComparators(void) {
+	beginChannelEdit(&chan[0]);
+	chan[0].input.input_settings[0].threshold = 0;
+	chan[0].input.input_settings[0].hysteresis = 30;
+	chan[0].input.input_settings[1].threshold = 1000;
+	chan[0].input.input_settings[1].hysteresis = 0;
+	chan[0].input.input_settings[1].invert = true;
+	chan[0].op_select[0] = OP_BYP;
+	chan[0].op_select[1] = OP_BYP;
+	endChannelEdit(&chan[0]);
+	
+	beginChannelEdit(&chan[1]);
+	chan[1].input.copyIn1 = true;
+	chan[1].input.input_settings[0].threshold = -2000;
+	chan[1].input.input_settings[0].hysteresis = 50;
+	chan[1].input.input_settings[1].threshold = 2000;
+	chan[1].input.input_settings[1].hysteresis = 5;
+	chan[1].op_select[0] = OP_AND;
+	chan[1].op_select[1] = OP_XOR;
+	endChannelEdit(&chan[1]);
+}
+
+static void inputsComparators(uint32_t tick, struct HostFrame *frame) {
+	frame->in[HOST_IN_A] = hostTriangle(tick, HOST_HZ(2), -5000, 5000) + hostNoise(200);
+	frame->in[HOST_IN_B] = hostTriangle(tick, HOST_HZ(0.7), -1000, 3000) + hostNoise(50);
+	frame->in[HOST_IN_C] = hostTriangle(tick, HOST_HZ(1.3), -8000, 8000) + hostNoise(400);
+}
+
+/*
+ *	minimum pulse width filtering of noisy slow inputs with no hysteresis,
+ *	filtered & unfiltered side by side
+*/
+static void setupGlitchFilter(void) {
+	beginChannelEdit(&chan[0]);
+	chan[0].input.copyIn1 = true;
+	chan[0].input.input_settings[0].hysteresis = 0;
+	chan[0].input.input_settings[1].hysteresis = 0;
+	chan[0].input.input_settings[1].filter = 20;
+	chan[0].op_select[0] = OP_BYP;
+	chan[0].op_select[1] = OP_BYP;
+	endChannelEdit(&chan[0]);
+	
+	beginChannelEdit(&chan[1]);
+	chan[1].input.input_settings[0].hysteresis = 0;
+	chan[1].input.input_settings[0].filter = 5;
+	chan[1].input.input_settings[0].invert = true;
+	chan[1].input.input_settings[1].filter = 100;
+	chan[1].op_select[0] = OP_BYP;
+	chan[1].op_select[1] = OP_BYP;
+	endChannelEdit(&chan[1]);
+}
+
+static void inputsGlitchFilter(uint32_t tick, struct HostFrame *frame) {
+	frame->in[HOST_IN_A] = hostTriangle(tick, HOST_HZ(0.9), -3000, 5000) + hostNoise(300);
+	frame->in[HOST_IN_C] = hostTriangle(tick, HOST_HZ(3), -5000, 5000) + hostNoise(150);
+	frame->in[HOST_IN_D] = hostPulse(tick, HOST_HZ(7), HOST_HZ(70), 0, 5000) + hostNoise(100);
+}
+
+/*
+ *	window comparators for each output zone, with the window moved & resized
+ *	by CV, feeding a window-only gate & its complement
+*/
+static void setupWindow(void) {
+	beginChannelEdit(&chan[0]);
+	chan[0].input.copyIn1 = true;
+	chan[0].input.input_settings[0].mode = INPUT_MODE_WINDOW;
+	chan[0].input.input_settings[0].threshold = 2000;
+	chan[0].input.input_settings[0].winSize = 2000;
+	chan[0].input.input_settings[1].mode = INPUT_MODE_WINDOW;
+	chan[0].input.input_settings[1].threshold = -1000;
+	chan[0].input.input_settings[1].winSize = 4000;
+	chan[0].input.input_settings[1].winOut = WINDOW_OUT_ABOVE;
+	chan[0].input.input_settings[1].hysteresis = 30;
+	chan[0].op_select[0] = OP_BYP;
+	chan[0].op_select[1] = OP_BYP;
+	endChannelEdit(&chan[0]);
+	
+	beginChannelEdit(&chan[1]);
+	chan[1].input.input_settings[0].mode = INPUT_MODE_WINDOW;
+	chan[1].input.input_settings[0].winOut = WINDOW_OUT_BELOW;
+	chan[1].input.input_settings[0].thresholdCv = CV1;
+	chan[1].input.input_settings[0].winSizeCv = CV2;
+	chan[1].input.input_settings[1].mode = INPUT_MODE_WINDOW;
+	chan[1].input.input_settings[1].threshold = 0;
+	chan[1].input.input_settings[1].winSize = 600;
+	chan[1].input.input_settings[1].invert = true;
+	chan[1].op_select[0] = OP_BYP;
+	chan[1].op_select[1] = OP_NOR;
+	endChannelEdit(&chan[1]);
+}
+
+static void inputsWindow(uint32_t tick, struct HostFrame *frame) {
+	frame->in[HOST_IN_A] = hostTriangle(tick, HOST_HZ(1.1), -6000, 7000) + hostNoise(60);
+	frame->in[HOST_IN_C] = hostTriangle(tick, HOST_HZ(2.3), -4000, 4000) + hostNoise(60);
+	frame->in[HOST_IN_D] = hostTriangle(tick, HOST_HZ(0.8), -2000, 2000) + hostNoise(60);
+	frame->in[HOST_IN_CV1] = hostTriangle(tick, HOST_HZ(0.3), -3000, 3000);
+	frame->in[HOST_IN_CV2] = hostTriangle(tick, HOST_HZ(0.13), -8000, 8000);
+}
+
+/*
+ *	slope detectors on LFOs: rise & fall gates, and peak & trough gates off
+ *	the turnarounds, one with its slope threshold under CV
+*/
+static void setupSlope(void) {
+	beginChannelEdit(&chan[0]);
+	chan[0].input.copyIn1 = true;
+	chan[0].input.input_settings[0].slope = SLOPE_RISE;
+	chan[0].input.input_settings[0].slopeLen = 8;
+	chan[0].input.input_settings[1].slope = SLOPE_FALL;
+	chan[0].input.input_settings[1].slopeLen = 8;
+	chan[0].input.input_settings[1].threshold = 2000;
+	chan[0].op_select[0] = OP_BYP;
+	chan[0].op_select[1] = OP_BYP;
+	endChannelEdit(&chan[0]);
+	
+	beginChannelEdit(&chan[1]);
+	chan[1].input.input_settings[0].slope = SLOPE_PEAK;
+	chan[1].input.input_settings[0].slopeLen = 16;
+	chan[1].input.input_settings[0].thresholdCv = CV1;
+	chan[1].input.input_settings[1].slope = SLOPE_TROUGH;
+	chan[1].input.input_settings[1].slopeLen = 32;
+	chan[1].input.input_settings[1].threshold = 400;
+	chan[1].op_select[0] = OP_BYP;
+	chan[1].op_select[1] = OP_BYP;
+	endChannelEdit(&chan[1]);
+}
+
+static void inputsSlope(uint32_t tick, struct HostFrame *frame) {
+	frame->in[HOST_IN_A] = hostTriangle(tick, HOST_HZ(1.3), -5000, 5000) + hostNoise(60);
+	frame->in[HOST_IN_C] = hostTriangle(tick, HOST_HZ(0.9), -4000, 6000) + hostNoise(60);
+	frame->in[HOST_IN_D] = hostTriangle(tick, HOST_HZ(0.4), -3000, 3000) + hostNoise(60);
+	frame->in[HOST_IN_CV1] = hostTriangle(tick, HOST_HZ(0.1), 400, 3000);
+}
+
+/*
+ *	S-R latches from two clocks, D latches from a slow data gate & fast clock
+*/
+static void setupLatches(void) {
+	beginChannelEdit(&chan[0]);
+	chan[0].op_select[0] = OP_SR;
+	chan[0].op_select[1] = OP_SR;
+	endChannelEdit(&chan[0]);
+	
+	beginChannelEdit(&chan[1]);
+	chan[1].op_select[0] = OP_D;
+	chan[1].op_select[1] = OP_D;
+	endChannelEdit(&chan[1]);
+}
+
+static void inputsLatches(uint32_t tick, struct HostFrame *frame) {
+	frame->in[HOST_IN_A] = hostPulse(tick, HOST_HZ(3), HOST_HZ(30), 0, 5000);
+	frame->in[HOST_IN_B] = hostPulse(tick + 97, HOST_HZ(5), HOST_HZ(10), 0, 5000);
+	frame->in[HOST_IN_C] = hostPulse(tick, HOST_HZ(0.7), HOST_HZ(2), 0, 5000);
+	frame->in[HOST_IN_D] = hostPulse(tick, HOST_HZ(8), HOST_HZ(40), 0, 5000);
+}
+
+/*
+ *	clock division with phases (including phase past the division) and each
+ *	of the reset sources
+*/
+static void setupClockDiv(void) {
+	beginChannelEdit(&chan[0]);
+	chan[0].op_select[0] = OP_BYP;
+	chan[0].op_select[1] = OP_BYP;
+	chan[0].out.output_settings[0].clkDiv = 4;
+	chan[0].out.output_settings[0].clkPhase = 1;
+	chan[0].out.output_settings[1].clkDiv = 3;
+	chan[0].out.output_settings[1].clkPhase = 2;
+	chan[0].out.output_settings[1].divRst = DIV_RST_IN1;
+	endChannelEdit(&chan[0]);
+	
+	beginChannelEdit(&chan[1]);
+	chan[1].op_select[0] = OP_BYP;
+	chan[1].op_select[1] = OP_OR;
+	chan[1].out.output_settings[0].clkDiv = 7;
+	chan[1].out.output_settings[0].clkPhase = 9;
+	chan[1].out.output_settings[0].divRst = DIV_RST_CV1;
+	chan[1].out.output_settings[1].clkDiv = 32;
+	chan[1].out.output_settings[1].clkPhase = 32;
+	chan[1].out.output_settings[1].divRst = DIV_RST_IN2;
+	endChannelEdit(&chan[1]);
+}
+
+static void inputsClockDiv(uint32_t tick, struct HostFrame *frame) {
+	frame->in[HOST_IN_A] = hostPulse(tick, HOST_HZ(2.1), HOST_HZ(20), 0, 5000);
+	frame->in[HOST_IN_B] = hostPulse(tick, HOST_HZ(20), HOST_HZ(40), 0, 5000);
+	frame->in[HOST_IN_C] = hostPulse(tick, HOST_HZ(16), HOST_HZ(32), 0, 5000);
+	frame->in[HOST_IN_D] = hostPulse(tick, HOST_HZ(0.3), HOST_HZ(20), 0, 5000);
+	frame->in[HOST_IN_CV1] = hostPulse(tick, HOST_HZ(0.9), HOST_HZ(10), 0, 5000);
+}
+
+/*
+ *	clock multiplication against a steady clock and one that speeds up, feeding
+ *	the divider downstream
+*/
+static void setupClockMult(void) {
+	beginChannelEdit(&chan[0]);
+	chan[0].op_select[0] = OP_BYP;
+	chan[0].op_select[1] = OP_BYP;
+	chan[0].out.output_settings[0].clkMult = 4;
+	chan[0].out.output_settings[1].clkMult = 16;
+	chan[0].out.output_settings[1].clkDiv = 3;
+	endChannelEdit(&chan[0]);
+	
+	beginChannelEdit(&chan[1]);
+	chan[1].op_select[0] = OP_BYP;
+	chan[1].op_select[1] = OP_BYP;
+	chan[1].out.output_settings[0].clkMult = 3;
+	chan[1].out.output_settings[1].clkMult = 8;
+	chan[1].out.output_settings[1].clkMultCv = CV1;
+	endChannelEdit(&chan[1]);
+}
+
+static void inputsClockMult(uint32_t tick, struct HostFrame *frame) {
+	uint32_t period = tick < HOST_TICK_RATE * 3 ? HOST_HZ(2) : HOST_HZ(5);
+	
+	frame->in[HOST_IN_A] = hostPulse(tick, HOST_HZ(2), HOST_HZ(20), 0, 5000);
+	frame->in[HOST_IN_C] = hostPulse(tick, period, period / 2, 0, 5000);
+	frame->in[HOST_IN_CV1] = hostTriangle(tick, HOST_HZ(0.2), 0, 5000);
+}
+
+/*
+ *	inputs taking the master clock, swung & at a CV swept tempo, against a jack,
+ *	inverted and through the divider
+*/
+static void setupMasterClock(void) {
+	masterClock.settings.bpm = 140;
+	masterClock.settings.swing = 66;
+	masterClock.settings.bpmCv = CV1;
+	
+	beginChannelEdit(&chan[0]);
+	chan[0].input.input_settings[0].source = INPUT_SOURCE_CLOCK;
+	chan[0].op_select[0] = OP_BYP;
+	chan[0].op_select[1] = OP_AND;
+	chan[0].out.output_settings[1].clkDiv = 3;
+	endChannelEdit(&chan[0]);
+	
+	beginChannelEdit(&chan[1]);
+	chan[1].input.input_settings[0].source = INPUT_SOURCE_CLOCK;
+	chan[1].input.input_settings[1].source = INPUT_SOURCE_CLOCK;
+	chan[1].input.input_settings[1].invert = true;
+	chan[1].op_select[0] = OP_BYP;
+	chan[1].op_select[1] = OP_XOR;
+	endChannelEdit(&chan[1]);
+}
+
+static void inputsMasterClock(uint32_t tick, struct HostFrame *frame) {
+	frame->in[HOST_IN_B] = hostPulse(tick, HOST_HZ(0.5), HOST_HZ(1), 0, 5000);
+	frame->in[HOST_IN_CV1] = hostTriangle(tick, HOST_HZ(0.2), 0, 5000);
+}
+
+/*
+ *	50% duty division of a short trigger clock, with & without multiplication
+ *	and resynced from a reset input
+*/
+static void setupDivDuty(void) {
+	beginChannelEdit(&chan[0]);
+	chan[0].op_select[0] = OP_BYP;
+	chan[0].op_select[1] = OP_BYP;
+	chan[0].out.output_settings[0].clkDiv = 4;
+	chan[0].out.output_settings[0].divDuty = DIV_DUTY_HALF;
+	chan[0].out.output_settings[1].clkDiv = 3;
+	chan[0].out.output_settings[1].clkMult = 2;
+	chan[0].out.output_settings[1].divDuty = DIV_DUTY_HALF;
+	chan[0].out.output_settings[1].divRst = DIV_RST_IN2;
+	endChannelEdit(&chan[0]);
+	
+	beginChannelEdit(&chan[1]);
+	chan[1].op_select[0] = OP_BYP;
+	chan[1].op_select[1] = OP_BYP;
+	chan[1].out.output_settings[0].clkDiv = 5;
+	chan[1].out.output_settings[0].clkPhase = 3;
+	chan[1].out.output_settings[0].divDuty = DIV_DUTY_HALF;
+	chan[1].out.output_settings[0].divRst = DIV_RST_CV1;
+	endChannelEdit(&chan[1]);
+}
+
+static void inputsDivDuty(uint32_t tick, struct HostFrame *frame) {
+	frame->in[HOST_IN_A] = hostPulse(tick, HOST_HZ(4), HOST_HZ(100), 0, 5000);
+	frame->in[HOST_IN_B] = hostPulse(tick + 311, HOST_HZ(0.3), HOST_HZ(20), 0, 5000);
+	frame->in[HOST_IN_C] = hostPulse(tick, HOST_HZ(6), HOST_HZ(100), 0, 5000);
+	frame->in[HOST_IN_CV1] = hostPulse(tick + 97, HOST_HZ(0.45), HOST_HZ(20), 0, 5000);
+}
+
+/*
+ *	euclidean patterns after the divider, with CV sweeping the fills & rotation
+ *	& a reset restarting the pattern
+*/
+static void setupEuclid(void) {
+	beginChannelEdit(&chan[0]);
+	chan[0].op_select[0] = OP_BYP;
+	chan[0].op_select[1] = OP_BYP;
+	chan[0].out.output_settings[0].eucSteps = 8;
+	chan[0].out.output_settings[0].eucFills = 3;
+	chan[0].out.output_settings[1].clkDiv = 2;
+	chan[0].out.output_settings[1].eucSteps = 16;
+	chan[0].out.output_settings[1].eucFills = 5;
+	chan[0].out.output_settings[1].eucRotate = 2;
+	chan[0].out.output_settings[1].divRst = DIV_RST_IN2;
+	endChannelEdit(&chan[0]);
+	
+	beginChannelEdit(&chan[1]);
+	chan[1].op_select[0] = OP_BYP;
+	chan[1].op_select[1] = OP_BYP;
+	chan[1].out.output_settings[0].eucSteps = 32;
+	chan[1].out.output_settings[0].eucFillsCv = CV1;
+	chan[1].out.output_settings[1].eucSteps = 12;
+	chan[1].out.output_settings[1].eucFills = 5;
+	chan[1].out.output_settings[1].eucRotateCv = CV2;
+	endChannelEdit(&chan[1]);
+}
+
+static void inputsEuclid(uint32_t tick, struct HostFrame *frame) {
+	frame->in[HOST_IN_A] = hostPulse(tick, HOST_HZ(8), HOST_HZ(80), 0, 5000);
+	frame->in[HOST_IN_B] = hostPulse(tick + 53, HOST_HZ(0.25), HOST_HZ(20), 0, 5000);
+	frame->in[HOST_IN_C] = hostPulse(tick, HOST_HZ(12), HOST_HZ(48), 0, 5000);
+	frame->in[HOST_IN_CV1] = hostTriangle(tick, HOST_HZ(0.5), 0, 5000) + hostNoise(30);
+	frame->in[HOST_IN_CV2] = hostTriangle(tick, HOST_HZ(0.3), 0, 5000);
+}
+
+/*
+ *	looped probability, fully locked & partly locked loops, & CV moving the lock
+*/
+static void setupProbLoop(void) {
+	beginChannelEdit(&chan[0]);
+	chan[0].op_select[0] = OP_BYP;
+	chan[0].op_select[1] = OP_BYP;
+	chan[0].out.output_settings[0].probability = 50;
+	chan[0].out.output_settings[0].probMode = PROB_MODE_LOOP;
+	chan[0].out.output_settings[0].probLock = 100;
+	chan[0].out.output_settings[0].probLength = 8;
+	chan[0].out.output_settings[1].probability = 60;
+	chan[0].out.output_settings[1].probMode = PROB_MODE_LOOP;
+	chan[0].out.output_settings[1].probLock = 80;
+	chan[0].out.output_settings[1].probLength = 16;
+	endChannelEdit(&chan[0]);
+	
+	beginChannelEdit(&chan[1]);
+	chan[1].op_select[0] = OP_BYP;
+	chan[1].out.out2_settings = OUT2_FOLLOW;
+	chan[1].out.output_settings[0].probability = 40;
+	chan[1].out.output_settings[0].probMode = PROB_MODE_LOOP;
+	chan[1].out.output_settings[0].probLockCv = CV1;
+	chan[1].out.output_settings[0].probLengthCv = CV2;
+	endChannelEdit(&chan[1]);
+}
+
+static void inputsProbLoop(uint32_t tick, struct HostFrame *frame) {
+	frame->in[HOST_IN_A] = hostPulse(tick, HOST_HZ(8), HOST_HZ(40), 0, 5000);
+	frame->in[HOST_IN_C] = hostPulse(tick, HOST_HZ(10), HOST_HZ(40), 0, 5000);
+	frame->in[HOST_IN_CV1] = hostTriangle(tick, HOST_HZ(0.25), 0, 5000);
+	frame->in[HOST_IN_CV2] = hostTriangle(tick, HOST_HZ(0.1), 0, 5000);
+}
+
+/*
+ *	delays shorter & longer than the incoming gates
+*/
+static void setupDelay(void) {
+	beginChannelEdit(&chan[0]);
+	chan[0].op_select[0] = OP_BYP;
+	chan[0].op_select[1] = OP_BYP;
+	chan[0].out.output_settings[0].delay = 35;
+	chan[0].out.output_settings[1].delay = 500;
+	endChannelEdit(&chan[0]);
+	
+	beginChannelEdit(&chan[1]);
+	chan[1].op_select[0] = OP_OR;
+	chan[1].out.output_settings[0].delay = 1000;
+	chan[1].out.out2_settings = OUT2_FOLLOW;
+	endChannelEdit(&chan[1]);
+}
+
+static void inputsDelay(uint32_t tick, struct HostFrame *frame) {
+	frame->in[HOST_IN_A] = hostPulse(tick, HOST_HZ(4), HOST_HZ(8), 0, 5000);
+	frame->in[HOST_IN_B] = hostPulse(tick, HOST_HZ(1.1), HOST_HZ(1.5), 0, 5000);
+	frame->in[HOST_IN_C] = hostPulse(tick, HOST_HZ(0.4), HOST_HZ(0.6), 0, 5000);
+	frame->in[HOST_IN_D] = hostPulse(tick, HOST_HZ(2.5), HOST_HZ(50), 0, 5000);
+}
+
+/*
+ *	probability with a fixed seed, alongside a Bernoulli pair
+*/
+static void setupProbability(void) {
+	beginChannelEdit(&chan[0]);
+	chan[0].op_select[0] = OP_BYP;
+	chan[0].out.output_settings[0].probability = 50;
+	chan[0].out.out2_settings = OUT2_BERN;
+	endChannelEdit(&chan[0]);
+	
+	beginChannelEdit(&chan[1]);
+	chan[1].op_select[0] = OP_BYP;
+	chan[1].op_select[1] = OP_BYP;
+	chan[1].out.output_settings[0].probability = 5;
+	chan[1].out.output_settings[1].probability = 95;
+	endChannelEdit(&chan[1]);
+}
+
+static void inputsProbability(uint32_t tick, struct HostFrame *frame) {
+	frame->in[HOST_IN_A] = hostPulse(tick, HOST_HZ(12), HOST_HZ(24), 0, 5000);
+	frame->in[HOST_IN_C] = hostPulse(tick, HOST_HZ(9), HOST_HZ(18), 0, 5000);
+	frame->in[HOST_IN_D] = hostPulse(tick, HOST_HZ(7), HOST_HZ(30), 0, 5000);
+}
+
+/*
+ *	bursts from plain gates & through the trig stage, with CV on the count
+ *	& interval
+*/
+static void setupBurst(void) {
+	beginChannelEdit(&chan[0]);
+	chan[0].op_select[0] = OP_BYP;
+	chan[0].op_select[1] = OP_BYP;
+	chan[0].out.output_settings[0].burstCount = 4;
+	chan[0].out.output_settings[0].burstInterval = 20;
+	chan[0].out.output_settings[1].burstCount = 3;
+	chan[0].out.output_settings[1].burstInterval = 50;
+	chan[0].out.output_settings[1].trig = TRIG_RISING;
+	chan[0].out.output_settings[1].trigLen = 20;
+	endChannelEdit(&chan[0]);
+	
+	beginChannelEdit(&chan[1]);
+	chan[1].op_select[0] = OP_BYP;
+	chan[1].out.out2_settings = OUT2_INVERT;
+	chan[1].out.output_settings[0].probability = 70;
+	chan[1].out.output_settings[0].burstCountCv = CV1;
+	chan[1].out.output_settings[0].burstIntervalCv = CV2;
+	endChannelEdit(&chan[1]);
+}
+
+static void inputsBurst(uint32_t tick, struct HostFrame *frame) {
+	frame->in[HOST_IN_A] = hostPulse(tick, HOST_HZ(2), HOST_HZ(10), 0, 5000);
+	frame->in[HOST_IN_B] = hostPulse(tick, HOST_HZ(1.3), HOST_HZ(50), 0, 5000);
+	frame->in[HOST_IN_C] = hostPulse(tick, HOST_HZ(3), HOST_HZ(30), 0, 5000);
+	frame->in[HOST_IN_CV1] = hostTriangle(tick, HOST_HZ(0.4), 0, 5000);
+	frame->in[HOST_IN_CV2] = hostTriangle(tick, HOST_HZ(0.15), 0, 5000);
+}
+
+/*
+ *	every trigger mode, with trigger lengths shorter & longer than the gates
+*/
+static void setupTrigModes(void) {
+	beginChannelEdit(&chan[0]);
+	chan[0].op_select[0] = OP_BYP;
+	chan[0].op_select[1] = OP_BYP;
+	chan[0].out.output_settings[0].trig = TRIG_RISING;
+	chan[0].out.output_settings[0].trigLen = 20;
+	chan[0].out.output_settings[1].trig = TRIG_FALLING;
+	chan[0].out.output_settings[1].trigLen = 200;
+	endChannelEdit(&chan[0]);
+	
+	beginChannelEdit(&chan[1]);
+	chan[1].op_select[0] = OP_BYP;
+	chan[1].op_select[1] = OP_BYP;
+	chan[1].out.output_settings[0].trig = TRIG_COV;
+	chan[1].out.output_settings[0].trigLen = 2000;
+	chan[1].out.output_settings[1].trig = TRIG_TOGGLE;
+	endChannelEdit(&chan[1]);
+}
+
+static void inputsTrigModes(uint32_t tick, struct HostFrame *frame) {
+	frame->in[HOST_IN_A] = hostPulse(tick, HOST_HZ(6), HOST_HZ(60), 0, 5000);
+	frame->in[HOST_IN_B] = hostPulse(tick, HOST_HZ(2), HOST_HZ(3), 0, 5000);
+	frame->in[HOST_IN_C] = hostPulse(tick, HOST_HZ(0.3), HOST_HZ(1), 0, 5000);
+	frame->in[HOST_IN_D] = hostPulse(tick, HOST_HZ(5), HOST_HZ(50), 0, 5000);
+}
+
+/*
+ *	OUT2 following a processed OUT1, and inverting a triggered one
+*/
+static void setupOut2Modes(void) {
+	beginChannelEdit(&chan[0]);
+	chan[0].op_select[0] = OP_XOR;
+	chan[0].out.output_settings[0].clkDiv = 2;
+	chan[0].out.output_settings[0].delay = 10;
+	chan[0].out.out2_settings = OUT2_FOLLOW;
+	endChannelEdit(&chan[0]);
+	
+	beginChannelEdit(&chan[1]);
+	chan[1].op_select[0] = OP_NOR;
+	chan[1].out.output_settings[0].trig = TRIG_RISING;
+	chan[1].out.output_settings[0].trigLen = 60;
+	chan[1].out.out2_settings = OUT2_INVERT;
+	endChannelEdit(&chan[1]);
+}
+
+static void inputsOut2Modes(uint32_t tick, struct HostFrame *frame) {
+	frame->in[HOST_IN_A] = hostPulse(tick, HOST_HZ(8), HOST_HZ(16), 0, 5000);
+	frame->in[HOST_IN_B] = hostPulse(tick, HOST_HZ(3), HOST_HZ(6), 0, 5000);
+	frame->in[HOST_IN_C] = hostPulse(tick, HOST_HZ(5), HOST_HZ(10), 0, 5000);
+	frame->in[HOST_IN_D] = hostPulse(tick, HOST_HZ(1.5), HOST_HZ(6), 0, 5000);
+}
+
+/*
+ *	every CV-assignable parameter under CV, spread over the outputs so each
+ *	still sees gates through the rest of its processing
+*/
+static void setupCvControl(void) {
+	struct InputSettings *inputs = chan[0].input.input_settings;
+	struct OutputSettings *outputs0 = chan[0].out.output_settings;
+	struct OutputSettings *outputs1 = chan[1].out.output_settings;
+	
+	beginChannelEdit(&chan[0]);
+	inputs[0].hysCv = CV1;
+	inputs[0].invertCv = CV2;
+	inputs[1].thresholdCv = CV1;
+	chan[0].op_cv[0] = CV2;
+	outputs0[0].probabilityCv = CV1;
+	outputs0[0].trigCv = CV2;
+	outputs0[0].trigLenCv = CV1;
+	outputs0[1].delayCv = CV2;
+	endChannelEdit(&chan[0]);
+	
+	beginChannelEdit(&chan[1]);
+	chan[1].op_select[0] = OP_BYP;
+	chan[1].op_cv[1] = CV1;
+	outputs1[0].clkDivCv = CV1;
+	outputs1[0].clkPhaseCv = CV2;
+	outputs1[1].trigCv = CV1;
+	outputs1[1].trigLenCv = CV2;
+	endChannelEdit(&chan[1]);
+	
+	cv_instance.settings[0].range = UNI_5;
+	cv_instance.settings[1].range = BI_8;
+}
+
+static void inputsCvControl(uint32_t tick, struct HostFrame *frame) {
+	frame->in[HOST_IN_A] = hostTriangle(tick, HOST_HZ(1.7), -4000, 4000) + hostNoise(100);
+	frame->in[HOST_IN_B] = hostTriangle(tick, HOST_HZ(3), -1000, 6000);
+	frame->in[HOST_IN_C] = hostPulse(tick, HOST_HZ(24), HOST_HZ(48), 0, 5000);
+	frame->in[HOST_IN_D] = hostPulse(tick, HOST_HZ(1.1), HOST_HZ(2), 0, 5000);
+	frame->in[HOST_IN_CV1] = hostTriangle(tick, HOST_HZ(0.4), -500, 5500) + hostNoise(30);
+	frame->in[HOST_IN_CV2] = hostTriangle(tick, HOST_HZ(0.15), -8000, 8000) + hostNoise(30);
+}
+
+static const struct Scenario scenarios[] = {
+	{"comparator_hys",	setupComparators,	inputsComparators},
+	{"glitch_filter",	setupGlitchFilter,	inputsGlitchFilter},
+	{"window",			setupWindow,		inputsWindow},
+	{"slope",			setupSlope,			inputsSlope},
+	{"latches",			setupLatches,		inputsLatches},
+	{"clock_div",		setupClockDiv,		inputsClockDiv},
+	{"clock_mult",		setupClockMult,		inputsClockMult},
+	{"master_clock",	setupMasterClock,	inputsMasterClock},
+	{"div_duty",		setupDivDuty,		inputsDivDuty},
+	{"euclid",			setupEuclid,		inputsEuclid},
+	{"delay",			setupDelay,			inputsDelay},
+	{"probability",		setupProbability,	inputsProbability},
+	{"prob_loop",		setupProbLoop,		inputsProbLoop},
+	{"burst",			setupBurst,			inputsBurst},
+	{"trig_modes",		setupTrigModes,		inputsTrigModes},
+	{"out2_modes",		setupOut2Modes,		inputsOut2Modes},
+	{"cv_control",		setupCvControl,		inputsCvControl}
+	};
+
+#define SCENARIO_COUNT	(sizeof(scenarios) / sizeof(scenarios[0]))
+
+int main(int argc, char **argv) {
+	bool timing = true;
+	bool update = false;
+	bool pass = true;
+	const char *traceName = NULL;
+	struct HostFrame *frames;
+	struct TraceSummary summary;
+	uint8_t page[EEPROM_PAGE_SIZE] = {0};
+	
+	for (int i = 1; i < argc; i++) {
+		if (!strcmp(argv[i], "--no-time")) {
+			timing = false;
+		}
+		else if (!strcmp(argv[i], "--trace") && (i + 1) < argc) {
+			traceName = argv[++i];
+		}
+		else if (!strcmp(argv[i], "--update-golden")) {
+			update = true;
+		}
+		else if (!strcmp(argv[i], "--list")) {
+			for (uint8_t s = 0; s < SCENARIO_COUNT; s++) {
+				printf("%s\n", scenarios[s].name);
+			}
+			return 0;
+		}
+		else {
+			fprintf(stderr, "usage: %s [--no-time] [--list] [--trace <scenario>] [--update-golden]\n", argv[0]);
+			return 2;
+		}
+	}
+	
+	frames = malloc(SCENARIO_TICKS * sizeof(struct HostFrame));
+	if (frames == NULL) {
+		return 1;
+	}
+	
+	// a settings table that's grown into the loop registers fails the run
+	hostCoreInit();
+	if (!packChannelNVM(&chan[0], page)) {
+		fprintf(stderr, "channel settings overrun the NVM loop registers\n");
+		return 1;
+	}
+	
+	if (traceName == NULL) {
+		printf("%-16s %8s %8s %10s%s\n", "# scenario", "ticks", "edges", "hash", timing ? "    ns/tick" : "");
+	}
+	
+	for (uint8_t s = 0; s < SCENARIO_COUNT; s++) {
+		const struct Scenario *scenario = &scenarios[s];
+		FILE *trace;
+		
+		if ((traceName != NULL) && strcmp(traceName, scenario->name)) {
+			continue;
+		}
+		
+		// the trace goes to stdout, over the golden copy, or aside to check
+		if (traceName != NULL) {
+			trace = stdout;
+		}
+		else if (update) {
+			trace = openGolden(scenario->name, "w");
+		}
+		else {
+			trace = tmpfile();
+		}
+		if (trace == NULL) {
+			fprintf(stderr, "can't open a trace for %s\n", scenario->name);
+			return 1;
+		}
+		
+		// render the inputs up front so timing only covers processing
+		hostNoiseSeed(SCENARIO_SEED);
+		memset(frames, 0, SCENARIO_TICKS * sizeof(struct HostFrame));
+		for (uint32_t t = 0; t < SCENARIO_TICKS; t++) {
+			scenario->inputs(t, &frames[t]);
+		}
+		
+		runScenario(scenario, frames, trace, &summary);
+		if (traceName != NULL) {
+			return 0;
+		}
+		
+		printf("%-16s %8u %8u 0x%08x", scenario->name, SCENARIO_TICKS, summary.edges, summary.hash);
+		
+		if (timing) {
+			uint64_t best = UINT64_MAX;
+			
+			for (uint8_t run = 0; run < TIMING_RUNS; run++) {
+				uint64_t start = hostTimeNs();
+				runScenario(scenario, frames, NULL, &summary);
+				uint64_t elapsed = hostTimeNs() - start;
+				best = (elapsed < best) ? elapsed : best;
+			}
+			printf(" %10.1f", (double)best / SCENARIO_TICKS);
+		}
+		printf("\n");
+		
+		if (!update) {
+			rewind(trace);
+			pass &= checkGolden(scenario->name, trace);
+		}
+		fclose(trace);
+	}
+	
+	if (traceName != NULL) {
+		fprintf(stderr, "no scenario '%s', see --list\n", traceName);
+		return 2;
+	}
+	
+	free(frames);
+	pass &= checkGlitchFilter();
+	pass &= checkNvmResume();
+	return pass ? 0 : 1;
+}
+
+/*
+ *	run a scenario from defaults over the rendered inputs, summarizing (and
+ *	optionally writing out) the output changes
+*/
+static void runScenario(const struct Scenario *scenario, const struct HostFrame *frames, FILE *trace, struct TraceSummary *summary) {
+	uint8_t prev = 0;
+	uint8_t outputs;
+	
+	hostCoreInit();
+	scenario->setup();
+	hostCoreSetSeed(SCENARIO_SEED);
+	
+	summary->edges = 0;
+	summary->hash = FNV_OFFSET;
+	
+	for (uint32_t t = 0; t < SCENARIO_TICKS; t++) {
+		outputs = hostCoreTick(&frames[t]);
+		
+		if (outputs != prev) {
+			summary->edges++;
+			summary->hash = hashWord(summary->hash, t);
+			summary->hash = hashWord(summary->hash, outputs);
+			
+			if (trace != NULL) {
+				fprintf(trace, "%u %d%d%d%d\n", t, !!(outputs & HOST_OUT_W), !!(outputs & HOST_OUT_X),
+						!!(outputs & HOST_OUT_Y), !!(outputs & HOST_OUT_Z));
+			}
+			prev = outputs;
+		}
+	}
+}
+
+static uint32_t hashWord(uint32_t hash, uint32_t word) {
+	for (uint8_t i = 0; i < 4; i++) {
+		hash = (hash ^ ((word >> (8 * i)) & 0xFF)) * FNV_PRIME;
+	}
+	return hash;
+}
+
+static FILE *openGolden(const char *name, const char *mode) {
+	char path[256];
+	
+	snprintf(path, sizeof(path), "%s/%s.txt", GOLDEN_DIR, name);
+	return fopen(path, mode);
+}
+
+/*
+ *	compare a scenario's trace line by line with its golden copy, printing
+ *	the lines from where they part ways
+*/
+static bool checkGolden(const char *name, FILE *trace) {
+	FILE *golden = openGolden(name, "r");
+	char want[TRACE_LINE_LEN];
+	char got[TRACE_LINE_LEN];
+	bool haveWant, haveGot;
+	uint32_t line = 0;
+	uint32_t shown = 0;
+	
+	if (golden == NULL) {
+		printf("  no golden trace for %s, run with --update-golden\n", name);
+		return false;
+	}
+	
+	do {
+		haveWant = fgets(want, sizeof(want), golden) != NULL;
+		haveGot = fgets(got, sizeof(got), trace) != NULL;
+		line++;
+		
+		if ((haveWant != haveGot) || (haveWant && strcmp(want, got))) {
+			if (shown == 0) {
+				printf("  %s differs from %s/%s.txt at line %u\n", name, GOLDEN_DIR, name, line);
+			}
+			if (shown++ < GOLDEN_DIFF_LINES) {
+				printf("  - %s", haveWant ? want : "(end)\n");
+				printf("  + %s", haveGot ? got : "(end)\n");
+			}
+		}
+	} while (haveWant || haveGot);
+	
+	if (shown > GOLDEN_DIFF_LINES) {
+		printf("  ... %u more differing lines\n", shown - GOLDEN_DIFF_LINES);
+	}
+	fclose(golden);
+	return shown == 0;
+}
+
+/*
+ *	run input A through channel 1 unfiltered to W & filtered to X, at every
+ *	filter setting. a long pulse measures the filter's delay on both edges,
+ *	and the longest pulse that's still shorter than the width (in whole
+ *	samples) should only show on W. the narrowest settings are under one
+ *	sample, and have no shorter pulse to check
+*/
+static bool checkGlitchFilter(void) {
+	bool pass = true;
+	bool ok;
+	struct FilterEdges edges;
+	uint32_t width, rise, fall, shortTicks;
+	const char *rejected;
+	
+	printf("%-16s %8s %8s %8s %8s\n", "# filter", "width", "rise", "fall", "short");
+	
+	for (int16_t f = inputParams[INPUT_PARAM_FILTER].min; f <= inputParams[INPUT_PARAM_FILTER].max; f++) {
+		width = f * FILTER_WIDTH_COUNTS;
+		shortTicks = (width > 0) ? (width - 1) / SAMPLE_COUNTS : 0;
+		
+		hostCoreInit();
+		beginChannelEdit(&chan[0]);
+		chan[0].input.copyIn1 = true;
+		chan[0].input.input_settings[0].hysteresis = 0;
+		chan[0].input.input_settings[1].hysteresis = 0;
+		chan[0].input.input_settings[1].filter = f;
+		chan[0].op_select[0] = OP_BYP;
+		chan[0].op_select[1] = OP_BYP;
+		endChannelEdit(&chan[0]);
+		runIdle(FILTER_MARGIN_TICKS);
+		
+		runFilterPulse((width / SAMPLE_COUNTS) + FILTER_MARGIN_TICKS, &edges);
+		rise = edges.filteredRise - edges.rise;
+		fall = edges.filteredFall - edges.fall;
+		ok = edges.passed && edges.filtered && filterDelayOk(rise, width) && filterDelayOk(fall, width);
+		
+		rejected = "-";
+		if (shortTicks > 0) {
+			runFilterPulse(shortTicks, &edges);
+			ok &= edges.passed && !edges.filtered;
+			rejected = edges.filtered ? "passed" : "rejected";
+		}
+		
+		printf("%-16d %8u %8u %8u %8s %s\n", f, width, rise, fall, rejected, ok ? "ok" : "FAIL");
+		pass &= ok;
+	}
+	
+	return pass;
+}
+
+/*
+ *	a pulse on input A of the given length in ticks, followed by a gap long
+ *	enough for the filter to let it out
+*/
+static void runFilterPulse(uint32_t ticks, struct FilterEdges *edges) {
+	struct HostFrame frame;
+	uint8_t prev = 0;
+	uint8_t outputs;
+	
+	memset(&frame, 0, sizeof(frame));
+	memset(edges, 0, sizeof(*edges));
+	
+	for (uint32_t t = 0; t < (2 * ticks) + FILTER_MARGIN_TICKS; t++) {
+		frame.in[HOST_IN_A] = (t < ticks) ? FILTER_HIGH : FILTER_LOW;
+		outputs = hostCoreTick(&frame);
+		
+		if ((outputs & HOST_OUT_W) && !(prev & HOST_OUT_W)) {
+			edges->rise = hostTimebaseCount;
+			edges->passed = true;
+		}
+		if (!(outputs & HOST_OUT_W) && (prev & HOST_OUT_W)) {
+			edges->fall = hostTimebaseCount;
+		}
+		if ((outputs & HOST_OUT_X) && !(prev & HOST_OUT_X)) {
+			edges->filteredRise = hostTimebaseCount;
+			edges->filtered = true;
+		}
+		if (!(outputs & HOST_OUT_X) && (prev & HOST_OUT_X)) {
+			edges->filteredFall = hostTimebaseCount;
+		}
+		prev = outputs;
+	}
+}
+
+/*
+ *	the filtered edge lands on the first sample at least the width after the
+ *	last one that didn't match, so within a sample of the width either way
+*/
+static bool filterDelayOk(uint32_t delay, uint32_t width) {
+	return (delay + SAMPLE_COUNTS >= width) && (delay <= width + SAMPLE_COUNTS);
+}
+
+/*
+ *	power cycle the commit engine through the real EEPROM emulator, channel 1
+ *	input A's threshold stands in for any setting
+*/
+static bool checkNvmResume(void) {
+	bool pass = true;
+	uint32_t writes;
+	
+	hostCoreInit();
+	runIdle(NVM_SETTLE_TICKS);
+	pass &= nvmCheck(nvm_cache.pending == 0, "defaults committed");
+	
+	// a settled edit survives the power going
+	editThreshold(1200);
+	runIdle(NVM_SETTLE_TICKS);
+	hostCorePowerLoss(false);
+	hostCoreBoot();
+	pass &= nvmCheck(chan[0].input.input_settings[0].threshold == 1200, "settled edit kept over a power cycle");
+	
+	// one still held off is lost without the BOD interrupt, and the stored
+	// settings are intact
+	editThreshold(2000);
+	runIdle(NVM_EARLY_TICKS);
+	hostCorePowerLoss(false);
+	hostCoreBoot();
+	pass &= nvmCheck(chan[0].input.input_settings[0].threshold == 1200, "held off edit lost without BOD");
+	
+	// with it, the held off edit is written out, along with any other page
+	editThreshold(1600);
+	beginChannelEdit(&chan[1]);
+	chan[1].input.input_settings[0].threshold = -1600;
+	endChannelEdit(&chan[1]);
+	writeChannelNVM(&chan[1], 1);
+	runIdle(NVM_EARLY_TICKS);
+	hostCorePowerLoss(true);
+	hostCoreBoot();
+	pass &= nvmCheck(chan[0].input.input_settings[0].threshold == 1600, "held off edit written out on BOD");
+	pass &= nvmCheck(chan[1].input.input_settings[0].threshold == -1600, "other held off page written out on BOD");
+	
+	editThreshold(1200);
+	runIdle(NVM_SETTLE_TICKS);
+	
+	// editing back to the stored value cancels the commit
+	writes = hostFlashOps.pageWrites;
+	editThreshold(2000);
+	runIdle(NVM_EARLY_TICKS);
+	editThreshold(1200);
+	pass &= nvmCheck(nvm_cache.pending == 0, "edit back clears the pending page");
+	runIdle(NVM_SETTLE_TICKS);
+	pass &= nvmCheck(hostFlashOps.pageWrites == writes, "edit back never reaches the flash");
+	
+	// power going between the page write & its commit: the BOD interrupt
+	// commits the page buffer, without it the stored page is kept
+	editThreshold(2800);
+	while (nvm_cache.state != NVM_COMMIT_PAGE) {
+		runIdle(1);
+	}
+	hostCorePowerLoss(false);
+	hostCoreBoot();
+	pass &= nvmCheck(chan[0].input.input_settings[0].threshold == 1200, "uncommitted page buffer lost without BOD");
+	
+	editThreshold(2800);
+	while (nvm_cache.state != NVM_COMMIT_PAGE) {
+		runIdle(1);
+	}
+	hostCorePowerLoss(true);
+	hostCoreBoot();
+	pass &= nvmCheck(chan[0].input.input_settings[0].threshold == 2800, "page buffer committed on BOD");
+	
+	// enough commits to fill the flash area, so the emulator moves rows
+	for (uint16_t i = 0; i < NVM_CYCLE_EDITS; i++) {
+		editThreshold((i & 1) ? 400 : -400);
+		runIdle(NVM_SETTLE_TICKS);
+	}
+	hostCorePowerLoss(false);
+	hostCoreBoot();
+	pass &= nvmCheck(hostFlashOps.rowErases > 0, "row moves exercised");
+	pass &= nvmCheck(chan[0].input.input_settings[0].threshold == 400, "settings kept over row moves");
+	
+	printf("# commit step worst case: %u page writes, %u row erases (%u/%u over the run)\n",
+			hostCommitWorst.pageWrites, hostCommitWorst.rowErases,
+			hostFlashOps.pageWrites, hostFlashOps.rowErases);
+	return pass;
+}
+
+/*
+ *	tick the core with every input at 0V
+*/
+static void runIdle(uint32_t ticks) {
+	struct HostFrame frame;
+	
+	memset(&frame, 0, sizeof(frame));
+	for (uint32_t t = 0; t < ticks; t++) {
+		hostCoreTick(&frame);
+	}
+}
+
+/*
+ *	edit a setting the way the menu does, packing it into the cache
+*/
+static void editThreshold(int16_t threshold) {
+	beginChannelEdit(&chan[0]);
+	chan[0].input.input_settings[0].threshold = threshold;
+	endChannelEdit(&chan[0]);
+	writeChannelNVM(&chan[0], 0);
+}
+
+static bool nvmCheck(bool pass, const char *what) {
+	printf("%-48s %s\n", what, pass ? "ok" : "FAIL");
+	return pass;
+}
\ No newline at end of file
@@ -0,0 +1,29 @@
+/*
+ *	host stand-in for the ASF compiler & device header, just what the EEPROM
+ *	emulator service needs to build against the flash image in hostFlash.c
+ */ 
+
+
+#ifndef COMPILER_H_
+#define COMPILER_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include "status_codes.h"
+
+#define NVMCTRL_PAGE_SIZE	64		// SAMD21 flash page & row geometry
+#define NVMCTRL_ROW_PAGES	4
+
+// the emulator places itself at the very end of flash, which on the host
+// is the end of the flash image
+extern uint8_t hostFlash[];
+#define FLASH_SIZE			((uintptr_t)hostFlash + HOST_FLASH_SIZE)
+#define HOST_FLASH_SIZE		2048	// emulated EEPROM fuse setting, as on the module
+
+#define COMPILER_PRAGMA(arg)			_Pragma(#arg)
+#define COMPILER_PACK_SET(alignment)	COMPILER_PRAGMA(pack(alignment))
+#define COMPILER_PACK_RESET()			COMPILER_PRAGMA(pack())
+#define barrier()						__asm__ volatile("" ::: "memory")
+
+#endif /* COMPILER_H_ */
\ No newline at end of file
@@ -0,0 +1,22 @@
+/*
+ *	host stand-in for the ASF EEPROM emulator service header. the service
+ *	itself is built from the firmware's ASF tree, over the flash image in
+ *	hostFlash.c
+ */ 
+
+
+#ifndef EEPROM_H_
+#define EEPROM_H_
+
+#include <stdint.h>
+#include "status_codes.h"
+
+#define EEPROM_PAGE_SIZE	60		// NVMCTRL page less the emulator's header
+
+enum status_code eeprom_emulator_init(void);
+void eeprom_emulator_erase_memory(void);
+enum status_code eeprom_emulator_read_page(const uint8_t logical_page, uint8_t *const data);
+enum status_code eeprom_emulator_write_page(const uint8_t logical_page, const uint8_t *const data);
+enum status_code eeprom_emulator_commit_page_buffer(void);
+
+#endif /* EEPROM_H_ */
\ No newline at end of file
@@ -0,0 +1,12 @@
+/*
+ *	host stand-in for the ASF monochrome graphics service, only the string
+ *	type used by the settings structs is needed
+ */ 
+
+
+#ifndef GFX_MONO_H_
+#define GFX_MONO_H_
+
+typedef const char *PROGMEM_STRING_T;
+
+#endif /* GFX_MONO_H_ */
\ No newline at end of file
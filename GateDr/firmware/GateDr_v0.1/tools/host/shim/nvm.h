@@ -0,0 +1,40 @@
+/*
+ *	host stand-in for the ASF NVM controller driver, implemented over the
+ *	flash image in hostFlash.c
+ */ 
+
+
+#ifndef NVM_H_
+#define NVM_H_
+
+#include <compiler.h>
+
+enum nvm_command {
+	NVM_COMMAND_ERASE_ROW,
+	NVM_COMMAND_WRITE_PAGE,
+	NVM_COMMAND_PAGE_BUFFER_CLEAR
+	};
+
+struct nvm_config {
+	bool manual_page_write;
+	};
+
+struct nvm_parameters {
+	uint8_t page_size;
+	uint16_t nvm_number_of_pages;
+	uint32_t eeprom_number_of_pages;
+	uint32_t bootloader_number_of_pages;
+	};
+
+static inline void nvm_get_config_defaults(struct nvm_config *const config) {
+	config->manual_page_write = true;
+}
+
+enum status_code nvm_set_config(const struct nvm_config *const config);
+void nvm_get_parameters(struct nvm_parameters *const parameters);
+enum status_code nvm_write_buffer(const uint32_t destination_address, const uint8_t *buffer, uint16_t length);
+enum status_code nvm_read_buffer(const uint32_t source_address, uint8_t *const buffer, uint16_t length);
+enum status_code nvm_erase_row(const uint32_t row_address);
+enum status_code nvm_execute_command(const enum nvm_command command, const uint32_t address, const uint32_t parameter);
+
+#endif /* NVM_H_ */
\ No newline at end of file
@@ -0,0 +1,13 @@
+/*
+ *	host stand-in for the ASF port driver, nothing in the processing core
+ *	drives pins directly
+ */ 
+
+
+#ifndef PORT_H_
+#define PORT_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#endif /* PORT_H_ */
\ No newline at end of file
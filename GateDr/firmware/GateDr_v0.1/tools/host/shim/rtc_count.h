@@ -0,0 +1,12 @@
+/*
+ *	host stand-in for the ASF RTC count driver, the processing core only
+ *	reads the count through a pointer set up by initChannel()
+ */ 
+
+
+#ifndef RTC_COUNT_H_
+#define RTC_COUNT_H_
+
+#include <stdint.h>
+
+#endif /* RTC_COUNT_H_ */
\ No newline at end of file
@@ -0,0 +1,495 @@
+/*
+ * source file for the render tool's WAV & CSV streams
+ */ 
+
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include "signalFile.h"
+
+#define WAV_HEADER_SIZE		44
+#define WAV_FORMAT_PCM		0x0001
+#define WAV_FORMAT_FLOAT	0x0003
+#define WAV_FORMAT_EXT		0xFFFE
+#define WAV_SIZE_UNKNOWN	0xFFFFFFFFu
+#define CSV_SEPARATORS		",; \t\r\n"
+
+enum WavEncoding {
+	WAV_PCM_U8,
+	WAV_PCM_16,
+	WAV_PCM_24,
+	WAV_PCM_32,
+	WAV_FLOAT_32,
+	WAV_FLOAT_64
+	};
+
+// helper function declaration
+static int readWavHeader(struct SignalReader *reader, const char *path);
+static int readCsvHeader(struct SignalReader *reader, const char *path);
+static int nextWavFrame(struct SignalReader *reader, int16_t *mV);
+static int nextCsvFrame(struct SignalReader *reader, int16_t *mV);
+static bool readCsvLine(struct SignalReader *reader, char *line);
+static bool skipBytes(FILE *file, uint64_t count);
+static int16_t clampInt16(double value);
+static uint16_t getLe16(const uint8_t *bytes);
+static uint32_t getLe32(const uint8_t *bytes);
+static void putLe16(uint8_t *bytes, uint16_t value);
+static void putLe32(uint8_t *bytes, uint32_t value);
+
+/*
+ *	WAV by the .wav extension, CSV for anything else including '-' (stdin/stdout)
+*/
+uint8_t signalFormatForPath(const char *path) {
+	size_t length = strlen(path);
+	
+	if (length > 4 && !strcasecmp(&path[length - 4], ".wav")) {
+		return SIGNAL_WAV;
+	}
+	return SIGNAL_CSV;
+}
+
+/*
+ *	open a recording & read its header, csvRate is the sample rate of CSV
+ *	input, which has no header to carry one. returns 0 when ready to read
+*/
+int signalReaderOpen(struct SignalReader *reader, const char *path, uint32_t csvRate, int32_t fullScale) {
+	memset(reader, 0, sizeof(*reader));
+	reader->format = signalFormatForPath(path);
+	reader->fullScale = fullScale;
+	
+	if (!strcmp(path, "-")) {
+		reader->file = stdin;
+	}
+	else {
+		reader->file = fopen(path, reader->format == SIGNAL_WAV ? "rb" : "r");
+	}
+	if (reader->file == NULL) {
+		fprintf(stderr, "%s: can't open for reading\n", path);
+		return -1;
+	}
+	
+	if (reader->format == SIGNAL_WAV) {
+		return readWavHeader(reader, path);
+	}
+	
+	reader->rate = csvRate;
+	return readCsvHeader(reader, path);
+}
+
+/*
+ *	read the next frame, one value per channel in mV. returns 1 for a frame,
+ *	0 at the end of the recording & -1 on a read error
+*/
+int signalReaderNext(struct SignalReader *reader, int16_t *mV) {
+	if (reader->format == SIGNAL_WAV) {
+		return nextWavFrame(reader, mV);
+	}
+	return nextCsvFrame(reader, mV);
+}
+
+void signalReaderClose(struct SignalReader *reader) {
+	if (reader->file != NULL && reader->file != stdin) {
+		fclose(reader->file);
+	}
+	reader->file = NULL;
+}
+
+/*
+ *	walk the RIFF chunks up to the data chunk, picking up the format on the way.
+ *	other chunks are read past rather than seeked over so pipes work too
+*/
+static int readWavHeader(struct SignalReader *reader, const char *path) {
+	uint8_t header[40];
+	uint32_t chunkSize;
+	uint16_t format;
+	uint16_t bits = 0;
+	bool haveFormat = false;
+	
+	if (fread(header, 1, 12, reader->file) != 12 || memcmp(header, "RIFF", 4) || memcmp(&header[8], "WAVE", 4)) {
+		fprintf(stderr, "%s: not a RIFF WAVE file\n", path);
+		return -1;
+	}
+	
+	while (true) {
+		if (fread(header, 1, 8, reader->file) != 8) {
+			fprintf(stderr, "%s: no data chunk\n", path);
+			return -1;
+		}
+		chunkSize = getLe32(&header[4]);
+		
+		if (!memcmp(header, "data", 4)) {
+			break;
+		}
+		
+		if (!memcmp(header, "fmt ", 4) && chunkSize >= 16 && chunkSize <= sizeof(header)) {
+			if (fread(header, 1, chunkSize, reader->file) != chunkSize) {
+				fprintf(stderr, "%s: truncated format chunk\n", path);
+				return -1;
+			}
+			format = getLe16(&header[0]);
+			reader->channels = getLe16(&header[2]);
+			reader->rate = getLe32(&header[4]);
+			reader->frameSize = getLe16(&header[12]);
+			bits = getLe16(&header[14]);
+			
+			// extensible format, the sub-format GUID starts with the format tag
+			if (format == WAV_FORMAT_EXT && chunkSize >= 26) {
+				format = getLe16(&header[24]);
+			}
+			
+			if (format == WAV_FORMAT_PCM && bits == 8) {
+				reader->encoding = WAV_PCM_U8;
+			}
+			else if (format == WAV_FORMAT_PCM && bits == 16) {
+				reader->encoding = WAV_PCM_16;
+			}
+			else if (format == WAV_FORMAT_PCM && bits == 24) {
+				reader->encoding = WAV_PCM_24;
+			}
+			else if (format == WAV_FORMAT_PCM && bits == 32) {
+				reader->encoding = WAV_PCM_32;
+			}
+			else if (format == WAV_FORMAT_FLOAT && bits == 32) {
+				reader->encoding = WAV_FLOAT_32;
+			}
+			else if (format == WAV_FORMAT_FLOAT && bits == 64) {
+				reader->encoding = WAV_FLOAT_64;
+			}
+			else {
+				fprintf(stderr, "%s: unsupported sample format %u/%u bits\n", path, format, bits);
+				return -1;
+			}
+			haveFormat = true;
+			chunkSize = 0;	// read in full
+		}
+		
+		// chunks are padded to an even size
+		if (!skipBytes(reader->file, chunkSize + (chunkSize & 1))) {
+			fprintf(stderr, "%s: truncated chunk\n", path);
+			return -1;
+		}
+	}
+	
+	if (!haveFormat) {
+		fprintf(stderr, "%s: data before the format chunk\n", path);
+		return -1;
+	}
+	if (reader->channels == 0 || reader->channels > SIGNAL_MAX_CHANNELS || reader->rate == 0
+			|| reader->frameSize != reader->channels * (bits / 8)) {
+		fprintf(stderr, "%s: unsupported layout, %u channels at %uHz\n", path, reader->channels, reader->rate);
+		return -1;
+	}
+	
+	// streaming writers leave the size unset, read to the end of the file
+	reader->dataLeft = (chunkSize == 0 || chunkSize == WAV_SIZE_UNKNOWN) ? UINT64_MAX : chunkSize;
+	return 0;
+}
+
+/*
+ *	the buffer only ever holds whole frames, so a frame never straddles a refill
+*/
+static int nextWavFrame(struct SignalReader *reader, int16_t *mV) {
+	const uint8_t *sample;
+	double value;
+	
+	if (reader->bufferPos >= reader->bufferFill) {
+		uint64_t want = (SIGNAL_BUFFER_SIZE / reader->frameSize) * reader->frameSize;
+		size_t got;
+		
+		if (want > reader->dataLeft) {
+			want = reader->dataLeft - (reader->dataLeft % reader->frameSize);
+		}
+		if (want == 0) {
+			return 0;
+		}
+		
+		got = fread(reader->buffer, 1, want, reader->file);
+		if (ferror(reader->file)) {
+			return -1;
+		}
+		reader->dataLeft -= got;
+		reader->bufferFill = got - (got % reader->frameSize);
+		reader->bufferPos = 0;
+		if (reader->bufferFill == 0) {
+			return 0;
+		}
+	}
+	
+	sample = &reader->buffer[reader->bufferPos];
+	reader->bufferPos += reader->frameSize;
+	
+	for (uint16_t i = 0; i < reader->channels; i++) {
+		switch (reader->encoding) {
+			case WAV_PCM_U8:
+				value = ((int16_t)sample[0] - 128) / 128.0;
+				sample += 1;
+				break;
+			case WAV_PCM_16:
+				value = (int16_t)getLe16(sample) / 32768.0;
+				sample += 2;
+				break;
+			case WAV_PCM_24:
+				value = (int32_t)(((uint32_t)sample[0] << 8) | ((uint32_t)sample[1] << 16) | ((uint32_t)sample[2] << 24)) / 2147483648.0;
+				sample += 3;
+				break;
+			case WAV_PCM_32:
+				value = (int32_t)getLe32(sample) / 2147483648.0;
+				sample += 4;
+				break;
+			case WAV_FLOAT_32: {
+				uint32_t bits = getLe32(sample);
+				float f;
+				
+				memcpy(&f, &bits, sizeof(f));
+				value = f;
+				sample += 4;
+				break;
+			}
+			default: {
+				uint64_t bits = getLe32(sample) | ((uint64_t)getLe32(&sample[4]) << 32);
+				
+				memcpy(&value, &bits, sizeof(value));
+				sample += 8;
+				break;
+			}
+		}
+		mV[i] = clampInt16(value * reader->fullScale);
+	}
+	
+	return 1;
+}
+
+/*
+ *	the first row decides the column count. if anything on it isn't a number
+ *	it's taken as a header row of column names, otherwise it's kept as data
+*/
+static int readCsvHeader(struct SignalReader *reader, const char *path) {
+	char *token;
+	char *end;
+	
+	if (!readCsvLine(reader, reader->pending)) {
+		fprintf(stderr, "%s: no rows\n", path);
+		return -1;
+	}
+	
+	// count & check the columns on a copy, strtok() writes into the line
+	memcpy(reader->buffer, reader->pending, sizeof(reader->pending));
+	for (token = strtok((char *)reader->buffer, CSV_SEPARATORS); token != NULL; token = strtok(NULL, CSV_SEPARATORS)) {
+		if (reader->channels == SIGNAL_MAX_CHANNELS) {
+			fprintf(stderr, "%s: more than %d columns\n", path, SIGNAL_MAX_CHANNELS);
+			return -1;
+		}
+		strtod(token, &end);
+		if (*end != '\0') {
+			reader->named = true;
+		}
+		strncpy(reader->names[reader->channels], token, SIGNAL_NAME_SIZE - 1);
+		reader->channels++;
+	}
+	
+	reader->hasPending = !reader->named;
+	if (!reader->named) {
+		memset(reader->names, 0, sizeof(reader->names));
+	}
+	return 0;
+}
+
+/*
+ *	missing columns on a row read as 0mV, extra ones are ignored
+*/
+static int nextCsvFrame(struct SignalReader *reader, int16_t *mV) {
+	char *token;
+	uint16_t column = 0;
+	
+	if (reader->hasPending) {
+		reader->hasPending = false;
+	}
+	else if (!readCsvLine(reader, reader->pending)) {
+		return ferror(reader->file) ? -1 : 0;
+	}
+	
+	for (token = strtok(reader->pending, CSV_SEPARATORS); token != NULL && column < reader->channels; token = strtok(NULL, CSV_SEPARATORS)) {
+		mV[column++] = clampInt16(strtod(token, NULL));
+	}
+	while (column < reader->channels) {
+		mV[column++] = 0;
+	}
+	
+	return 1;
+}
+
+/*
+ *	next line that isn't blank or a '#' comment, false at the end of the file
+*/
+static bool readCsvLine(struct SignalReader *reader, char *line) {
+	while (fgets(line, SIGNAL_BUFFER_SIZE, reader->file) != NULL) {
+		char *first = line;
+		
+		reader->line++;
+		while (isspace((unsigned char)*first)) {
+			first++;
+		}
+		if (*first != '\0' && *first != '#') {
+			return true;
+		}
+	}
+	return false;
+}
+
+/*
+ *	open a gate output file, WAV output is 16-bit PCM with 'high' mV for a high
+ *	gate. WAV needs a seekable file to fill in the sizes at the end
+*/
+int gateWriterOpen(struct GateWriter *writer, const char *path, uint32_t rate, int32_t high, int32_t fullScale, bool changesOnly) {
+	memset(writer, 0, sizeof(*writer));
+	writer->format = signalFormatForPath(path);
+	writer->changesOnly = changesOnly;
+	writer->rate = rate;
+	writer->high = clampInt16((double)high * 32767.0 / fullScale);
+	
+	if (!strcmp(path, "-")) {
+		writer->file = stdout;
+	}
+	else {
+		writer->file = fopen(path, writer->format == SIGNAL_WAV ? "wb" : "w");
+	}
+	if (writer->file == NULL) {
+		fprintf(stderr, "%s: can't open for writing\n", path);
+		return -1;
+	}
+	
+	if (writer->format == SIGNAL_WAV) {
+		uint8_t header[WAV_HEADER_SIZE] = {0};
+		
+		memcpy(&header[0], "RIFF", 4);
+		memcpy(&header[8], "WAVEfmt ", 8);
+		putLe32(&header[16], 16);
+		putLe16(&header[20], WAV_FORMAT_PCM);
+		putLe16(&header[22], SIGNAL_GATE_COUNT);
+		putLe32(&header[24], rate);
+		putLe32(&header[28], rate * SIGNAL_GATE_COUNT * 2);
+		putLe16(&header[32], SIGNAL_GATE_COUNT * 2);
+		putLe16(&header[34], 16);
+		memcpy(&header[36], "data", 4);
+		
+		// sizes are filled in by gateWriterClose()
+		if (fwrite(header, 1, WAV_HEADER_SIZE, writer->file) != WAV_HEADER_SIZE) {
+			return -1;
+		}
+	}
+	else if (fprintf(writer->file, "tick,W,X,Y,Z\n") < 0) {
+		return -1;
+	}
+	
+	return 0;
+}
+
+/*
+ *	write one tick's gates, SIGNAL_GATE_COUNT bits with W in bit 0
+*/
+int gateWriterPut(struct GateWriter *writer, uint64_t tick, uint8_t gates) {
+	if (writer->format == SIGNAL_WAV) {
+		uint8_t frame[SIGNAL_GATE_COUNT * 2];
+		
+		for (uint8_t i = 0; i < SIGNAL_GATE_COUNT; i++) {
+			putLe16(&frame[i*2], (gates & (1 << i)) ? (uint16_t)writer->high : 0);
+		}
+		if (fwrite(frame, 1, sizeof(frame), writer->file) != sizeof(frame)) {
+			return -1;
+		}
+	}
+	else if (!writer->changesOnly || writer->frames == 0 || gates != writer->last) {
+		if (fprintf(writer->file, "%llu,%d,%d,%d,%d\n", (unsigned long long)tick,
+				gates & 0x01 ? 1 : 0, gates & 0x02 ? 1 : 0, gates & 0x04 ? 1 : 0, gates & 0x08 ? 1 : 0) < 0) {
+			return -1;
+		}
+	}
+	
+	writer->frames++;
+	writer->last = gates;
+	return 0;
+}
+
+/*
+ *	fill in the WAV sizes & close, returns -1 if anything failed to write
+*/
+int gateWriterClose(struct GateWriter *writer) {
+	int result = 0;
+	
+	if (writer->format == SIGNAL_WAV) {
+		uint64_t dataSize = writer->frames * SIGNAL_GATE_COUNT * 2;
+		uint8_t size[4];
+		
+		if (dataSize > WAV_SIZE_UNKNOWN - (WAV_HEADER_SIZE - 8)) {
+			fprintf(stderr, "output is too long for a WAV file, use CSV\n");
+			result = -1;
+		}
+		else {
+			putLe32(size, (uint32_t)dataSize + WAV_HEADER_SIZE - 8);
+			if (fseek(writer->file, 4, SEEK_SET) || fwrite(size, 1, 4, writer->file) != 4) {
+				result = -1;
+			}
+			putLe32(size, (uint32_t)dataSize);
+			if (fseek(writer->file, 40, SEEK_SET) || fwrite(size, 1, 4, writer->file) != 4) {
+				result = -1;
+			}
+		}
+	}
+	
+	if (fflush(writer->file) || ferror(writer->file)) {
+		result = -1;
+	}
+	if (writer->file != stdout) {
+		fclose(writer->file);
+	}
+	writer->file = NULL;
+	
+	return result;
+}
+
+/*
+ *	read & drop 'count' bytes
+*/
+static bool skipBytes(FILE *file, uint64_t count) {
+	uint8_t scratch[256];
+	
+	while (count > 0) {
+		size_t chunk = count > sizeof(scratch) ? sizeof(scratch) : (size_t)count;
+		
+		if (fread(scratch, 1, chunk, file) != chunk) {
+			return false;
+		}
+		count -= chunk;
+	}
+	return true;
+}
+
+static int16_t clampInt16(double value) {
+	if (value >= INT16_MAX) {
+		return INT16_MAX;
+	}
+	if (value <= INT16_MIN) {
+		return INT16_MIN;
+	}
+	return (int16_t)(value < 0 ? value - 0.5 : value + 0.5);
+}
+
+static uint16_t getLe16(const uint8_t *bytes) {
+	return (uint16_t)(bytes[0] | (bytes[1] << 8));
+}
+
+static uint32_t getLe32(const uint8_t *bytes) {
+	return (uint32_t)bytes[0] | ((uint32_t)bytes[1] << 8) | ((uint32_t)bytes[2] << 16) | ((uint32_t)bytes[3] << 24);
+}
+
+static void putLe16(uint8_t *bytes, uint16_t value) {
+	bytes[0] = value & 0xFF;
+	bytes[1] = value >> 8;
+}
+
+static void putLe32(uint8_t *bytes, uint32_t value) {
+	for (uint8_t i = 0; i < 4; i++) {
+		bytes[i] = (value >> (i * 8)) & 0xFF;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,72 @@
+/*
+ *	streaming readers & writers for the render tool: multichannel WAV or CSV
+ *	recordings in, gate outputs out as WAV or CSV. everything goes through a
+ *	fixed size buffer, so file length doesn't matter
+ *
+ *	input CSV is one row per sample in mV, with an optional header row naming
+ *	the columns. WAV input can be 8/16/24/32-bit PCM or 32/64-bit float, full
+ *	scale (+/-1.0) maps to +/-fullScale mV
+ */ 
+
+
+#ifndef SIGNALFILE_H_
+#define SIGNALFILE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#define SIGNAL_MAX_CHANNELS		16
+#define SIGNAL_NAME_SIZE		8
+#define SIGNAL_BUFFER_SIZE		8192
+#define SIGNAL_GATE_COUNT		4
+
+enum SignalFormat {
+	SIGNAL_WAV,
+	SIGNAL_CSV
+	};
+
+struct SignalReader {
+	FILE *file;
+	uint8_t format;
+	uint32_t rate;					// samples per second
+	uint16_t channels;
+	bool named;						// CSV header row present, see names
+	char names[SIGNAL_MAX_CHANNELS][SIGNAL_NAME_SIZE];
+	int32_t fullScale;				// mV at WAV full scale
+	
+	// WAV data chunk
+	uint8_t encoding;				// WavEncoding
+	uint16_t frameSize;				// bytes per frame, all channels
+	uint64_t dataLeft;				// bytes left in the data chunk
+	uint32_t bufferFill;
+	uint32_t bufferPos;
+	uint8_t buffer[SIGNAL_BUFFER_SIZE];
+	
+	// CSV
+	char pending[SIGNAL_BUFFER_SIZE];	// first data row, read while checking for a header
+	bool hasPending;
+	uint32_t line;
+	};
+
+struct GateWriter {
+	FILE *file;
+	uint8_t format;
+	bool changesOnly;				// CSV: only rows where an output changed
+	int16_t high;					// WAV sample value for a high gate
+	uint32_t rate;
+	uint64_t frames;
+	uint8_t last;
+	};
+
+int signalReaderOpen(struct SignalReader *reader, const char *path, uint32_t csvRate, int32_t fullScale);
+int signalReaderNext(struct SignalReader *reader, int16_t *mV);
+void signalReaderClose(struct SignalReader *reader);
+
+int gateWriterOpen(struct GateWriter *writer, const char *path, uint32_t rate, int32_t high, int32_t fullScale, bool changesOnly);
+int gateWriterPut(struct GateWriter *writer, uint64_t tick, uint8_t gates);
+int gateWriterClose(struct GateWriter *writer);
+
+uint8_t signalFormatForPath(const char *path);
+
+#endif /* SIGNALFILE_H_ */
\ No newline at end of file
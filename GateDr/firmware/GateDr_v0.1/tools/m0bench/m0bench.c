@@ -0,0 +1,111 @@
+/*
+ * Cortex-M0 benchmark image of the processing core, runs the bench
+ * configuration matrix under QEMU & prints instructions per processChannel()
+ * call as CSV over semihosting
+ *
+ * QEMU doesn't model the M0+ pipeline or the flash wait states. with -icount
+ * every instruction advances the virtual clock by 2^ICOUNT_SHIFT ns, so the
+ * SysTick running off the board's clock counts instructions, & cycles are
+ * estimated from them with CPI_X100. calibrate that against the hardware
+ * before trusting the absolute figures; for comparing two builds the
+ * instruction counts are what matter
+ */ 
+
+#include <stdio.h>
+#include "benchConfigs.h"
+
+#ifndef BENCH_TICKS
+#define BENCH_TICKS			(2 * HOST_TICK_RATE)
+#endif
+#define BENCH_BLOCK			64		// ticks rendered ahead of each timed block
+
+// passed in by the Makefile, must match the qemu command line
+#ifndef QEMU_SYSCLK_HZ
+#define QEMU_SYSCLK_HZ		16000000
+#endif
+#ifndef ICOUNT_SHIFT
+#define ICOUNT_SHIFT		6
+#endif
+// estimated cycles per instruction x100 on the SAMD21 at 48MHz (1 flash wait state)
+#ifndef CPI_X100
+#define CPI_X100			140
+#endif
+#define TARGET_CLOCK_MHZ	48
+
+// SysTick, common to every ARMv6-M core
+#define SYST_CSR			(*(volatile uint32_t *)0xE000E010)
+#define SYST_RVR			(*(volatile uint32_t *)0xE000E014)
+#define SYST_CVR			(*(volatile uint32_t *)0xE000E018)
+#define SYST_MASK			0x00FFFFFFUL
+
+// helper function declaration
+static uint32_t timeBlock(const struct HostFrame *block, uint32_t count);
+static uint64_t countsToInsnsX10(uint64_t counts);
+
+static struct HostFrame frames[BENCH_BLOCK];
+static volatile uint8_t sink;
+static uint32_t timerOverhead;
+
+/*
+ *	run every configuration for BENCH_TICKS ticks, only the hostCoreTick()
+ *	calls are timed, the input rendering between blocks isn't
+*/
+int main(void) {
+	SYST_RVR = SYST_MASK;
+	SYST_CVR = 0;
+	SYST_CSR = 0x5;		// enable, processor clock, no interrupt
+	
+	// cost of the timing itself, taken off every block
+	timerOverhead = timeBlock(frames, 0);
+	
+	printf("config,ticks,insns_per_call,est_cycles_per_call,est_ns_per_call\n");
+	
+	for (uint8_t c = 0; c < BENCH_CONFIG_COUNT; c++) {
+		uint64_t counts = 0;
+		uint64_t insnsX10;
+		uint64_t cyclesX10;
+		
+		benchStart(c);
+		for (uint32_t first = 0; first < BENCH_TICKS; first += BENCH_BLOCK) {
+			uint32_t count = BENCH_TICKS - first < BENCH_BLOCK ? BENCH_TICKS - first : BENCH_BLOCK;
+			
+			benchRenderInputs(frames, first, count);
+			counts += timeBlock(frames, count);
+		}
+		
+		// per processChannel() call, two per tick
+		insnsX10 = countsToInsnsX10(counts) / (2 * BENCH_TICKS);
+		cyclesX10 = insnsX10 * CPI_X100 / 100;
+		
+		printf("%s,%lu,%lu.%lu,%lu.%lu,%lu\n", benchConfigs[c].name, (unsigned long)BENCH_TICKS,
+				(unsigned long)(insnsX10 / 10), (unsigned long)(insnsX10 % 10),
+				(unsigned long)(cyclesX10 / 10), (unsigned long)(cyclesX10 % 10),
+				(unsigned long)(cyclesX10 * 100 / TARGET_CLOCK_MHZ));
+	}
+	
+	return 0;
+}
+
+/*
+ *	SysTick counts down from RVR, a block has to stay under 2^24 counts
+*/
+static uint32_t timeBlock(const struct HostFrame *block, uint32_t count) {
+	uint32_t start;
+	uint32_t elapsed;
+	
+	start = SYST_CVR;
+	for (uint32_t i = 0; i < count; i++) {
+		sink ^= hostCoreTick(&block[i]);
+	}
+	elapsed = (start - SYST_CVR) & SYST_MASK;
+	
+	return elapsed > timerOverhead ? elapsed - timerOverhead : 0;
+}
+
+/*
+ *	one SysTick count is 1e9 / QEMU_SYSCLK_HZ ns of virtual time, one
+ *	instruction is 2^ICOUNT_SHIFT ns
+*/
+static uint64_t countsToInsnsX10(uint64_t counts) {
+	return counts * 10000000000ULL / ((uint64_t)QEMU_SYSCLK_HZ << ICOUNT_SHIFT);
+}
\ No newline at end of file
@@ -0,0 +1,51 @@
+/*
+ * vector table & reset handler for the benchmark image
+ */ 
+
+#include <stdint.h>
+#include <stdlib.h>
+
+extern uint32_t _etext, _sdata, _edata, _sbss, _ebss, _estack;
+
+int main(void);
+void initialise_monitor_handles(void);
+
+void Reset_Handler(void);
+void Default_Handler(void);
+
+__attribute__((section(".vectors"), used))
+static void (*const vectors[16])(void) = {
+	(void (*)(void))&_estack,
+	Reset_Handler,
+	Default_Handler,	// NMI
+	Default_Handler,	// HardFault
+	[11] = Default_Handler,	// SVCall
+	[14] = Default_Handler,	// PendSV
+	[15] = Default_Handler	// SysTick
+	};
+
+/*
+ *	copy .data (& the RAM functions with it), clear .bss, then run the benchmark
+ *	& hand its exit code back to QEMU over semihosting
+*/
+void Reset_Handler(void) {
+	uint32_t *src = &_etext;
+	uint32_t *dest;
+	
+	for (dest = &_sdata; dest < &_edata; dest++) {
+		*dest = *src++;
+	}
+	for (dest = &_sbss; dest < &_ebss; dest++) {
+		*dest = 0;
+	}
+	
+	initialise_monitor_handles();
+	exit(main());
+}
+
+/*
+ *	faults end up here, QEMU can be stopped with ctrl-a x
+*/
+void Default_Handler(void) {
+	while (1);
+}
\ No newline at end of file
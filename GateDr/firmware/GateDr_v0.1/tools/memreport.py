@@ -0,0 +1,164 @@
+#!/usr/bin/env python3
+"""
+per-symbol flash & RAM report for a linked firmware image, plus totals
+against the part's budget (SAMD21E17A: 128KB flash less the 8KB bootloader,
+16KB RAM)
+
+symbols in SRAM that are loaded from flash (.relocate: initialized data and
+HOT_FUNC/HOT_CONST code) count against both. the report fails if either
+total is over budget. the CSV is sorted by name so
+two reports diff cleanly, and --compare prints the per-symbol change against
+an earlier CSV
+
+--forbid fails the report if any of the listed symbols made it into the
+image, for library code that's been designed out and should stay out
+
+usage: memreport.py image.elf [--nm arm-none-eabi-nm] [--size arm-none-eabi-size]
+                    [--csv out.csv] [--compare old.csv] [--top N]
+                    [--forbid sym1,sym2,...]
+"""
+
+import argparse
+import csv
+import subprocess
+import sys
+
+FLASH_BUDGET = 0x20000 - 0x2000
+RAM_BUDGET = 0x4000
+RAM_BASE = 0x20000000
+
+FLASH_SECTIONS = (".text", ".ARM.exidx", ".relocate")
+RAM_SECTIONS = (".relocate", ".bss", ".stack")
+
+
+def read_sections(size_tool, elf):
+    sections = {}
+    out = subprocess.run([size_tool, "-A", elf], check=True, capture_output=True, text=True).stdout
+
+    for line in out.splitlines():
+        fields = line.split()
+        if len(fields) == 3 and fields[0].startswith(".") and fields[1].isdigit():
+            sections[fields[0]] = int(fields[1])
+
+    return sections
+
+
+def read_symbols(nm_tool, elf):
+    symbols = {}
+    out = subprocess.run([nm_tool, "-S", "--size-sort", elf], check=True,
+                         capture_output=True, text=True).stdout
+
+    for line in out.splitlines():
+        fields = line.split()
+        if len(fields) != 4:
+            continue
+
+        addr, size, kind, name = int(fields[0], 16), int(fields[1], 16), fields[2], fields[3]
+        flash, ram = size, 0
+
+        if addr >= RAM_BASE:
+            ram = size
+            # zero-initialized & uninitialized symbols take no space in the image
+            flash = 0 if kind in "bB" else size
+
+        # local symbols can repeat across files, keep them apart
+        if name in symbols:
+            name = "%s@%x" % (name, addr)
+        symbols[name] = (kind, flash, ram)
+
+    return symbols
+
+
+def read_csv(path):
+    symbols = {}
+
+    with open(path, newline="") as f:
+        for row in csv.DictReader(f):
+            symbols[row["name"]] = (row["type"], int(row["flash"]), int(row["ram"]))
+
+    return symbols
+
+
+def write_csv(path, symbols):
+    with open(path, "w", newline="") as f:
+        writer = csv.writer(f, lineterminator="\n")
+        writer.writerow(["name", "type", "flash", "ram"])
+        for name in sorted(symbols):
+            kind, flash, ram = symbols[name]
+            writer.writerow([name, kind, flash, ram])
+
+
+def print_budget(name, used, budget, parts):
+    detail = ", ".join("%s %d" % part for part in parts)
+    print("  %-6s %7d / %6d bytes (%5.1f%%)  [%s]" % (name, used, budget, 100.0 * used / budget, detail))
+
+
+def print_compare(old, new):
+    rows = []
+
+    for name in set(old) | set(new):
+        old_flash, old_ram = old.get(name, ("", 0, 0))[1:]
+        new_flash, new_ram = new.get(name, ("", 0, 0))[1:]
+        if (old_flash, old_ram) != (new_flash, new_ram):
+            rows.append((new_flash - old_flash, new_ram - old_ram, name))
+
+    rows.sort(key=lambda r: (-abs(r[0]) - abs(r[1]), r[2]))
+
+    print("\nchanges since baseline (flash, ram, name)")
+    for flash, ram, name in rows:
+        print("  %+7d %+7d  %s" % (flash, ram, name))
+    print("  %+7d %+7d  total" % (sum(r[0] for r in rows), sum(r[1] for r in rows)))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="per-symbol flash & RAM report")
+    parser.add_argument("elf")
+    parser.add_argument("--nm", default="arm-none-eabi-nm")
+    parser.add_argument("--size", default="arm-none-eabi-size")
+    parser.add_argument("--csv", help="write every symbol, sorted by name")
+    parser.add_argument("--compare", help="earlier CSV to diff against")
+    parser.add_argument("--top", type=int, default=30, help="largest symbols to list")
+    parser.add_argument("--forbid", default="", help="comma separated symbols that mustn't be linked")
+    args = parser.parse_args()
+
+    sections = read_sections(args.size, args.elf)
+    symbols = read_symbols(args.nm, args.elf)
+
+    flash_parts = [(s, sections[s]) for s in FLASH_SECTIONS if s in sections]
+    ram_parts = [(s, sections[s]) for s in RAM_SECTIONS if s in sections]
+
+    flash_used = sum(p[1] for p in flash_parts)
+    ram_used = sum(p[1] for p in ram_parts)
+
+    print("memory budget (%s)" % args.elf)
+    print_budget("flash", flash_used, FLASH_BUDGET, flash_parts)
+    print_budget("ram", ram_used, RAM_BUDGET, ram_parts)
+
+    print("\nlargest symbols (flash, ram, type, name)")
+    largest = sorted(symbols.items(), key=lambda s: (-max(s[1][1], s[1][2]), s[0]))
+    for name, (kind, flash, ram) in largest[:args.top]:
+        print("  %7d %7d  %s  %s" % (flash, ram, kind, name))
+
+    if args.csv:
+        write_csv(args.csv, symbols)
+
+    if args.compare:
+        print_compare(read_csv(args.compare), symbols)
+
+    failed = False
+
+    if flash_used > FLASH_BUDGET or ram_used > RAM_BUDGET:
+        print("\nover budget: flash %+d, ram %+d bytes" % (flash_used - FLASH_BUDGET, ram_used - RAM_BUDGET),
+              file=sys.stderr)
+        failed = True
+
+    linked = sorted(name for name in args.forbid.split(",") if name and name in symbols)
+    if linked:
+        print("\nforbidden symbols linked: %s" % ", ".join(linked), file=sys.stderr)
+        failed = True
+
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,56 @@
+#!/usr/bin/env python3
+"""
+convert a raw firmware binary to UF2 for drag-and-drop flashing through the
+module's bootloader, in the same layout as the released images (256 byte
+payloads, no family ID, application at 0x2000 after the bootloader)
+
+usage: uf2conv.py input.bin output.uf2 [--base 0x2000]
+"""
+
+import argparse
+import struct
+
+UF2_MAGIC_START0 = 0x0A324655
+UF2_MAGIC_START1 = 0x9E5D5157
+UF2_MAGIC_END = 0x0AB16F30
+UF2_BLOCK_SIZE = 512
+UF2_PAYLOAD_SIZE = 256
+APP_BASE_DEFAULT = 0x2000
+
+
+def convert(data, base):
+    # pad to a whole number of payloads, erased flash reads back as 0xFF
+    if len(data) % UF2_PAYLOAD_SIZE:
+        data += b"\xff" * (UF2_PAYLOAD_SIZE - len(data) % UF2_PAYLOAD_SIZE)
+
+    count = len(data) // UF2_PAYLOAD_SIZE
+    blocks = []
+
+    for i in range(count):
+        payload = data[i * UF2_PAYLOAD_SIZE:(i + 1) * UF2_PAYLOAD_SIZE]
+        header = struct.pack("<8I", UF2_MAGIC_START0, UF2_MAGIC_START1, 0,
+                             base + i * UF2_PAYLOAD_SIZE, UF2_PAYLOAD_SIZE,
+                             i, count, 0)
+        padding = b"\x00" * (UF2_BLOCK_SIZE - len(header) - len(payload) - 4)
+        blocks.append(header + payload + padding + struct.pack("<I", UF2_MAGIC_END))
+
+    return b"".join(blocks)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="convert a .bin image to .uf2")
+    parser.add_argument("input")
+    parser.add_argument("output")
+    parser.add_argument("--base", type=lambda x: int(x, 0), default=APP_BASE_DEFAULT,
+                        help="flash address of the image (default 0x2000)")
+    args = parser.parse_args()
+
+    with open(args.input, "rb") as f:
+        data = f.read()
+
+    with open(args.output, "wb") as f:
+        f.write(convert(data, args.base))
+
+
+if __name__ == "__main__":
+    main()